@@ -1,30 +1,25 @@
 #include "bsp_time.h"
 
-#include <sys/time.h>
+#include <time.h>
 
-static struct timeval start_time;
+/* 使用单调时钟，不受NTP和系统时间调整影响 */
+static struct timespec start_time;
 
-void bsp_time_init() { gettimeofday(&start_time, NULL); }
+void bsp_time_init() { clock_gettime(CLOCK_MONOTONIC, &start_time); }
 
-uint32_t bsp_time_get_ms() {
-  struct timeval tv;
-  gettimeofday(&tv, NULL);
-  return ((tv.tv_sec - start_time.tv_sec) * 1000 +
-          (tv.tv_usec - start_time.tv_usec) / 1000) %
-         UINT32_MAX;
+uint64_t bsp_time_get_ns() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)(ts.tv_sec - start_time.tv_sec) * 1000000000ULL +
+         (uint64_t)ts.tv_nsec - (uint64_t)start_time.tv_nsec;
 }
 
-uint32_t bsp_time_get_us() {
-  struct timeval tv;
-  gettimeofday(&tv, NULL);
-  return ((tv.tv_sec - start_time.tv_sec) * 1000000 +
-          (tv.tv_usec - start_time.tv_usec)) %
-         UINT32_MAX;
-}
+uint32_t bsp_time_get_ms() { return (uint32_t)(bsp_time_get_ns() / 1000000); }
 
-float bsp_time_get() {
-  struct timeval tv;
-  gettimeofday(&tv, NULL);
-  return (tv.tv_sec - start_time.tv_sec) +
-         ((float)(tv.tv_usec - start_time.tv_usec) / 1000000.0f);
-}
+uint32_t bsp_time_get_us() { return (uint32_t)(bsp_time_get_ns() / 1000); }
+
+float bsp_time_get() { return (float)((double)bsp_time_get_ns() / 1e9); }
+
+uint32_t bsp_time_get_cycle() { return (uint32_t)bsp_time_get_ns(); }
+
+uint32_t bsp_time_get_cycle_freq() { return 1000000000; }
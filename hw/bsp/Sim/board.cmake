@@ -0,0 +1,21 @@
+cmake_minimum_required(VERSION 3.11)
+
+add_subdirectory(${BOARD_DIR}/drivers)
+
+add_executable(${PROJECT_NAME}.elf ${BOARD_DIR}/main.cpp)
+
+target_link_libraries(
+  ${PROJECT_NAME}.elf
+  PUBLIC bsp
+  PUBLIC system
+  PUBLIC robot
+  )
+
+
+target_include_directories(
+  ${PROJECT_NAME}.elf
+  PUBLIC ${CMAKE_CURRENT_SOURCE_DIR}
+  PRIVATE $<TARGET_PROPERTY:bsp,INTERFACE_INCLUDE_DIRECTORIES>
+  PRIVATE $<TARGET_PROPERTY:system,INTERFACE_INCLUDE_DIRECTORIES>
+  PRIVATE $<TARGET_PROPERTY:robot,INTERFACE_INCLUDE_DIRECTORIES>
+  )
@@ -0,0 +1,5 @@
+#include "bsp.h"
+
+#include "bsp_time.h"
+
+void bsp_init() { bsp_time_init(); }
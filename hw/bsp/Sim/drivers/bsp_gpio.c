@@ -0,0 +1,16 @@
+#include "bsp_gpio.h"
+
+/* 只记录引脚状态，供测试读取 */
+static bool gpio_state[BSP_GPIO_NUM];
+
+int8_t bsp_gpio_write_pin(bsp_gpio_t gpio, bool value) {
+  if (gpio >= BSP_GPIO_NUM) {
+    return BSP_ERR;
+  }
+
+  gpio_state[gpio] = value;
+
+  return BSP_OK;
+}
+
+bool bsp_gpio_read_pin(bsp_gpio_t gpio) { return gpio_state[gpio]; }
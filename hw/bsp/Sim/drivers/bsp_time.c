@@ -0,0 +1,28 @@
+#include "bsp_time.h"
+
+#include "sim_plant.h"
+
+/* 虚拟时钟，单位为微秒，与主机时间无关 */
+static uint64_t sim_time_us;
+
+void bsp_time_init() { sim_time_us = 0; }
+
+void bsp_time_advance_to(uint64_t us) {
+  if (us > sim_time_us) {
+    /* 被控对象与虚拟时钟同步推进 */
+    sim_plant_step((double)(us - sim_time_us) / 1e6);
+    sim_time_us = us;
+  }
+}
+
+uint64_t bsp_time_get_ns() { return sim_time_us * 1000; }
+
+uint32_t bsp_time_get_ms() { return (uint32_t)(sim_time_us / 1000); }
+
+uint32_t bsp_time_get_us() { return (uint32_t)sim_time_us; }
+
+float bsp_time_get() { return (float)((double)sim_time_us / 1e6); }
+
+uint32_t bsp_time_get_cycle() { return (uint32_t)bsp_time_get_ns(); }
+
+uint32_t bsp_time_get_cycle_freq() { return 1000000000; }
@@ -0,0 +1,30 @@
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "bsp.h"
+
+uint32_t bsp_time_get_ms();
+
+uint32_t bsp_time_get_us();
+
+uint64_t bsp_time_get_ns();
+
+float bsp_time_get();
+
+/* 高精度计数器，用于测量短时间间隔，溢出后回绕 */
+uint32_t bsp_time_get_cycle();
+
+/* 计数器频率(Hz) */
+uint32_t bsp_time_get_cycle_freq();
+
+void bsp_time_init();
+
+/* 由调度器在所有线程阻塞时调用，时间只会向前推进 */
+void bsp_time_advance_to(uint64_t us);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,156 @@
+#include "sim_plant.h"
+
+#include <webots/accelerometer.h>
+#include <webots/camera.h>
+#include <webots/gyro.h>
+#include <webots/inertial_unit.h>
+#include <webots/keyboard.h>
+#include <webots/motor.h>
+#include <webots/position_sensor.h>
+#include <webots/robot.h>
+
+#define SIM_MOTOR_INERTIA (0.005) /* 转动惯量，单位为kg*m^2 */
+#define SIM_MOTOR_DAMPING (0.02)  /* 粘滞阻尼，单位为N*m*s/rad */
+#define SIM_GRAVITY (9.81)
+
+#define SIM_SENSOR_SUFFIX "_Sensor"
+#define SIM_NAME_MAX_LEN (31)
+
+/* 电机为带粘滞阻尼的惯性负载，传感器指向对应的电机 */
+typedef struct {
+  char name[SIM_NAME_MAX_LEN + 1];
+  WbDeviceTag motor;
+  double torque;
+  double speed;
+  double position;
+} sim_device_t;
+
+/* 0号设备保留为无效设备 */
+static sim_device_t device[SIM_PLANT_DEVICE_NUM];
+static WbDeviceTag device_num = 1;
+
+/* 车体静止且水平，IMU只输出重力 */
+static double imu_rpy[3];
+static double imu_gyro[3];
+static double imu_accl[3] = {0.0, 0.0, SIM_GRAVITY};
+
+static WbDeviceTag find_device(const char *name, size_t len) {
+  for (WbDeviceTag i = 1; i < device_num; i++) {
+    if (strlen(device[i].name) == len &&
+        strncmp(device[i].name, name, len) == 0) {
+      return i;
+    }
+  }
+
+  if (device_num >= SIM_PLANT_DEVICE_NUM || len > SIM_NAME_MAX_LEN) {
+    return 0;
+  }
+
+  WbDeviceTag tag = device_num++;
+  memcpy(device[tag].name, name, len);
+  device[tag].name[len] = '\0';
+  device[tag].motor = tag;
+
+  return tag;
+}
+
+WbDeviceTag wb_robot_get_device(const char *name) {
+  size_t len = strlen(name);
+  size_t suffix_len = strlen(SIM_SENSOR_SUFFIX);
+
+  WbDeviceTag tag = find_device(name, len);
+
+  if (tag != 0 && len > suffix_len &&
+      strcmp(name + len - suffix_len, SIM_SENSOR_SUFFIX) == 0) {
+    device[tag].motor = find_device(name, len - suffix_len);
+  }
+
+  return tag;
+}
+
+void sim_plant_step(double dt) {
+  /* 力矩在两次推进之间保持不变，使用解析解，步长任意大都稳定 */
+  const double TAU = SIM_MOTOR_INERTIA / SIM_MOTOR_DAMPING;
+  double decay = exp(-dt / TAU);
+
+  for (WbDeviceTag i = 1; i < device_num; i++) {
+    sim_device_t *motor = &device[i];
+    if (motor->motor != i) {
+      continue;
+    }
+
+    double final_speed = motor->torque / SIM_MOTOR_DAMPING;
+    double delta = motor->speed - final_speed;
+
+    motor->position += final_speed * dt + delta * TAU * (1.0 - decay);
+    motor->speed = final_speed + delta * decay;
+  }
+}
+
+void wb_motor_set_position(WbDeviceTag tag, double position) {
+  (void)(tag);
+  (void)(position);
+}
+
+void wb_motor_set_velocity(WbDeviceTag tag, double velocity) {
+  (void)(tag);
+  (void)(velocity);
+}
+
+void wb_motor_set_torque(WbDeviceTag tag, double torque) {
+  device[tag].torque = torque;
+}
+
+double wb_motor_get_torque_feedback(WbDeviceTag tag) {
+  return device[tag].torque;
+}
+
+void wb_position_sensor_enable(WbDeviceTag tag, int sampling_period) {
+  (void)(tag);
+  (void)(sampling_period);
+}
+
+double wb_position_sensor_get_value(WbDeviceTag tag) {
+  return device[device[tag].motor].position;
+}
+
+void wb_inertial_unit_enable(WbDeviceTag tag, int sampling_period) {
+  (void)(tag);
+  (void)(sampling_period);
+}
+
+const double *wb_inertial_unit_get_roll_pitch_yaw(WbDeviceTag tag) {
+  (void)(tag);
+  return imu_rpy;
+}
+
+void wb_gyro_enable(WbDeviceTag tag, int sampling_period) {
+  (void)(tag);
+  (void)(sampling_period);
+}
+
+const double *wb_gyro_get_values(WbDeviceTag tag) {
+  (void)(tag);
+  return imu_gyro;
+}
+
+void wb_accelerometer_enable(WbDeviceTag tag, int sampling_period) {
+  (void)(tag);
+  (void)(sampling_period);
+}
+
+const double *wb_accelerometer_get_values(WbDeviceTag tag) {
+  (void)(tag);
+  return imu_accl;
+}
+
+void wb_camera_enable(WbDeviceTag tag, int sampling_period) {
+  (void)(tag);
+  (void)(sampling_period);
+}
+
+void wb_keyboard_enable(int sampling_period) { (void)(sampling_period); }
+
+void wb_keyboard_disable(void) {}
+
+int wb_keyboard_get_key(void) { return -1; }
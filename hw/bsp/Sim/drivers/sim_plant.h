@@ -0,0 +1,16 @@
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "bsp.h"
+
+#define SIM_PLANT_DEVICE_NUM (32) /* 设备数量上限 */
+
+/* 由bsp_time_advance_to调用，把被控对象推进dt秒 */
+void sim_plant_step(double dt);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,14 @@
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <webots/types.h>
+
+/* 不产生图像 */
+void wb_camera_enable(WbDeviceTag tag, int sampling_period);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,15 @@
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <webots/types.h>
+
+void wb_gyro_enable(WbDeviceTag tag, int sampling_period);
+
+const double *wb_gyro_get_values(WbDeviceTag tag);
+
+#ifdef __cplusplus
+}
+#endif
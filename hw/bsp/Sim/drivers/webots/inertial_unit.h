@@ -0,0 +1,15 @@
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <webots/types.h>
+
+void wb_inertial_unit_enable(WbDeviceTag tag, int sampling_period);
+
+const double *wb_inertial_unit_get_roll_pitch_yaw(WbDeviceTag tag);
+
+#ifdef __cplusplus
+}
+#endif
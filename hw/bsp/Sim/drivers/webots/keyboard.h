@@ -0,0 +1,16 @@
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* 没有键盘输入，wb_keyboard_get_key总是返回-1 */
+void wb_keyboard_enable(int sampling_period);
+
+void wb_keyboard_disable(void);
+
+int wb_keyboard_get_key(void);
+
+#ifdef __cplusplus
+}
+#endif
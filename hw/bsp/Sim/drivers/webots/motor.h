@@ -0,0 +1,20 @@
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <webots/types.h>
+
+/* 只支持力矩控制，位置和速度设置被忽略 */
+void wb_motor_set_position(WbDeviceTag tag, double position);
+
+void wb_motor_set_velocity(WbDeviceTag tag, double velocity);
+
+void wb_motor_set_torque(WbDeviceTag tag, double torque);
+
+double wb_motor_get_torque_feedback(WbDeviceTag tag);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,16 @@
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <webots/types.h>
+
+/* 名为"<电机名>_Sensor"的传感器返回该电机的转角 */
+void wb_position_sensor_enable(WbDeviceTag tag, int sampling_period);
+
+double wb_position_sensor_get_value(WbDeviceTag tag);
+
+#ifdef __cplusplus
+}
+#endif
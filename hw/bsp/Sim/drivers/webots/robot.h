@@ -0,0 +1,14 @@
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <webots/types.h>
+
+/* 第一次使用时创建设备，0表示设备数量已达上限 */
+WbDeviceTag wb_robot_get_device(const char *name);
+
+#ifdef __cplusplus
+}
+#endif
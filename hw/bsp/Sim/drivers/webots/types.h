@@ -0,0 +1,4 @@
+#pragma once
+
+/* 无界面仿真使用的Webots接口子集，由sim_plant.c实现 */
+typedef unsigned short WbDeviceTag;
@@ -0,0 +1,23 @@
+#include <cstdio>
+#include <cstdlib>
+#include <thread.hpp>
+
+#include "bsp.h"
+#include "bsp_time.h"
+#include "robot.hpp"
+
+int main() {
+  bsp_init();
+  robot_init();
+
+  /* main线程也由调度器管理，只能通过Sleep阻塞 */
+  if (SIM_RUN_TIME > 0) {
+    System::Thread::Sleep(SIM_RUN_TIME * 1000);
+    printf("Simulation finished at %.3fs.\r\n", bsp_time_get());
+    exit(0);
+  }
+
+  while (1) {
+    System::Thread::Sleep(UINT32_MAX);
+  }
+}
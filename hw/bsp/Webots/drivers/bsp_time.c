@@ -7,3 +7,7 @@ uint32_t bsp_time_get_ms() { return wb_robot_get_time() * 1000; }
 uint32_t bsp_time_get_us() { return wb_robot_get_time() * 1000000; }
 
 float bsp_time_get() { return wb_robot_get_time(); }
+
+uint32_t bsp_time_get_cycle() { return bsp_time_get_us(); }
+
+uint32_t bsp_time_get_cycle_freq() { return 1000000; }
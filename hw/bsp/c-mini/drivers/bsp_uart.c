@@ -227,6 +227,19 @@ int8_t bsp_uart_receive(bsp_uart_t uart, uint8_t *buff, size_t size,
   }
 }
 
+int8_t bsp_uart_receive_circular(bsp_uart_t uart, uint8_t *buff,
+                                 size_t size) {
+  UART_HandleTypeDef *huart = bsp_uart_get_handle(uart);
+
+  /* 写到末尾后自动回到开头，写入位置由bsp_uart_get_count获得 */
+  huart->hdmarx->Init.Mode = DMA_CIRCULAR;
+  if (HAL_DMA_Init(huart->hdmarx) != HAL_OK) {
+    return BSP_ERR;
+  }
+
+  return HAL_UART_Receive_DMA(huart, buff, size) != HAL_OK;
+}
+
 uint32_t bsp_uart_get_count(bsp_uart_t uart) {
   return bsp_uart_get_handle(uart)->RxXferSize -
          __HAL_DMA_GET_COUNTER(bsp_uart_get_handle(uart)->hdmarx);
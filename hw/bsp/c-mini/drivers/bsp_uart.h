@@ -47,6 +47,8 @@ int8_t bsp_uart_transmit(bsp_uart_t uart, uint8_t *data, size_t size,
                          bool block);
 int8_t bsp_uart_receive(bsp_uart_t uart, uint8_t *buff, size_t size,
                         bool block);
+int8_t bsp_uart_receive_circular(bsp_uart_t uart, uint8_t *buff,
+                                 size_t size);
 
 #ifdef __cplusplus
 }
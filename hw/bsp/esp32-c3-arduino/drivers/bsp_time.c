@@ -7,3 +7,7 @@ uint32_t bsp_time_get_ms() { return esp_timer_get_time() / 1000; }
 uint32_t bsp_time_get_us() { return esp_timer_get_time(); }
 
 float bsp_time_get() { return (float)esp_timer_get_time() / 1000000.0f; }
+
+uint32_t bsp_time_get_cycle() { return bsp_time_get_us(); }
+
+uint32_t bsp_time_get_cycle_freq() { return 1000000; }
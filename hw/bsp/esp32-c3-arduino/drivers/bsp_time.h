@@ -12,6 +12,12 @@ uint32_t bsp_time_get_us();
 
 float bsp_time_get();
 
+/* 高精度计数器，用于测量短时间间隔，溢出后回绕 */
+uint32_t bsp_time_get_cycle();
+
+/* 计数器频率(Hz) */
+uint32_t bsp_time_get_cycle_freq();
+
 #ifdef __cplusplus
 }
 #endif
@@ -1,6 +1,6 @@
 cmake_minimum_required(VERSION 3.11)
 
-add_compile_definitions(BOARD_F103_CAN STM32F103xB)
+add_compile_definitions(BOARD_F103_CAN STM32F103xB USE_FAST_MATH)
 
 set(HAL_DIR ${MCU_DIR}/st/stm32f1xx_hal_driver)
 set(STM32_CMSIS_DIR ${MCU_DIR}/st/cmsis_device_f1)
@@ -30,6 +30,9 @@ int8_t bsp_can_register_callback(bsp_can_t can, bsp_can_callback_t type,
                                  void *callback_arg);
 int8_t bsp_can_trans_packet(bsp_can_t can, bsp_can_format_t format, uint32_t id,
                             uint8_t *data);
+/* 只接收登记过的ID，超出硬件过滤器容量时全部接收 */
+int8_t bsp_can_add_filter(bsp_can_t can, bsp_can_format_t format, uint32_t id,
+                          uint32_t num);
 int8_t bsp_can_get_msg(bsp_can_t can, uint8_t *data, uint32_t *index);
 
 #ifdef __cplusplus
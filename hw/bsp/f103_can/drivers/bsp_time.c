@@ -7,3 +7,8 @@ uint32_t bsp_time_get_ms() { return HAL_GetTick(); }
 uint32_t bsp_time_get_us() { return HAL_GetTick() * 1000; }
 
 float bsp_time_get() { return ((float)HAL_GetTick() / 1000); }
+
+/* DWT周期计数器，在bsp_init中使能 */
+uint32_t bsp_time_get_cycle() { return DWT->CYCCNT; }
+
+uint32_t bsp_time_get_cycle_freq() { return SystemCoreClock; }
@@ -5,6 +5,8 @@
 #include "main.h"
 #include "task.h"
 
+#define BSP_CAN_FILTER_BANK_NUM (14) /* 每条总线可用的过滤器组数量 */
+
 typedef struct {
   CAN_RxHeaderTypeDef header;
   uint8_t data[8];
@@ -20,6 +22,14 @@ typedef struct {
   void *arg;
 } can_callback_t;
 
+typedef struct {
+  uint16_t std_id[BSP_CAN_FILTER_BANK_NUM * 4];
+  uint32_t ext_id[BSP_CAN_FILTER_BANK_NUM * 2];
+  uint32_t std_num;
+  uint32_t ext_num;
+  bool accept_all;
+} can_filter_list_t;
+
 extern CAN_HandleTypeDef hcan;
 
 static can_callback_t callback_list[BSP_CAN_NUM][BSP_CAN_CB_NUM];
@@ -30,6 +40,8 @@ static uint32_t mailbox[BSP_CAN_NUM];
 
 static can_raw_rx_t rx_buff[BSP_CAN_NUM];
 
+static can_filter_list_t filter_list[BSP_CAN_NUM];
+
 CAN_HandleTypeDef *bsp_can_get_handle(bsp_can_t can) {
   switch (can) {
     case BSP_CAN_1:
@@ -108,6 +120,111 @@ int8_t bsp_can_register_callback(bsp_can_t can, bsp_can_callback_t type,
   return BSP_OK;
 }
 
+static uint32_t can_filter_bank(bsp_can_t can) {
+  (void)can;
+  return 0;
+}
+
+static uint32_t can_filter_fifo(bsp_can_t can) {
+  (void)can;
+  return CAN_FILTER_FIFO0;
+}
+
+static void can_filter_apply(bsp_can_t can) {
+  can_filter_list_t *list = &filter_list[can];
+  CAN_FilterTypeDef can_filter = {0};
+
+  uint32_t bank = can_filter_bank(can);
+  uint32_t bank_end = bank + BSP_CAN_FILTER_BANK_NUM;
+
+  can_filter.SlaveStartFilterBank = 14;
+  can_filter.FilterFIFOAssignment = can_filter_fifo(can);
+  can_filter.FilterActivation = ENABLE;
+
+  if (list->accept_all) {
+    can_filter.FilterBank = bank++;
+    can_filter.FilterMode = CAN_FILTERMODE_IDMASK;
+    can_filter.FilterScale = CAN_FILTERSCALE_32BIT;
+    HAL_CAN_ConfigFilter(bsp_can_get_handle(can), &can_filter);
+  } else {
+    /* 16位列表模式，每组4个标准帧ID，不足时重复填充 */
+    can_filter.FilterMode = CAN_FILTERMODE_IDLIST;
+    can_filter.FilterScale = CAN_FILTERSCALE_16BIT;
+    for (uint32_t i = 0; i < list->std_num; i += 4) {
+      uint32_t id[4];
+      for (uint32_t j = 0; j < 4; j++) {
+        uint32_t n = i + j < list->std_num ? i + j : i;
+        id[j] = (uint32_t)(list->std_id[n]) << 5;
+      }
+      can_filter.FilterBank = bank++;
+      can_filter.FilterIdHigh = id[0];
+      can_filter.FilterIdLow = id[1];
+      can_filter.FilterMaskIdHigh = id[2];
+      can_filter.FilterMaskIdLow = id[3];
+      HAL_CAN_ConfigFilter(bsp_can_get_handle(can), &can_filter);
+    }
+
+    /* 32位列表模式，每组2个扩展帧ID */
+    can_filter.FilterScale = CAN_FILTERSCALE_32BIT;
+    for (uint32_t i = 0; i < list->ext_num; i += 2) {
+      uint32_t id[2];
+      for (uint32_t j = 0; j < 2; j++) {
+        uint32_t n = i + j < list->ext_num ? i + j : i;
+        id[j] = (list->ext_id[n] << 3) | CAN_ID_EXT;
+      }
+      can_filter.FilterBank = bank++;
+      can_filter.FilterIdHigh = id[0] >> 16;
+      can_filter.FilterIdLow = id[0] & 0xffff;
+      can_filter.FilterMaskIdHigh = id[1] >> 16;
+      can_filter.FilterMaskIdLow = id[1] & 0xffff;
+      HAL_CAN_ConfigFilter(bsp_can_get_handle(can), &can_filter);
+    }
+  }
+
+  /* 关闭剩余的过滤器组 */
+  memset(&can_filter, 0, sizeof(can_filter));
+  can_filter.SlaveStartFilterBank = 14;
+  can_filter.FilterActivation = DISABLE;
+  while (bank < bank_end) {
+    can_filter.FilterBank = bank++;
+    HAL_CAN_ConfigFilter(bsp_can_get_handle(can), &can_filter);
+  }
+}
+
+int8_t bsp_can_add_filter(bsp_can_t can, bsp_can_format_t format, uint32_t id,
+                          uint32_t num) {
+  can_filter_list_t *list = &filter_list[can];
+
+  if (list->accept_all) {
+    return BSP_OK;
+  }
+
+  for (uint32_t i = 0; i < num && !list->accept_all; i++) {
+    uint32_t std_num = list->std_num, ext_num = list->ext_num;
+
+    if (format == CAN_FORMAT_STD) {
+      std_num++;
+    } else {
+      ext_num++;
+    }
+
+    /* 列表放不下时退回全部接收，由软件分发表过滤 */
+    if ((std_num + 3) / 4 + (ext_num + 1) / 2 > BSP_CAN_FILTER_BANK_NUM ||
+        (format == CAN_FORMAT_STD && id + i > 0x7ff) ||
+        (format == CAN_FORMAT_EXT && id + i > 0x1fffffff) || id + i < id) {
+      list->accept_all = true;
+    } else if (format == CAN_FORMAT_STD) {
+      list->std_id[list->std_num++] = id + i;
+    } else {
+      list->ext_id[list->ext_num++] = id + i;
+    }
+  }
+
+  can_filter_apply(can);
+
+  return BSP_OK;
+}
+
 int8_t bsp_can_trans_packet(bsp_can_t can, bsp_can_format_t format, uint32_t id,
                             uint8_t *data) {
   CAN_TxHeaderTypeDef header;
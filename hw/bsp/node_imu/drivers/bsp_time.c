@@ -14,3 +14,8 @@ float bsp_time_get() {
   return (float)((xTaskGetTickCount() * 1000 + __HAL_TIM_GET_COUNTER(&htim17)) /
                  1000000.0f);
 }
+
+/* DWT周期计数器，在bsp_init中使能 */
+uint32_t bsp_time_get_cycle() { return DWT->CYCCNT; }
+
+uint32_t bsp_time_get_cycle_freq() { return SystemCoreClock; }
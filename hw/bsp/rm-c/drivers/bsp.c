@@ -18,6 +18,11 @@ void bsp_init() {
   /* Configure the system clock */
   SystemClock_Config();
 
+  /* 使能DWT周期计数器 */
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CYCCNT = 0;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
   /* Initialize all configured peripherals */
   bsp_uart_init();
 
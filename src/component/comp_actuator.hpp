@@ -64,6 +64,68 @@ class SpeedActuator {
   Component::LowPassFilter2p out_;
 };
 
+/* N路速度执行器，一次调用计算全部通道，结果与N个SpeedActuator相同 */
+template <size_t N>
+class SpeedActuatorBank {
+ public:
+  SpeedActuatorBank(std::array<SpeedActuator::Param, N>& param,
+                    float sample_freq)
+      : pid_(Speed(param), sample_freq),
+        in_(sample_freq, InCutoff(param)),
+        out_(sample_freq, OutCutoff(param)) {}
+
+  void Calculate(const std::array<float, N>& setpoint,
+                 const std::array<float, N>& feedback, float dt,
+                 std::array<float, N>& out) {
+    std::array<float, N> filtered;
+    this->in_.Apply(feedback, filtered);
+
+    this->pid_.Calculate(setpoint, filtered, dt, out);
+
+    std::array<float, N> unused;
+    this->out_.Apply(out, unused);
+  }
+
+  void Reset() {
+    this->in_.Reset(0.0f);
+    this->out_.Reset(0.0f);
+    this->pid_.Reset();
+  }
+
+ private:
+  static std::array<PID::Param, N> Speed(
+      const std::array<SpeedActuator::Param, N>& param) {
+    std::array<PID::Param, N> ans;
+    for (size_t i = 0; i < N; i++) {
+      ans[i] = param[i].speed;
+    }
+    return ans;
+  }
+
+  static std::array<float, N> InCutoff(
+      const std::array<SpeedActuator::Param, N>& param) {
+    std::array<float, N> ans;
+    for (size_t i = 0; i < N; i++) {
+      ans[i] = param[i].in_cutoff_freq;
+    }
+    return ans;
+  }
+
+  static std::array<float, N> OutCutoff(
+      const std::array<SpeedActuator::Param, N>& param) {
+    std::array<float, N> ans;
+    for (size_t i = 0; i < N; i++) {
+      ans[i] = param[i].out_cutoff_freq;
+    }
+    return ans;
+  }
+
+  Component::PIDBank<N> pid_;
+
+  Component::LowPassFilter2pBank<N> in_;
+  Component::LowPassFilter2pBank<N> out_;
+};
+
 class PosActuator {
  public:
   typedef struct {
@@ -0,0 +1,95 @@
+/*
+  开源的AHRS算法。
+  MadgwickAHRS
+*/
+
+#include "comp_ahrs.hpp"
+
+#define BETA_IMU (0.033f)
+
+using namespace Component;
+
+static float recip_norm;
+static float s0, s1, s2, s3;
+static float q_dot1, q_dot2, q_dot3, q_dot4;
+static float q_2q0, q_2q1, q_2q2, q_2q3, q_4q0, q_4q1, q_4q2, q_8q1, q_8q2,
+    q0q0, q1q1, q2q2, q3q3;
+
+void Madgwick::Update(Type::Quaternion& quat, const Type::Vector3& accl,
+                      const Type::Vector3& gyro, float dt) {
+  float ax = accl.x;
+  float ay = accl.y;
+  float az = accl.z;
+
+  float gx = gyro.x;
+  float gy = gyro.y;
+  float gz = gyro.z;
+
+  /* Rate of change of quaternion from gyroscope */
+  q_dot1 = 0.5f * (-quat.q1 * gx - quat.q2 * gy - quat.q3 * gz);
+  q_dot2 = 0.5f * (quat.q0 * gx + quat.q2 * gz - quat.q3 * gy);
+  q_dot3 = 0.5f * (quat.q0 * gy - quat.q1 * gz + quat.q3 * gx);
+  q_dot4 = 0.5f * (quat.q0 * gz + quat.q1 * gy - quat.q2 * gx);
+
+  /* Compute feedback only if accelerometer measurement valid (avoids NaN in
+   * accelerometer normalisation) */
+  if (!((ax == 0.0f) && (ay == 0.0f) && (az == 0.0f))) {
+    /* Normalise accelerometer measurement */
+    recip_norm = inv_sqrtf(ax * ax + ay * ay + az * az);
+    ax *= recip_norm;
+    ay *= recip_norm;
+    az *= recip_norm;
+
+    /* Auxiliary variables to avoid repeated arithmetic */
+    q_2q0 = 2.0f * quat.q0;
+    q_2q1 = 2.0f * quat.q1;
+    q_2q2 = 2.0f * quat.q2;
+    q_2q3 = 2.0f * quat.q3;
+    q_4q0 = 4.0f * quat.q0;
+    q_4q1 = 4.0f * quat.q1;
+    q_4q2 = 4.0f * quat.q2;
+    q_8q1 = 8.0f * quat.q1;
+    q_8q2 = 8.0f * quat.q2;
+    q0q0 = quat.q0 * quat.q0;
+    q1q1 = quat.q1 * quat.q1;
+    q2q2 = quat.q2 * quat.q2;
+    q3q3 = quat.q3 * quat.q3;
+
+    /* Gradient decent algorithm corrective step */
+    s0 = q_4q0 * q2q2 + q_2q2 * ax + q_4q0 * q1q1 - q_2q1 * ay;
+    s1 = q_4q1 * q3q3 - q_2q3 * ax + 4.0f * q0q0 * quat.q1 - q_2q0 * ay -
+         q_4q1 + q_8q1 * q1q1 + q_8q1 * q2q2 + q_4q1 * az;
+    s2 = 4.0f * q0q0 * quat.q2 + q_2q0 * ax + q_4q2 * q3q3 - q_2q3 * ay -
+         q_4q2 + q_8q2 * q1q1 + q_8q2 * q2q2 + q_4q2 * az;
+    s3 = 4.0f * q1q1 * quat.q3 - q_2q1 * ax + 4.0f * q2q2 * quat.q3 -
+         q_2q2 * ay;
+
+    /* normalise step magnitude */
+    recip_norm = inv_sqrtf(s0 * s0 + s1 * s1 + s2 * s2 + s3 * s3);
+
+    s0 *= recip_norm;
+    s1 *= recip_norm;
+    s2 *= recip_norm;
+    s3 *= recip_norm;
+
+    /* Apply feedback step */
+    q_dot1 -= BETA_IMU * s0;
+    q_dot2 -= BETA_IMU * s1;
+    q_dot3 -= BETA_IMU * s2;
+    q_dot4 -= BETA_IMU * s3;
+  }
+
+  /* Integrate rate of change of quaternion to yield quaternion */
+  quat.q0 += q_dot1 * dt;
+  quat.q1 += q_dot2 * dt;
+  quat.q2 += q_dot3 * dt;
+  quat.q3 += q_dot4 * dt;
+
+  /* Normalise quaternion */
+  recip_norm = inv_sqrtf(quat.q0 * quat.q0 + quat.q1 * quat.q1 +
+                         quat.q2 * quat.q2 + quat.q3 * quat.q3);
+  quat.q0 *= recip_norm;
+  quat.q1 *= recip_norm;
+  quat.q2 *= recip_norm;
+  quat.q3 *= recip_norm;
+}
@@ -0,0 +1,17 @@
+/*
+  开源的AHRS算法。
+  MadgwickAHRS
+*/
+
+#pragma once
+
+#include <component.hpp>
+
+namespace Component {
+class Madgwick {
+ public:
+  /* 用一组加速度计和陀螺仪数据更新姿态四元数，dt单位为秒 */
+  static void Update(Type::Quaternion& quat, const Type::Vector3& accl,
+                     const Type::Vector3& gyro, float dt);
+};
+}  // namespace Component
@@ -0,0 +1,209 @@
+#include "comp_executor.hpp"
+
+#include "bsp_time.h"
+
+using namespace Component;
+
+std::array<Executor*, EXECUTOR_MAX_NUM> Executor::list_;
+
+uint32_t Executor::num_ = 0;
+
+System::Term::Command<Executor*>* Executor::cmd_ = NULL;
+
+Executor::Executor(const char* name, uint32_t period,
+                   std::initializer_list<const char*> tasks,
+                   const char* trigger)
+    : name_(name), period_(period), trigger_(trigger), task_num_(0) {
+  ASSERT(num_ < EXECUTOR_MAX_NUM);
+  ASSERT(tasks.size() <= EXECUTOR_TASK_MAX_NUM);
+
+  this->cycle_per_us_ = bsp_time_get_cycle_freq() / 1000000;
+  if (this->cycle_per_us_ == 0) {
+    this->cycle_per_us_ = 1;
+  }
+
+  for (const char* task : tasks) {
+    /* 任务已经注册到其他执行器或独立线程，说明执行器构造得太晚 */
+    ASSERT(Find(task) == NULL);
+    this->order_[this->task_num_] = task;
+    this->task_[this->task_num_] = NULL;
+    this->task_num_++;
+  }
+
+  list_[num_++] = this;
+
+  if (cmd_ == NULL) {
+    cmd_ = new System::Term::Command<Executor*>(this, ShowCMD, "executor");
+  }
+}
+
+Executor* Executor::Find(const char* name) {
+  for (uint32_t i = 0; i < num_; i++) {
+    Executor* exec = list_[i];
+    for (uint32_t j = 0; j < exec->task_num_; j++) {
+      if (strcmp(exec->order_[j], name) == 0) {
+        return exec;
+      }
+    }
+  }
+
+  return NULL;
+}
+
+void Executor::Add(Task* task, uint32_t period) {
+  for (uint32_t i = 0; i < num_; i++) {
+    Executor* exec = list_[i];
+    for (uint32_t j = 0; j < exec->task_num_; j++) {
+      if (strcmp(exec->order_[j], task->name) != 0) {
+        continue;
+      }
+
+      /* 线程启动后不能再加入任务 */
+      ASSERT(!exec->started_);
+      ASSERT(exec->task_[j] == NULL);
+      exec->task_[j] = task;
+      return;
+    }
+  }
+
+  /* 没有被执行器声明，单独创建一个线程 */
+  Executor* exec = new Executor(task->name, period, {task->name});
+  exec->task_[0] = task;
+  exec->Start();
+}
+
+void Executor::Start() {
+  ASSERT(!this->started_);
+
+  /* 任务依次运行，栈取最大值，优先级取最高值 */
+  uint32_t stack_depth = 0;
+  System::Thread::Priority priority = System::Thread::IDLE;
+  for (uint32_t i = 0; i < this->task_num_; i++) {
+    Task* task = this->task_[i];
+    if (task == NULL) {
+      continue;
+    }
+    if (task->stack_depth > stack_depth) {
+      stack_depth = task->stack_depth;
+    }
+    if (task->priority > priority) {
+      priority = task->priority;
+    }
+  }
+
+  this->started_ = true;
+
+  if (stack_depth == 0) {
+    return;
+  }
+
+  /* init中创建的触发器和订阅者需要在Memory::Seal之前申请 */
+  System::Memory::BeginInit();
+
+  this->thread_.Create(Run, this, this->name_, stack_depth, priority);
+}
+
+void Executor::Run(Executor* exec) {
+  /* 话题在所有构造函数运行后才保证存在 */
+  Trigger* trigger = NULL;
+  if (exec->trigger_ != NULL) {
+    trigger = new Trigger(exec->trigger_);
+  }
+
+  for (uint32_t i = 0; i < exec->task_num_; i++) {
+    Task* task = exec->task_[i];
+    if (task != NULL) {
+      task->init(task->init_arg);
+    }
+  }
+
+  System::Memory::EndInit();
+
+  while (1) {
+    uint32_t begin = bsp_time_get_cycle();
+    uint32_t last = begin;
+
+    for (uint32_t i = 0; i < exec->task_num_; i++) {
+      Task* task = exec->task_[i];
+      if (task == NULL) {
+        continue;
+      }
+
+      task->step(task->step_arg);
+
+      uint32_t now = bsp_time_get_cycle();
+      uint32_t time = (now - last) / exec->cycle_per_us_;
+      if (time > task->exec_max) {
+        task->exec_max = time;
+      }
+      last = now;
+    }
+
+    uint32_t time = (last - begin) / exec->cycle_per_us_;
+    if (time > exec->exec_max_) {
+      exec->exec_max_ = time;
+    }
+    if (time > exec->period_ * 1000) {
+      exec->overrun_++;
+    }
+
+    /* 运行结束，等待下一次唤醒 */
+    exec->thread_.SleepUntil(exec->period_);
+
+    /* 每个周期最多运行一轮：到达周期边界后丢弃之前的发布，等待边界之后的
+       第一次发布。话题发布频率高于执行器时，控制频率仍然等于周期 */
+    if (trigger != NULL) {
+      trigger->Clear();
+      if (!trigger->Wait(exec->period_)) {
+        /* 话题停止发布，退回定时运行 */
+        exec->timeout_++;
+      }
+    }
+  }
+}
+
+int Executor::ShowCMD(Executor* exec, int argc, char** argv) {
+  (void)(exec);
+
+  if (argc == 1) {
+    printf("名称\t\t周期(ms)\t最大执行(us)\t超时\t触发\r\n");
+    for (uint32_t i = 0; i < num_; i++) {
+      Executor* item = list_[i];
+      printf("%-16s%u\t\t%u\t\t%u\t", item->name_,
+             static_cast<unsigned>(item->period_),
+             static_cast<unsigned>(item->exec_max_),
+             static_cast<unsigned>(item->overrun_));
+      if (item->trigger_ == NULL) {
+        printf("-\r\n");
+      } else {
+        printf("%s(等待超时%u次)\r\n", item->trigger_,
+               static_cast<unsigned>(item->timeout_));
+      }
+      for (uint32_t j = 0; j < item->task_num_; j++) {
+        Task* task = item->task_[j];
+        if (task == NULL) {
+          printf("  %-14s未注册\r\n", item->order_[j]);
+        } else {
+          printf("  %-14s\t\t%u\r\n", task->name,
+                 static_cast<unsigned>(task->exec_max));
+        }
+      }
+    }
+  } else if (argc == 2 && strcmp(argv[1], "reset") == 0) {
+    for (uint32_t i = 0; i < num_; i++) {
+      Executor* item = list_[i];
+      item->exec_max_ = 0;
+      item->overrun_ = 0;
+      item->timeout_ = 0;
+      for (uint32_t j = 0; j < item->task_num_; j++) {
+        if (item->task_[j] != NULL) {
+          item->task_[j]->exec_max = 0;
+        }
+      }
+    }
+  } else {
+    printf("命令错误\r\n");
+  }
+
+  return 0;
+}
@@ -0,0 +1,101 @@
+/*
+  按频率分组的控制任务执行器。
+*/
+
+#pragma once
+
+#include <component.hpp>
+#include <initializer_list>
+
+#include "comp_trigger.hpp"
+
+#define EXECUTOR_MAX_NUM (8)      /* 执行器数量上限 */
+#define EXECUTOR_TASK_MAX_NUM (8) /* 每个执行器的任务数量上限 */
+
+namespace Component {
+/* 同一执行器的任务在一个线程中按声明顺序依次运行，前一个任务发布的数据
+   在同一周期内被后面的任务读取。没有被任何执行器声明的任务使用独立线程，
+   因此执行器必须在注册任务的对象之前构造，否则触发断言。
+   指定trigger时在每个周期边界之后的第一次话题发布时运行一轮，每个周期
+   最多运行一轮，超过一个周期没有发布则按周期运行 */
+class Executor {
+ public:
+  typedef struct {
+    const char* name;
+    void (*init)(void*); /* 在执行器线程中运行一次，可以申请内存 */
+    void (*step)(void*); /* 每个周期运行一次 */
+    void* init_arg;
+    void* step_arg;
+    uint32_t stack_depth;
+    System::Thread::Priority priority;
+    uint32_t exec_max; /* 微秒 */
+  } Task;
+
+  /* period单位为ms，tasks为任务名，按运行顺序排列 */
+  Executor(const char* name, uint32_t period,
+           std::initializer_list<const char*> tasks,
+           const char* trigger = NULL);
+
+  /* 在所有任务注册后调用 */
+  void Start();
+
+  /* 由模块在构造时调用，period和stack_depth只在使用独立线程时生效 */
+  template <typename InitFun, typename StepFun, typename ArgType>
+  static void Register(const char* name, uint32_t period, InitFun init,
+                       StepFun step, ArgType arg, uint32_t stack_depth,
+                       System::Thread::Priority priority) {
+    (void)static_cast<void (*)(ArgType)>(init);
+    (void)static_cast<void (*)(ArgType)>(step);
+
+    auto init_type = static_cast<System::TypeErasure<void, ArgType>*>(
+        System::Memory::Malloc(sizeof(System::TypeErasure<void, ArgType>)));
+    *init_type = System::TypeErasure<void, ArgType>(init, arg);
+
+    auto step_type = static_cast<System::TypeErasure<void, ArgType>*>(
+        System::Memory::Malloc(sizeof(System::TypeErasure<void, ArgType>)));
+    *step_type = System::TypeErasure<void, ArgType>(step, arg);
+
+    Task* task = static_cast<Task*>(System::Memory::Malloc(sizeof(Task)));
+    task->name = name;
+    task->init = init_type->Port;
+    task->step = step_type->Port;
+    task->init_arg = init_type;
+    task->step_arg = step_type;
+    task->stack_depth = stack_depth;
+    task->priority = priority;
+    task->exec_max = 0;
+
+    Add(task, period);
+  }
+
+  static int ShowCMD(Executor* exec, int argc, char** argv);
+
+  /* 返回声明了该任务的执行器 */
+  static Executor* Find(const char* name);
+
+ private:
+  static void Add(Task* task, uint32_t period);
+
+  static void Run(Executor* exec);
+
+  const char* name_;
+  uint32_t period_;
+  const char* trigger_;
+  uint32_t task_num_;
+  uint32_t cycle_per_us_;
+
+  std::array<const char*, EXECUTOR_TASK_MAX_NUM> order_;
+  std::array<Task*, EXECUTOR_TASK_MAX_NUM> task_;
+
+  bool started_ = false;
+  uint32_t exec_max_ = 0; /* 微秒 */
+  uint32_t overrun_ = 0;  /* 一轮执行时间超过周期的次数 */
+  uint32_t timeout_ = 0;  /* 等待触发超时的次数 */
+
+  System::Thread thread_;
+
+  static std::array<Executor*, EXECUTOR_MAX_NUM> list_;
+  static uint32_t num_;
+  static System::Term::Command<Executor*>* cmd_;
+};
+}  // namespace Component
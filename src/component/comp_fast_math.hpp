@@ -0,0 +1,181 @@
+/*
+  快速三角函数和开方。
+*/
+
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+namespace Component {
+namespace FastMath {
+/* 多项式近似实现，任何平台都可以直接调用。
+   误差为utils/benchmark中--accuracy在全部定义域上扫描得到的最大值 */
+namespace Approx {
+/* 最大绝对误差 1e-7，|x| <= 1e4 */
+static inline void SinCos(float x, float *s, float *c) {
+  /* 以pi/2为周期缩减到[-pi/4, pi/4]，pi/2分三段减去以保留精度 */
+  const float FK = x * 0.63661977236758134f;
+  const int32_t K = static_cast<int32_t>(FK >= 0.0f ? FK + 0.5f : FK - 0.5f);
+  const float KF = static_cast<float>(K);
+
+  float r = x - KF * 1.5703125f;
+  r -= KF * 4.837512969970703125e-4f;
+  r -= KF * 7.54978995489188216e-8f;
+
+  /* Cephes sinf/cosf 系数 */
+  const float R2 = r * r;
+  const float SIN_R =
+      r + r * R2 *
+              (-1.6666654611e-1f + R2 * (8.3321608736e-3f +
+                                         R2 * -1.9515295891e-4f));
+  const float COS_R =
+      1.0f - 0.5f * R2 +
+      R2 * R2 *
+          (4.166664568298827e-2f +
+           R2 * (-1.388731625493765e-3f + R2 * 2.443315711809948e-5f));
+
+  switch (K & 3) {
+    case 0:
+      *s = SIN_R;
+      *c = COS_R;
+      break;
+    case 1:
+      *s = COS_R;
+      *c = -SIN_R;
+      break;
+    case 2:
+      *s = -SIN_R;
+      *c = -COS_R;
+      break;
+    default:
+      *s = -COS_R;
+      *c = SIN_R;
+      break;
+  }
+}
+
+/* 最大绝对误差 2e-6 rad，atan2(0, 0)返回0 */
+static inline float Atan2(float y, float x) {
+  const float AX = fabsf(x);
+  const float AY = fabsf(y);
+  const float MAX = AX > AY ? AX : AY;
+  const float MIN = AX > AY ? AY : AX;
+
+  if (MAX == 0.0f) {
+    return 0.0f;
+  }
+
+  /* [0, 1]上atan的奇次多项式 */
+  const float A = MIN / MAX;
+  const float S = A * A;
+  float r = A * (0.99997726f +
+                 S * (-0.33262347f +
+                      S * (0.19354346f +
+                           S * (-0.11643287f +
+                                S * (0.05265332f + S * -0.01172120f)))));
+
+  if (AY > AX) {
+    r = 1.57079632679489662f - r;
+  }
+  if (x < 0.0f) {
+    r = 3.14159265358979324f - r;
+  }
+  if (y < 0.0f) {
+    r = -r;
+  }
+
+  return r;
+}
+
+/* 平方根倒数，最大相对误差 5e-6，x > 0 */
+static inline float InvSqrt(float x) {
+  uint32_t i = 0;
+  memcpy(&i, &x, sizeof(i));
+  i = 0x5f375a86 - (i >> 1);
+
+  float y = 0.0f;
+  memcpy(&y, &i, sizeof(y));
+
+  const float HALF_X = 0.5f * x;
+  y = y * (1.5f - HALF_X * y * y);
+  y = y * (1.5f - HALF_X * y * y);
+
+  return y;
+}
+
+/* 最大相对误差 5e-6，x <= 0时返回0 */
+static inline float Sqrt(float x) {
+  if (x <= 0.0f) {
+    return 0.0f;
+  }
+  return x * InvSqrt(x);
+}
+
+/* 最大绝对误差 8e-6 rad，输入限制在[-1, 1] */
+static inline float Asin(float x) {
+  const float A = fabsf(x);
+
+  if (A >= 1.0f) {
+    return copysignf(1.57079632679489662f, x);
+  }
+
+  /* Abramowitz & Stegun 4.4.46 */
+  const float P =
+      1.5707963050f +
+      A * (-0.2145988016f +
+           A * (0.0889789874f +
+                A * (-0.0501743046f +
+                     A * (0.0308918810f +
+                          A * (-0.0170881256f +
+                               A * (0.0066700901f + A * -0.0012624911f))))));
+
+  return copysignf(1.57079632679489662f - Sqrt(1.0f - A) * P, x);
+}
+}  // namespace Approx
+
+/* 板级定义USE_FAST_MATH时使用近似实现，否则使用libm。
+   带FPU的芯片开方是单条指令，始终使用sqrtf */
+#ifdef USE_FAST_MATH
+static inline void SinCos(float x, float *s, float *c) {
+  Approx::SinCos(x, s, c);
+}
+
+static inline float Atan2(float y, float x) { return Approx::Atan2(y, x); }
+
+static inline float Asin(float x) { return Approx::Asin(x); }
+#else
+static inline void SinCos(float x, float *s, float *c) {
+  *s = sinf(x);
+  *c = cosf(x);
+}
+
+static inline float Atan2(float y, float x) { return atan2f(y, x); }
+
+static inline float Asin(float x) { return asinf(x); }
+#endif
+
+#if defined(USE_FAST_MATH) && !defined(__ARM_FP)
+static inline float Sqrt(float x) { return Approx::Sqrt(x); }
+
+static inline float InvSqrt(float x) { return Approx::InvSqrt(x); }
+#else
+static inline float Sqrt(float x) { return sqrtf(x); }
+
+static inline float InvSqrt(float x) { return 1.0f / sqrtf(x); }
+#endif
+
+static inline float Sin(float x) {
+  float s = 0.0f, c = 0.0f;
+  SinCos(x, &s, &c);
+  return s;
+}
+
+static inline float Cos(float x) {
+  float s = 0.0f, c = 0.0f;
+  SinCos(x, &s, &c);
+  return c;
+}
+}  // namespace FastMath
+}  // namespace Component
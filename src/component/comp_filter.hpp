@@ -6,6 +6,9 @@
 
 #include <component.hpp>
 
+#include "comp_fixed.hpp"
+#include "comp_simd.hpp"
+
 namespace Component {
 /* 一阶数字低通滤波器 */
 class LowPassFilter {
@@ -31,6 +34,11 @@ class LowPassFilter2p {
   float Reset(float sample);
 
  private:
+  template <size_t N>
+  friend class LowPassFilter2pBank;
+  template <typename T>
+  friend class LowPassFilter2pFixed;
+
   float cutoff_freq_; /* 截止频率 */
 
   float a1_;
@@ -43,4 +51,177 @@ class LowPassFilter2p {
   float delay_element_1_;
   float delay_element_2_;
 };
+
+/* N路二阶巴特沃斯低通滤波器，各通道截止频率可以不同。
+   参数和状态按通道连续存放，每次调用同时计算全部通道 */
+template <size_t N>
+class LowPassFilter2pBank {
+ public:
+  static constexpr size_t LANES = SIMD::Lanes(N);
+
+  LowPassFilter2pBank(float sample_freq, const std::array<float, N> &cutoff)
+      : sample_freq_(sample_freq) {
+    /* 补齐的通道直接输出输入值 */
+    for (size_t i = 0; i < LANES; i++) {
+      this->SetCutoff(i, 0.0f);
+    }
+    for (size_t i = 0; i < N; i++) {
+      this->SetCutoff(i, cutoff[i]);
+    }
+    this->Reset(0.0f);
+  }
+
+  void SetCutoff(size_t ch, float cutoff_freq) {
+    ASSERT(ch < LANES);
+
+    LowPassFilter2p filter(this->sample_freq_, cutoff_freq);
+    this->a1_[ch] = filter.a1_;
+    this->a2_[ch] = filter.a2_;
+    this->b0_[ch] = filter.b0_;
+    this->b1_[ch] = filter.b1_;
+    this->b2_[ch] = filter.b2_;
+  }
+
+  void Apply(const std::array<float, N> &sample, std::array<float, N> &out) {
+    const float *src = sample.data();
+    float *dst = out.data();
+
+    /* 通道数不是向量宽度的整数倍时补齐 */
+    float in_buff[LANES] = {}, out_buff[LANES];
+    if (N != LANES) {
+      memcpy(in_buff, sample.data(), sizeof(float) * N);
+      src = in_buff;
+      dst = out_buff;
+    }
+
+    for (size_t i = 0; i < LANES; i += SIMD::WIDTH) {
+      SIMD::Store(dst + i, this->Step(i, SIMD::Load(src + i), SIMD::True()));
+    }
+
+    if (N != LANES) {
+      memcpy(out.data(), out_buff, sizeof(float) * N);
+    }
+  }
+
+  void Reset(float sample) {
+    for (size_t i = 0; i < LANES; i++) {
+      const float DVAL = sample / (this->b0_[i] + this->b1_[i] + this->b2_[i]);
+
+      if (std::isfinite(DVAL)) {
+        this->delay_element_1_[i] = DVAL;
+        this->delay_element_2_[i] = DVAL;
+      } else {
+        this->delay_element_1_[i] = sample;
+        this->delay_element_2_[i] = sample;
+      }
+    }
+
+    /* 与LowPassFilter2p::Reset保持一致，用sample运行一次 */
+    for (size_t i = 0; i < LANES; i += SIMD::WIDTH) {
+      this->Step(i, SIMD::Set(sample), SIMD::True());
+    }
+  }
+
+  /* 计算从第lane个通道开始的一组通道，只有update为真的通道更新状态 */
+  SIMD::Vector Step(size_t lane, SIMD::Vector sample, SIMD::Mask update) {
+    using namespace SIMD;
+
+    const Vector D1 = Load(this->delay_element_1_ + lane);
+    const Vector D2 = Load(this->delay_element_2_ + lane);
+
+    Vector d0 = Sub(Sub(sample, Mul(D1, Load(this->a1_ + lane))),
+                    Mul(D2, Load(this->a2_ + lane)));
+
+    /* don't allow bad values to propagate via the filter */
+    d0 = Select(Inf(d0), sample, d0);
+
+    const Vector OUTPUT = Add(Add(Mul(d0, Load(this->b0_ + lane)),
+                                  Mul(D1, Load(this->b1_ + lane))),
+                              Mul(D2, Load(this->b2_ + lane)));
+
+    Store(this->delay_element_2_ + lane, Select(update, D1, D2));
+    Store(this->delay_element_1_ + lane, Select(update, d0, D1));
+
+    return OUTPUT;
+  }
+
+ private:
+  float sample_freq_;
+
+  float a1_[LANES];
+  float a2_[LANES];
+
+  float b0_[LANES];
+  float b1_[LANES];
+  float b2_[LANES];
+
+  float delay_element_1_[LANES];
+  float delay_element_2_[LANES];
+};
+
+/* 定点二阶巴特沃斯低通滤波器，系数由LowPassFilter2p换算得到。
+   使用直接I型，内部状态固定保留31位小数，Q15也不会因为截断产生死区 */
+template <typename T>
+class LowPassFilter2pFixed {
+ public:
+  typedef typename T::Acc Acc;
+
+  static constexpr int STATE_FRAC = 31;
+
+  LowPassFilter2pFixed(float sample_freq, float cutoff_freq) {
+    LowPassFilter2p filter(sample_freq, cutoff_freq);
+    this->a1_ = FixedGain(filter.a1_);
+    this->a2_ = FixedGain(filter.a2_);
+    this->b0_ = FixedGain(filter.b0_);
+    this->b1_ = FixedGain(filter.b1_);
+    this->b2_ = FixedGain(filter.b2_);
+
+    this->Reset(T());
+  }
+
+  T Apply(T sample) {
+    return T::Saturate(
+        fixed_shift(this->Step(ToState(sample)), STATE_FRAC - T::FRAC));
+  }
+
+  T Reset(T sample) {
+    const Acc STATE = ToState(sample);
+    this->x1_ = this->x2_ = STATE;
+    this->y1_ = this->y2_ = STATE;
+
+    return this->Apply(sample);
+  }
+
+  /* 输入输出都有STATE_FRAC位小数，输出不饱和，供PIDFixed使用 */
+  Acc Step(Acc sample) {
+    const Acc OUTPUT = this->b0_.Apply(sample, STATE_FRAC, STATE_FRAC) +
+                       this->b1_.Apply(this->x1_, STATE_FRAC, STATE_FRAC) +
+                       this->b2_.Apply(this->x2_, STATE_FRAC, STATE_FRAC) -
+                       this->a1_.Apply(this->y1_, STATE_FRAC, STATE_FRAC) -
+                       this->a2_.Apply(this->y2_, STATE_FRAC, STATE_FRAC);
+
+    this->x2_ = this->x1_;
+    this->x1_ = sample;
+    this->y2_ = this->y1_;
+    this->y1_ = OUTPUT;
+
+    return OUTPUT;
+  }
+
+  static Acc ToState(T x) {
+    return static_cast<Acc>(x.raw_) *
+           (static_cast<Acc>(1) << (STATE_FRAC - T::FRAC));
+  }
+
+ private:
+  FixedGain a1_;
+  FixedGain a2_;
+
+  FixedGain b0_;
+  FixedGain b1_;
+  FixedGain b2_;
+
+  Acc x1_, x2_; /* 上两次输入 */
+  Acc y1_, y2_; /* 上两次输出 */
+};
 }  // namespace Component
@@ -0,0 +1,228 @@
+/*
+  定点数。
+*/
+
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+namespace Component {
+/* Raw为存储类型，FRAC为小数位数，表示[-1, 1)。加减乘均为饱和运算，
+   中间结果使用int64_t，在没有FPU的芯片上代替float */
+template <typename RawType, unsigned FRAC_BITS>
+class Fixed {
+ public:
+  typedef RawType Raw;
+  typedef int64_t Acc;
+
+  static constexpr unsigned FRAC = FRAC_BITS;
+  static constexpr Acc ONE = static_cast<Acc>(1) << FRAC;
+  static constexpr Acc RAW_MAX = std::numeric_limits<Raw>::max();
+  static constexpr Acc RAW_MIN = std::numeric_limits<Raw>::min();
+
+  Fixed() : raw_(0) {}
+
+  static Fixed FromRaw(Raw raw) {
+    Fixed ans;
+    ans.raw_ = raw;
+    return ans;
+  }
+
+  /* 只在初始化时调用，运行中应避免浮点运算 */
+  static Fixed FromFloat(float x) {
+    return Saturate(
+        static_cast<Acc>(floor(static_cast<double>(x) * ONE + 0.5)));
+  }
+
+  static Fixed Saturate(Acc raw) {
+    if (raw > RAW_MAX) {
+      raw = RAW_MAX;
+    } else if (raw < RAW_MIN) {
+      raw = RAW_MIN;
+    }
+    return FromRaw(static_cast<Raw>(raw));
+  }
+
+  static Fixed Max() { return FromRaw(static_cast<Raw>(RAW_MAX)); }
+
+  static Fixed Min() { return FromRaw(static_cast<Raw>(RAW_MIN)); }
+
+  float ToFloat() const {
+    return static_cast<float>(static_cast<double>(this->raw_) / ONE);
+  }
+
+  Fixed operator+(const Fixed &x) const {
+    return Saturate(static_cast<Acc>(this->raw_) + x.raw_);
+  }
+
+  Fixed operator-(const Fixed &x) const {
+    return Saturate(static_cast<Acc>(this->raw_) - x.raw_);
+  }
+
+  Fixed operator-() const { return Saturate(-static_cast<Acc>(this->raw_)); }
+
+  /* 四舍五入 */
+  Fixed operator*(const Fixed &x) const {
+    Acc prod = static_cast<Acc>(this->raw_) * x.raw_;
+    return Saturate((prod + (ONE >> 1)) >> FRAC);
+  }
+
+  Fixed &operator+=(const Fixed &x) { return *this = *this + x; }
+
+  Fixed &operator-=(const Fixed &x) { return *this = *this - x; }
+
+  bool operator<(const Fixed &x) const { return this->raw_ < x.raw_; }
+
+  bool operator>(const Fixed &x) const { return this->raw_ > x.raw_; }
+
+  bool operator<=(const Fixed &x) const { return this->raw_ <= x.raw_; }
+
+  bool operator>=(const Fixed &x) const { return this->raw_ >= x.raw_; }
+
+  bool operator==(const Fixed &x) const { return this->raw_ == x.raw_; }
+
+  bool operator!=(const Fixed &x) const { return this->raw_ != x.raw_; }
+
+  Raw raw_;
+};
+
+typedef Fixed<int16_t, 15> Q15;
+typedef Fixed<int32_t, 31> Q31;
+
+/* 由Kconfig按目标选择控制组件使用的定点格式，默认Q31 */
+#ifdef COMPONENT_FIXED_Q15
+typedef Q15 ControlFixed;
+#else
+typedef Q31 ControlFixed;
+#endif
+
+/* 右移并四舍五入，shift为负时左移并饱和 */
+static inline int64_t fixed_shift(int64_t x, int shift) {
+  if (shift > 0) {
+    if (shift > 62) {
+      return 0;
+    }
+    return (x + (static_cast<int64_t>(1) << (shift - 1))) >> shift;
+  }
+  if (shift < 0) {
+    if (shift < -62) {
+      shift = -62;
+    }
+    const int64_t LIMIT = std::numeric_limits<int64_t>::max() >> (-shift);
+    if (x > LIMIT) {
+      return LIMIT * (static_cast<int64_t>(1) << (-shift));
+    }
+    if (x < -LIMIT) {
+      return -LIMIT * (static_cast<int64_t>(1) << (-shift));
+    }
+    return x * (static_cast<int64_t>(1) << (-shift));
+  }
+  return x;
+}
+
+/* 任意大小的常数增益，表示为mult * 2^shift，mult有24位有效数字，
+   与float尾数精度相同。用于PID增益和滤波器系数等超出[-1, 1)的常数 */
+class FixedGain {
+ public:
+  static constexpr int MULT_FRAC = 24;
+
+  /* 输入绝对值上限，保证乘积不超出int64_t */
+  static constexpr int64_t INPUT_MAX = static_cast<int64_t>(1) << 38;
+
+  FixedGain() : mult_(0), shift_(0) {}
+
+  explicit FixedGain(float gain) : mult_(0), shift_(0) {
+    if (gain == 0.0f || !std::isfinite(gain)) {
+      return;
+    }
+
+    /* 尾数规格化到[0.5, 1) */
+    int exp = 0;
+    double mant = frexp(static_cast<double>(gain), &exp);
+    int64_t mult = static_cast<int64_t>(
+        floor(mant * static_cast<double>(1 << MULT_FRAC) + 0.5));
+    if (mult >= (static_cast<int64_t>(1) << MULT_FRAC) ||
+        mult <= -(static_cast<int64_t>(1) << MULT_FRAC)) {
+      mult /= 2;
+      exp++;
+    }
+    this->mult_ = static_cast<int32_t>(mult);
+    this->shift_ = exp;
+  }
+
+  bool Zero() const { return this->mult_ == 0; }
+
+  /* 返回x * gain，x有x_frac位小数，结果有out_frac位小数 */
+  int64_t Apply(int64_t x, int x_frac, int out_frac) const {
+    if (x > INPUT_MAX) {
+      x = INPUT_MAX;
+    } else if (x < -INPUT_MAX) {
+      x = -INPUT_MAX;
+    }
+    return fixed_shift(x * this->mult_,
+                       x_frac + MULT_FRAC - this->shift_ - out_frac);
+  }
+
+ private:
+  int32_t mult_;
+  int shift_;
+};
+
+/* 定点循环角度，Raw的整个范围对应一周，加减自然回绕。
+   T::ONE对应pi，与Type::CycleValue相减的结果一致，落在[-pi, pi) */
+template <typename T>
+class CycleValueFixed {
+ public:
+  typedef typename T::Raw Raw;
+  typedef typename std::make_unsigned<Raw>::type URaw;
+
+  CycleValueFixed() : raw_(0) {}
+
+  static CycleValueFixed FromRaw(Raw raw) {
+    CycleValueFixed ans;
+    ans.raw_ = raw;
+    return ans;
+  }
+
+  /* 弧度，只在初始化时调用 */
+  static CycleValueFixed FromFloat(float angle) {
+    double turn = static_cast<double>(angle) / (2.0 * M_PI);
+    turn -= floor(turn);
+    double full = static_cast<double>(static_cast<URaw>(-1)) + 1.0;
+    return FromRaw(static_cast<Raw>(
+        static_cast<URaw>(static_cast<uint64_t>(floor(turn * full + 0.5)))));
+  }
+
+  /* [0, 2pi) */
+  float ToFloat() const {
+    double full = static_cast<double>(static_cast<URaw>(-1)) + 1.0;
+    return static_cast<float>(static_cast<URaw>(this->raw_) / full * 2.0 *
+                              M_PI);
+  }
+
+  CycleValueFixed operator+(const T &x) const {
+    return FromRaw(static_cast<Raw>(static_cast<URaw>(this->raw_) +
+                                    static_cast<URaw>(x.raw_)));
+  }
+
+  CycleValueFixed operator-(const T &x) const {
+    return FromRaw(static_cast<Raw>(static_cast<URaw>(this->raw_) -
+                                    static_cast<URaw>(x.raw_)));
+  }
+
+  /* 两个角度之差，单位为pi */
+  T operator-(const CycleValueFixed &x) const {
+    return T::FromRaw(static_cast<Raw>(static_cast<URaw>(this->raw_) -
+                                       static_cast<URaw>(x.raw_)));
+  }
+
+  CycleValueFixed &operator+=(const T &x) { return *this = *this + x; }
+
+  CycleValueFixed &operator-=(const T &x) { return *this = *this - x; }
+
+  Raw raw_;
+};
+}  // namespace Component
@@ -6,6 +6,8 @@
 
 #include <component.hpp>
 
+#include "comp_fixed.hpp"
+
 /** 四轮布局 */
 /* 前 */
 /* 2 1 */
@@ -33,6 +35,77 @@ class Mixer {
 
   bool Apply(Component::Type::MoveVector &move_vec, float *out);
 
+  /* 定点版本，与float版本相同，超出[-1, 1)时按最大值等比例缩小 */
+  template <typename T>
+  bool Apply(T vx, T vy, T wz, T *out) {
+    typedef typename T::Acc Acc;
+
+    Acc ans[4] = {};
+
+    switch (this->mode_) {
+      case MECANUM:
+        ASSERT(this->len_ == 4);
+        ans[0] = static_cast<Acc>(vx.raw_) - vy.raw_ + wz.raw_;
+        ans[1] = static_cast<Acc>(vx.raw_) + vy.raw_ + wz.raw_;
+        ans[2] = -static_cast<Acc>(vx.raw_) + vy.raw_ + wz.raw_;
+        ans[3] = -static_cast<Acc>(vx.raw_) - vy.raw_ + wz.raw_;
+        break;
+
+      case PARLFIX4:
+        ASSERT(this->len_ == 4);
+        ans[0] = -static_cast<Acc>(vy.raw_);
+        ans[1] = vy.raw_;
+        ans[2] = vy.raw_;
+        ans[3] = -static_cast<Acc>(vy.raw_);
+        break;
+
+      case PARLFIX2:
+        ASSERT(this->len_ == 2);
+        ans[0] = -static_cast<Acc>(vx.raw_);
+        ans[1] = vx.raw_;
+        break;
+
+      case SINGLE:
+        ASSERT(this->len_ == 1);
+        ans[0] = vy.raw_;
+        break;
+
+      case OMNICROSS:
+      case OMNIPLUS:
+        for (size_t i = 0; i < this->len_; i++) {
+          ans[i] = out[i].raw_;
+        }
+        break;
+
+      case NONE:
+        break;
+
+      default:
+        break;
+    }
+
+    Acc abs_max = 0;
+    for (size_t i = 0; i < this->len_; i++) {
+      const Acc ABS_VAL = ans[i] < 0 ? -ans[i] : ans[i];
+      abs_max = (ABS_VAL > abs_max) ? ABS_VAL : abs_max;
+    }
+
+    /* 除法前左移L位，同时把除数右移，避免Q31溢出 */
+    constexpr int L = T::FRAC < 28 ? T::FRAC : 28;
+    if (abs_max > T::ONE) {
+      for (size_t i = 0; i < this->len_; i++) {
+        ans[i] = ans[i] * (static_cast<Acc>(1) << L) /
+                 (abs_max >> (T::FRAC - L));
+      }
+    }
+
+    for (size_t i = 0; i < this->len_; i++) {
+      out[i] = T::Saturate(ans[i]);
+    }
+
+    return 0;
+  }
+
   Mode mode_;
 
   uint8_t len_;
@@ -13,8 +13,6 @@
 
 #include "comp_pid.hpp"
 
-#define SIGMA 0.000001f
-
 using namespace Component;
 
 PID::PID(PID::Param &param, float sample_freq)
@@ -64,7 +62,7 @@ float PID::Calculate(float sp, float fb, float dt) {
   const float I = this->i_ + (k_err * dt);
   const float I_OUT = I * this->param_.i;
 
-  if (this->param_.i > SIGMA) {
+  if (this->param_.i > PID_SIGMA) {
     /* 检查是否饱和 */
     if (isfinite(I)) {
       if ((fabsf(output + I_OUT) <= this->param_.out_limit) &&
@@ -80,7 +78,7 @@ float PID::Calculate(float sp, float fb, float dt) {
 
   /* 限制输出 */
   if (isfinite(output)) {
-    if (this->param_.out_limit > SIGMA) {
+    if (this->param_.out_limit > PID_SIGMA) {
       output = abs_clampf(output, this->param_.out_limit);
     }
     this->last_.out = output;
@@ -124,7 +122,7 @@ float PID::Calculate(float sp, float fb, float fb_dot, float dt) {
   const float I = this->i_ + (k_err * dt);
   const float I_OUT = I * this->param_.i;
 
-  if (this->param_.i > SIGMA) {
+  if (this->param_.i > PID_SIGMA) {
     /* 检查是否饱和 */
     if (isfinite(I)) {
       if ((fabsf(output + I_OUT) <= this->param_.out_limit) &&
@@ -140,7 +138,7 @@ float PID::Calculate(float sp, float fb, float fb_dot, float dt) {
 
   /* 限制输出 */
   if (isfinite(output)) {
-    if (this->param_.out_limit > SIGMA) {
+    if (this->param_.out_limit > PID_SIGMA) {
       output = abs_clampf(output, this->param_.out_limit);
     }
     this->last_.out = output;
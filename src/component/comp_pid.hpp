@@ -9,6 +9,8 @@
 
 #include "comp_filter.hpp"
 
+#define PID_SIGMA (0.000001f) /* 小于此值的增益和限幅视为零 */
+
 namespace Component {
 class PID {
  public:
@@ -54,4 +56,314 @@ class PID {
 
   LowPassFilter2p dfilter_;
 };
+
+/* N路PID，与PID::Calculate(sp, fb, dt)逐通道结果相同。
+   输入非有限值的通道保持上次输出，不更新状态 */
+template <size_t N>
+class PIDBank {
+ public:
+  static constexpr size_t LANES = SIMD::Lanes(N);
+
+  PIDBank(const std::array<PID::Param, N> &param, float sample_freq)
+      : dfilter_(sample_freq, DCutoff(param)) {
+    float dt_min = 1.0f / sample_freq;
+    ASSERT(std::isfinite(dt_min));
+    this->dt_min_ = dt_min;
+
+    /* 补齐的通道参数为零，输出恒为零 */
+    PID::Param empty = {};
+    for (size_t i = 0; i < LANES; i++) {
+      this->SetParam(i, i < N ? param[i] : empty);
+    }
+
+    this->Reset();
+  }
+
+  /* 不改变D项滤波器截止频率 */
+  void SetParam(size_t ch, const PID::Param &param) {
+    ASSERT(ch < LANES);
+
+    this->k_[ch] = param.k;
+    this->p_[ch] = param.p;
+    this->i_gain_[ch] = param.i;
+    this->d_[ch] = param.d;
+    this->i_limit_[ch] = param.i_limit;
+    this->out_limit_[ch] = param.out_limit;
+    this->cycle_[ch] = param.cycle;
+
+    this->any_cycle_ = false;
+    for (size_t i = 0; i < LANES; i++) {
+      this->any_cycle_ = this->any_cycle_ || this->cycle_[i];
+    }
+  }
+
+  void Reset() {
+    for (size_t i = 0; i < LANES; i++) {
+      this->i_[i] = 0.0f;
+      this->last_k_fb_[i] = 0.0f;
+      this->last_out_[i] = 0.0f;
+    }
+    this->dfilter_.Reset(0.0f);
+  }
+
+  void Calculate(const std::array<float, N> &sp, const std::array<float, N> &fb,
+                 float dt, std::array<float, N> &out) {
+    if (!std::isfinite(dt)) {
+      memcpy(out.data(), this->last_out_, sizeof(float) * N);
+      return;
+    }
+
+    const float *sp_src = sp.data();
+    const float *fb_src = fb.data();
+
+    /* 通道数不是向量宽度的整数倍时补齐 */
+    float sp_buff[LANES] = {}, fb_buff[LANES] = {};
+    if (N != LANES) {
+      memcpy(sp_buff, sp.data(), sizeof(float) * N);
+      memcpy(fb_buff, fb.data(), sizeof(float) * N);
+      sp_src = sp_buff;
+      fb_src = fb_buff;
+    }
+
+    /* 循环角度误差需要取模，逐通道计算 */
+    float err_buff[LANES];
+    for (size_t i = 0; i < LANES && this->any_cycle_; i++) {
+      if (this->cycle_[i] && std::isfinite(sp_src[i]) &&
+          std::isfinite(fb_src[i])) {
+        err_buff[i] = Component::Type::CycleValue(sp_src[i]) - fb_src[i];
+      } else {
+        err_buff[i] = sp_src[i] - fb_src[i];
+      }
+    }
+
+    using namespace SIMD;
+
+    const Vector DT = Set(dt);
+    const Vector D_DT = Set(fmaxf(dt, this->dt_min_));
+    const Vector SIGMA = Set(PID_SIGMA);
+    const Vector ZERO = Set(0.0f);
+
+    for (size_t i = 0; i < LANES; i += WIDTH) {
+      const Vector SP = Load(sp_src + i);
+      const Vector FB = Load(fb_src + i);
+      const Mask OK = And(Finite(SP), Finite(FB));
+
+      const Vector K = Load(this->k_ + i);
+      const Vector I_GAIN = Load(this->i_gain_ + i);
+      const Vector OUT_LIMIT = Load(this->out_limit_ + i);
+
+      /* 计算误差值 */
+      const Vector ERR = this->any_cycle_ ? Load(err_buff + i) : Sub(SP, FB);
+
+      /* 计算P项 */
+      const Vector K_ERR = Mul(ERR, K);
+
+      /* 计算D项，通过fb计算D，避免了由于sp变化导致err突变的问题 */
+      const Vector FILTERED_K_FB = this->dfilter_.Step(i, Mul(K, FB), OK);
+      const Vector LAST_K_FB = Load(this->last_k_fb_ + i);
+      Vector d = Div(Sub(FILTERED_K_FB, LAST_K_FB), D_DT);
+      d = Select(Finite(d), d, ZERO);
+
+      Store(this->last_k_fb_ + i, Select(OK, FILTERED_K_FB, LAST_K_FB));
+
+      /* 计算PD输出 */
+      Vector output = Sub(Mul(K_ERR, Load(this->p_ + i)),
+                          Mul(d, Load(this->d_ + i)));
+
+      /* 计算I项，未饱和时使用新积分 */
+      const Vector LAST_I = Load(this->i_ + i);
+      const Vector I = Add(LAST_I, Mul(K_ERR, DT));
+      const Vector I_OUT = Mul(I, I_GAIN);
+
+      Mask update_i = And(OK, And(Greater(I_GAIN, SIGMA), Finite(I)));
+      update_i = And(update_i, LessEqual(Abs(Add(output, I_OUT)), OUT_LIMIT));
+      update_i = And(update_i, LessEqual(Abs(I), Load(this->i_limit_ + i)));
+      Store(this->i_ + i, Select(update_i, I, LAST_I));
+
+      /* 计算PID输出并限幅 */
+      output = Add(output, I_OUT);
+      output = Select(Greater(OUT_LIMIT, SIGMA),
+                      Min(OUT_LIMIT, Max(output, Sub(ZERO, OUT_LIMIT))),
+                      output);
+
+      Store(this->last_out_ + i,
+            Select(And(OK, Finite(output)), output,
+                   Load(this->last_out_ + i)));
+    }
+
+    memcpy(out.data(), this->last_out_, sizeof(float) * N);
+  }
+
+ private:
+  static std::array<float, N> DCutoff(const std::array<PID::Param, N> &param) {
+    std::array<float, N> cutoff;
+    for (size_t i = 0; i < N; i++) {
+      cutoff[i] = param[i].d_cutoff_freq;
+    }
+    return cutoff;
+  }
+
+  float dt_min_; /* 最小Calculate调用间隔 */
+  bool any_cycle_ = false;
+
+  float k_[LANES];
+  float p_[LANES];
+  float i_gain_[LANES];
+  float d_[LANES];
+  float i_limit_[LANES];
+  float out_limit_[LANES];
+  bool cycle_[LANES] = {};
+
+  float i_[LANES];         /* 积分 */
+  float last_k_fb_[LANES]; /* 上次反馈值 */
+  float last_out_[LANES];  /* 上次输出 */
+
+  LowPassFilter2pBank<N> dfilter_;
+};
+
+/* 定点PID，与PID::Calculate(sp, fb, 1 / sample_freq)结果一致。
+   输入输出归一化到[-1, 1)，限幅和积分上限使用相同的单位。
+   cycle为真时sp和fb为以pi为单位的角度，误差自然回绕到[-1, 1) */
+template <typename T>
+class PIDFixed {
+ public:
+  typedef typename T::Acc Acc;
+
+  static constexpr int FRAC = T::FRAC;
+  static constexpr int STATE_FRAC = LowPassFilter2pFixed<T>::STATE_FRAC;
+  static constexpr int INT_EXTRA = 16; /* 积分额外保留的小数位数 */
+  static constexpr int INT_FRAC = FRAC + INT_EXTRA;
+
+  PIDFixed(PID::Param &param, float sample_freq)
+      : param_(param),
+        sample_freq_(sample_freq),
+        dfilter_(sample_freq, param.d_cutoff_freq) {
+    ASSERT(std::isfinite(1.0f / sample_freq));
+
+    this->Update();
+    this->Reset();
+  }
+
+  void SetK(float k) {
+    this->param_.k = k;
+    this->Update();
+  }
+
+  void SetP(float p) {
+    this->param_.p = p;
+    this->Update();
+  }
+
+  void SetI(float i) {
+    this->param_.i = i;
+    this->Update();
+  }
+
+  void SetD(float d) {
+    this->param_.d = d;
+    this->Update();
+  }
+
+  void Reset() {
+    this->i_ = 0;
+    this->last_fb_ = 0;
+    this->last_out_ = T();
+    this->dfilter_.Reset(T());
+  }
+
+  T Calculate(T sp, T fb) {
+    /* 计算误差值 */
+    Acc err = 0;
+    if (this->param_.cycle) {
+      err = (CycleValueFixed<T>::FromRaw(sp.raw_) -
+             CycleValueFixed<T>::FromRaw(fb.raw_))
+                .raw_;
+    } else {
+      err = static_cast<Acc>(sp.raw_) - fb.raw_;
+    }
+
+    /* 计算D项，通过fb计算D，避免了由于sp变化导致err突变的问题 */
+    const Acc FILTERED_FB =
+        this->dfilter_.Step(LowPassFilter2pFixed<T>::ToState(fb));
+    const Acc D =
+        this->kd_.Apply(FILTERED_FB - this->last_fb_, STATE_FRAC, FRAC);
+    this->last_fb_ = FILTERED_FB;
+
+    /* 计算PD输出 */
+    Acc output = this->kp_.Apply(err, FRAC, FRAC) - D;
+
+    /* 计算I项，积分直接以输出为单位累加 */
+    const Acc I = this->i_ + this->ki_.Apply(err, FRAC, INT_FRAC);
+    const Acc I_OUT = fixed_shift(I, INT_EXTRA);
+
+    if (this->i_enable_) {
+      /* 检查是否饱和 */
+      if (Abs(output + I_OUT) <= this->out_limit_ &&
+          Abs(I) <= this->i_limit_) {
+        /* 未饱和，使用新积分 */
+        this->i_ = I;
+      }
+    }
+
+    /* 计算PID输出 */
+    output += I_OUT;
+
+    /* 限制输出 */
+    if (this->out_limit_enable_) {
+      if (output > this->out_limit_) {
+        output = this->out_limit_;
+      } else if (output < -this->out_limit_) {
+        output = -this->out_limit_;
+      }
+    }
+
+    this->last_out_ = T::Saturate(output);
+    return this->last_out_;
+  }
+
+ private:
+  static Acc Abs(Acc x) { return x < 0 ? -x : x; }
+
+  /* 只在初始化和修改参数时使用浮点运算 */
+  static Acc ToAcc(float x, int frac) {
+    const double MAX = static_cast<double>(static_cast<Acc>(1) << 62);
+    double val = static_cast<double>(x) * static_cast<double>(1ll << frac);
+    if (!(val < MAX)) {
+      val = MAX;
+    } else if (val < -MAX) {
+      val = -MAX;
+    }
+    return static_cast<Acc>(val);
+  }
+
+  void Update() {
+    this->kp_ = FixedGain(this->param_.k * this->param_.p);
+    this->ki_ = FixedGain(this->param_.k * this->param_.i / this->sample_freq_);
+    this->kd_ = FixedGain(this->param_.k * this->param_.d * this->sample_freq_);
+
+    /* 积分按输出单位保存，上限也乘以积分增益 */
+    this->i_enable_ = this->param_.i > PID_SIGMA;
+    this->i_limit_ = ToAcc(this->param_.i_limit * this->param_.i, INT_FRAC);
+    this->out_limit_enable_ = this->param_.out_limit > PID_SIGMA;
+    this->out_limit_ = ToAcc(this->param_.out_limit, FRAC);
+  }
+
+  PID::Param param_;
+  float sample_freq_;
+
+  FixedGain kp_; /* k * p */
+  FixedGain ki_; /* k * i * dt */
+  FixedGain kd_; /* k * d / dt */
+
+  bool i_enable_;
+  bool out_limit_enable_;
+  Acc i_limit_;
+  Acc out_limit_;
+
+  Acc i_;       /* 积分，INT_FRAC位小数 */
+  Acc last_fb_; /* 上次滤波后的反馈值 */
+  T last_out_;  /* 上次输出 */
+
+  LowPassFilter2pFixed<T> dfilter_;
+};
 }  // namespace Component
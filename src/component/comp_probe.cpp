@@ -0,0 +1,187 @@
+#include "comp_probe.hpp"
+
+#include "bsp_time.h"
+
+using namespace Component;
+
+std::array<Probe*, PROBE_MAX_NUM> Probe::list_;
+
+uint32_t Probe::num_ = 0;
+
+System::Term::Command<Probe*>* Probe::cmd_ = NULL;
+
+Probe::Probe(const char* name, uint32_t period_us)
+    : name_(name),
+      info_tp_((std::string("probe_") + name).c_str()) {
+  ASSERT(num_ < PROBE_MAX_NUM);
+
+  this->cycle_per_us_ = bsp_time_get_cycle_freq() / 1000000;
+  if (this->cycle_per_us_ == 0) {
+    this->cycle_per_us_ = 1;
+  }
+  this->period_ = period_us * this->cycle_per_us_;
+
+  memset(&this->latency_, 0, sizeof(this->latency_));
+  memset(&this->jitter_, 0, sizeof(this->jitter_));
+  memset(&this->exec_, 0, sizeof(this->exec_));
+
+  list_[num_++] = this;
+
+  /* 所有探针共用一个命令和发布定时器 */
+  if (cmd_ == NULL) {
+    cmd_ = new System::Term::Command<Probe*>(this, ShowCMD, "probe");
+    System::Timer::Create(PublishInfo, this, PROBE_INFO_CYCLE);
+  }
+}
+
+void Probe::Begin() {
+  uint32_t now = bsp_time_get_cycle();
+
+  if (this->reset_) {
+    this->Reset();
+  }
+
+  if (this->started_) {
+    uint32_t period = now - this->last_begin_;
+    this->period_sum_ += period;
+
+    this->Record(this->jitter_, period > this->period_
+                                    ? period - this->period_
+                                    : this->period_ - period);
+
+    /* 比预期早醒的按0计，落后超过一个周期时重新对齐，与SleepUntil一致 */
+    uint32_t latency = now - this->expect_;
+    if (static_cast<int32_t>(latency) < 0) {
+      latency = 0;
+    }
+    this->Record(this->latency_, latency);
+
+    if (latency > this->period_) {
+      this->expect_ = now;
+    }
+  } else {
+    this->expect_ = now;
+    this->started_ = true;
+  }
+
+  this->expect_ += this->period_;
+  this->last_begin_ = now;
+}
+
+void Probe::End() {
+  uint32_t exec = bsp_time_get_cycle() - this->last_begin_;
+
+  this->Record(this->exec_, exec);
+
+  if (exec > this->period_) {
+    this->overrun_++;
+  }
+}
+
+void Probe::Record(Histogram& hist, uint32_t cycle) {
+  uint32_t us = cycle / this->cycle_per_us_;
+
+  uint32_t index = us == 0 ? 0 : 32 - __builtin_clz(us);
+  if (index >= PROBE_BUCKET_NUM) {
+    index = PROBE_BUCKET_NUM - 1;
+  }
+
+  hist.bucket[index]++;
+  hist.sum += us;
+  hist.count++;
+  if (us > hist.max) {
+    hist.max = us;
+  }
+}
+
+void Probe::Reset() {
+  memset(&this->latency_, 0, sizeof(this->latency_));
+  memset(&this->jitter_, 0, sizeof(this->jitter_));
+  memset(&this->exec_, 0, sizeof(this->exec_));
+  this->period_sum_ = 0;
+  this->overrun_ = 0;
+  this->started_ = false;
+  this->reset_ = false;
+}
+
+void Probe::GetInfo(Info& info) {
+  /* 只读统计量，不加锁，个别值可能相差一个周期 */
+  info.period = this->jitter_.count == 0
+                    ? 0.0f
+                    : static_cast<float>(this->period_sum_) /
+                          static_cast<float>(this->cycle_per_us_) /
+                          static_cast<float>(this->jitter_.count);
+  info.exec_mean = this->exec_.count == 0
+                       ? 0.0f
+                       : static_cast<float>(this->exec_.sum) /
+                             static_cast<float>(this->exec_.count);
+  info.exec_max = this->exec_.max;
+  info.latency_max = this->latency_.max;
+  info.jitter_max = this->jitter_.max;
+  info.overrun = this->overrun_;
+}
+
+void Probe::PublishInfo(Probe* probe) {
+  (void)(probe);
+
+  for (uint32_t i = 0; i < num_; i++) {
+    Info info;
+    list_[i]->GetInfo(info);
+    list_[i]->info_tp_.Publish(info);
+  }
+}
+
+void Probe::PrintHistogram(const char* name, Histogram& hist) {
+  printf("%s", name);
+  for (uint32_t i = 0; i < PROBE_BUCKET_NUM; i++) {
+    printf("\t%u", static_cast<unsigned>(hist.bucket[i]));
+  }
+  printf("\r\n");
+}
+
+int Probe::ShowCMD(Probe* probe, int argc, char** argv) {
+  (void)(probe);
+
+  if (argc == 1) {
+    printf("名称\t\t周期\t平均执行\t最大执行\t最大延迟\t最大抖动\t超时\r\n");
+    for (uint32_t i = 0; i < num_; i++) {
+      Info info;
+      list_[i]->GetInfo(info);
+      printf("%-16s%.1f\t%.1f\t\t%u\t\t%u\t\t%u\t\t%u\r\n", list_[i]->name_,
+             info.period, info.exec_mean, static_cast<unsigned>(info.exec_max),
+             static_cast<unsigned>(info.latency_max),
+             static_cast<unsigned>(info.jitter_max),
+             static_cast<unsigned>(info.overrun));
+    }
+    printf("单位为微秒。probe [name] 显示直方图，probe reset 清空统计\r\n");
+  } else if (argc == 2 && strcmp(argv[1], "reset") == 0) {
+    /* 由探针所在线程在下一次Begin时清空 */
+    for (uint32_t i = 0; i < num_; i++) {
+      list_[i]->reset_ = true;
+    }
+  } else if (argc == 2) {
+    for (uint32_t i = 0; i < num_; i++) {
+      Probe* item = list_[i];
+      if (strcmp(argv[1], item->name_) != 0) {
+        continue;
+      }
+
+      printf("us<");
+      for (uint32_t j = 0; j < PROBE_BUCKET_NUM - 1; j++) {
+        printf("\t%u", 1U << j);
+      }
+      printf("\t-\r\n");
+      PrintHistogram("延迟", item->latency_);
+      PrintHistogram("抖动", item->jitter_);
+      PrintHistogram("执行", item->exec_);
+
+      return 0;
+    }
+
+    printf("找不到%s\r\n", argv[1]);
+  } else {
+    printf("命令错误\r\n");
+  }
+
+  return 0;
+}
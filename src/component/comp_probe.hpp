@@ -0,0 +1,87 @@
+/*
+  控制循环计时探针。
+*/
+
+#pragma once
+
+#include <component.hpp>
+
+#define PROBE_MAX_NUM (16)    /* 探针数量上限 */
+#define PROBE_BUCKET_NUM (16) /* 第i个桶统计[2^(i-1), 2^i)微秒，最后一个桶不设上限 */
+#define PROBE_INFO_CYCLE (1000) /* 统计信息的发布周期(ms) */
+
+namespace Component {
+/* 每次唤醒后调用Begin，本次计算结束后调用End，
+   统计唤醒延迟、周期抖动和执行时间，只能在一个线程中使用 */
+class Probe {
+ public:
+  typedef struct {
+    std::array<uint32_t, PROBE_BUCKET_NUM> bucket;
+    uint32_t max; /* 微秒 */
+    uint64_t sum;
+    uint32_t count;
+  } Histogram;
+
+  /* 发布到probe_<name>话题，时间单位为微秒 */
+  typedef struct {
+    float period;
+    float exec_mean;
+    uint32_t exec_max;
+    uint32_t latency_max;
+    uint32_t jitter_max;
+    uint32_t overrun; /* 执行时间超过周期的次数 */
+  } Info;
+
+  /* 构造时调用Begin，析构时调用End */
+  class Scope {
+   public:
+    explicit Scope(Probe& probe) : probe_(probe) { probe_.Begin(); }
+
+    ~Scope() { probe_.End(); }
+
+   private:
+    Probe& probe_;
+  };
+
+  Probe(const char* name, uint32_t period_us);
+
+  void Begin();
+
+  void End();
+
+  void GetInfo(Info& info);
+
+  static int ShowCMD(Probe* probe, int argc, char** argv);
+
+ private:
+  void Record(Histogram& hist, uint32_t cycle);
+
+  void Reset();
+
+  static void PrintHistogram(const char* name, Histogram& hist);
+
+  static void PublishInfo(Probe* probe);
+
+  const char* name_;
+
+  uint32_t period_; /* 计数器周期数 */
+  uint32_t cycle_per_us_;
+
+  uint32_t last_begin_ = 0;
+  uint32_t expect_ = 0;
+  uint64_t period_sum_ = 0;
+  uint32_t overrun_ = 0;
+  bool started_ = false;
+  bool reset_ = false;
+
+  Histogram latency_;
+  Histogram jitter_;
+  Histogram exec_;
+
+  Message::Topic<Info> info_tp_;
+
+  static std::array<Probe*, PROBE_MAX_NUM> list_;
+  static uint32_t num_;
+  static System::Term::Command<Probe*>* cmd_;
+};
+}  // namespace Component
@@ -0,0 +1,187 @@
+/*
+  单精度向量运算。
+*/
+
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define COMP_SIMD_SSE
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define COMP_SIMD_NEON
+#endif
+
+namespace Component {
+namespace SIMD {
+/* x86使用SSE2，aarch64使用NEON，每次计算4个通道。其他平台（包括Cortex-M4）
+   没有浮点向量指令，宽度为1，退化为逐通道的标量计算。
+   有限值判断直接检查指数位，开启-ffast-math时依然有效 */
+#if defined(COMP_SIMD_SSE)
+static constexpr size_t WIDTH = 4;
+
+typedef __m128 Vector;
+typedef __m128 Mask;
+
+static inline Vector Load(const float *src) { return _mm_loadu_ps(src); }
+
+static inline void Store(float *dst, Vector x) { _mm_storeu_ps(dst, x); }
+
+static inline Vector Set(float x) { return _mm_set1_ps(x); }
+
+static inline Vector Add(Vector a, Vector b) { return _mm_add_ps(a, b); }
+
+static inline Vector Sub(Vector a, Vector b) { return _mm_sub_ps(a, b); }
+
+static inline Vector Mul(Vector a, Vector b) { return _mm_mul_ps(a, b); }
+
+static inline Vector Div(Vector a, Vector b) { return _mm_div_ps(a, b); }
+
+static inline Vector Max(Vector a, Vector b) { return _mm_max_ps(a, b); }
+
+static inline Vector Min(Vector a, Vector b) { return _mm_min_ps(a, b); }
+
+static inline Vector Abs(Vector x) {
+  return _mm_and_ps(x, _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff)));
+}
+
+static inline Mask LessEqual(Vector a, Vector b) { return _mm_cmple_ps(a, b); }
+
+static inline Mask Greater(Vector a, Vector b) { return _mm_cmpgt_ps(a, b); }
+
+static inline Mask And(Mask a, Mask b) { return _mm_and_ps(a, b); }
+
+static inline Mask True() { return _mm_castsi128_ps(_mm_set1_epi32(-1)); }
+
+static inline Mask Finite(Vector x) {
+  __m128i exp =
+      _mm_and_si128(_mm_castps_si128(x), _mm_set1_epi32(0x7f800000));
+  __m128i bad = _mm_cmpeq_epi32(exp, _mm_set1_epi32(0x7f800000));
+  return _mm_andnot_ps(_mm_castsi128_ps(bad), True());
+}
+
+static inline Mask Inf(Vector x) {
+  __m128i abs =
+      _mm_and_si128(_mm_castps_si128(x), _mm_set1_epi32(0x7fffffff));
+  return _mm_castsi128_ps(_mm_cmpeq_epi32(abs, _mm_set1_epi32(0x7f800000)));
+}
+
+/* mask为真的通道取a，否则取b */
+static inline Vector Select(Mask mask, Vector a, Vector b) {
+  return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+#elif defined(COMP_SIMD_NEON)
+static constexpr size_t WIDTH = 4;
+
+typedef float32x4_t Vector;
+typedef uint32x4_t Mask;
+
+static inline Vector Load(const float *src) { return vld1q_f32(src); }
+
+static inline void Store(float *dst, Vector x) { vst1q_f32(dst, x); }
+
+static inline Vector Set(float x) { return vdupq_n_f32(x); }
+
+static inline Vector Add(Vector a, Vector b) { return vaddq_f32(a, b); }
+
+static inline Vector Sub(Vector a, Vector b) { return vsubq_f32(a, b); }
+
+static inline Vector Mul(Vector a, Vector b) { return vmulq_f32(a, b); }
+
+static inline Vector Div(Vector a, Vector b) { return vdivq_f32(a, b); }
+
+static inline Vector Max(Vector a, Vector b) { return vmaxq_f32(a, b); }
+
+static inline Vector Min(Vector a, Vector b) { return vminq_f32(a, b); }
+
+static inline Vector Abs(Vector x) { return vabsq_f32(x); }
+
+static inline Mask LessEqual(Vector a, Vector b) { return vcleq_f32(a, b); }
+
+static inline Mask Greater(Vector a, Vector b) { return vcgtq_f32(a, b); }
+
+static inline Mask And(Mask a, Mask b) { return vandq_u32(a, b); }
+
+static inline Mask True() { return vdupq_n_u32(0xffffffff); }
+
+static inline Mask Finite(Vector x) {
+  uint32x4_t exp =
+      vandq_u32(vreinterpretq_u32_f32(x), vdupq_n_u32(0x7f800000));
+  return vmvnq_u32(vceqq_u32(exp, vdupq_n_u32(0x7f800000)));
+}
+
+static inline Mask Inf(Vector x) {
+  uint32x4_t abs =
+      vandq_u32(vreinterpretq_u32_f32(x), vdupq_n_u32(0x7fffffff));
+  return vceqq_u32(abs, vdupq_n_u32(0x7f800000));
+}
+
+/* mask为真的通道取a，否则取b */
+static inline Vector Select(Mask mask, Vector a, Vector b) {
+  return vbslq_f32(mask, a, b);
+}
+#else
+static constexpr size_t WIDTH = 1;
+
+typedef float Vector;
+typedef bool Mask;
+
+static inline uint32_t Bits(float x) {
+  uint32_t bits = 0;
+  memcpy(&bits, &x, sizeof(bits));
+  return bits;
+}
+
+static inline Vector Load(const float *src) { return *src; }
+
+static inline void Store(float *dst, Vector x) { *dst = x; }
+
+static inline Vector Set(float x) { return x; }
+
+static inline Vector Add(Vector a, Vector b) { return a + b; }
+
+static inline Vector Sub(Vector a, Vector b) { return a - b; }
+
+static inline Vector Mul(Vector a, Vector b) { return a * b; }
+
+static inline Vector Div(Vector a, Vector b) { return a / b; }
+
+static inline Vector Max(Vector a, Vector b) { return a > b ? a : b; }
+
+static inline Vector Min(Vector a, Vector b) { return a < b ? a : b; }
+
+static inline Vector Abs(Vector x) { return fabsf(x); }
+
+static inline Mask LessEqual(Vector a, Vector b) { return a <= b; }
+
+static inline Mask Greater(Vector a, Vector b) { return a > b; }
+
+static inline Mask And(Mask a, Mask b) { return a && b; }
+
+static inline Mask True() { return true; }
+
+static inline Mask Finite(Vector x) {
+  return (Bits(x) & 0x7f800000) != 0x7f800000;
+}
+
+static inline Mask Inf(Vector x) {
+  return (Bits(x) & 0x7fffffff) == 0x7f800000;
+}
+
+/* mask为真时取a，否则取b */
+static inline Vector Select(Mask mask, Vector a, Vector b) {
+  return mask ? a : b;
+}
+#endif
+
+/* 按向量宽度对齐后的通道数 */
+static constexpr size_t Lanes(size_t num) {
+  return (num + WIDTH - 1) / WIDTH * WIDTH;
+}
+}  // namespace SIMD
+}  // namespace Component
@@ -0,0 +1,26 @@
+#include "comp_snapshot.hpp"
+
+using namespace Component;
+
+SnapshotBase* SnapshotBase::list_ = NULL;
+
+SnapshotBase::SnapshotBase(const char* name, size_t size)
+    : name_(name), size_(size) {
+  ASSERT(Find(name, size) == NULL);
+
+  this->next_ = list_;
+  list_ = this;
+}
+
+SnapshotBase* SnapshotBase::Find(const char* name, size_t size) {
+  (void)(size);
+
+  for (SnapshotBase* item = list_; item != NULL; item = item->next_) {
+    if (strcmp(item->name_, name) == 0) {
+      ASSERT(item->size_ == size);
+      return item;
+    }
+  }
+
+  return NULL;
+}
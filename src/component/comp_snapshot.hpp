@@ -0,0 +1,93 @@
+/*
+  版本化快照，用于多个线程低频读取较大的话题数据。
+*/
+
+#pragma once
+
+#include <atomic>
+#include <component.hpp>
+
+namespace Component {
+class SnapshotBase {
+ public:
+  SnapshotBase(const char* name, size_t size);
+
+  static SnapshotBase* Find(const char* name, size_t size);
+
+  const char* name_;
+  size_t size_;
+  SnapshotBase* next_ = NULL;
+
+  /* 奇数表示正在写入 */
+  std::atomic<uint32_t> seq_{0};
+
+ private:
+  static SnapshotBase* list_;
+};
+
+/* 单写者seqlock，写者不会阻塞。读者在版本号不变时直接跳过，
+   否则在原位取出需要的字段，被写者打断时放弃本次读取 */
+template <typename Data>
+class Snapshot : public SnapshotBase {
+ public:
+  class Reader {
+   public:
+    explicit Reader(const char* name) : name_(name) {}
+
+    /* 快照有更新时调用fun(data, out)取出需要的字段，成功返回true。
+       fun在out的副本上运行，读取失败时out保持不变，下次调用时重试 */
+    template <typename Out, typename Fun>
+    bool Read(Out& out, Fun fun) {
+      if (this->snapshot_ == NULL) {
+        this->snapshot_ = static_cast<Snapshot<Data>*>(
+            SnapshotBase::Find(this->name_, sizeof(Data)));
+        if (this->snapshot_ == NULL) {
+          return false;
+        }
+      }
+
+      uint32_t seq = this->snapshot_->seq_.load(std::memory_order_acquire);
+      if (seq == this->version_ || (seq & 1)) {
+        return false;
+      }
+
+      Out tmp = out;
+      fun(this->snapshot_->data_, tmp);
+
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (this->snapshot_->seq_.load(std::memory_order_relaxed) != seq) {
+        return false;
+      }
+
+      out = tmp;
+      this->version_ = seq;
+
+      return true;
+    }
+
+   private:
+    const char* name_;
+    Snapshot<Data>* snapshot_ = NULL;
+    uint32_t version_ = 0;
+  };
+
+  explicit Snapshot(const char* name) : SnapshotBase(name, sizeof(Data)) {}
+
+  /* 只能在一个线程中调用 */
+  void Write(const Data& data) {
+    uint32_t seq = this->seq_.load(std::memory_order_relaxed);
+
+    this->seq_.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    memcpy(&this->data_, &data, sizeof(Data));
+
+    this->seq_.store(seq + 2, std::memory_order_release);
+  }
+
+  uint32_t Version() { return this->seq_.load(std::memory_order_acquire); }
+
+ private:
+  Data data_;
+};
+}  // namespace Component
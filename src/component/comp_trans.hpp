@@ -19,12 +19,10 @@ class Trans {
 
     float r3[3][3] = {{1, 0, 0}, {0, 1, 0}, {0, 0, 1}};
 
-    float cy = cosf(eulr.yaw);
-    float sy = sinf(eulr.yaw);
-    float cp = cosf(-eulr.pit);
-    float sp = sinf(-eulr.pit);
-    float cr = cosf(eulr.rol);
-    float sr = sinf(eulr.rol);
+    float cy = 0.0f, sy = 0.0f, cp = 0.0f, sp = 0.0f, cr = 0.0f, sr = 0.0f;
+    FastMath::SinCos(eulr.yaw, &sy, &cy);
+    FastMath::SinCos(-eulr.pit, &sp, &cp);
+    FastMath::SinCos(eulr.rol, &sr, &cr);
 
     r1[0][0] = cp;
     r1[0][2] = sp;
@@ -0,0 +1,47 @@
+#include "comp_trigger.hpp"
+
+using namespace Component;
+
+Trigger::Trigger(const char* topic) : sem_(false) {
+  om_topic_t* om_topic =
+      static_cast<om_topic_t*>(Message::Topic<uint8_t>::Find(topic));
+  ASSERT(om_topic != NULL);
+
+  if (om_topic != NULL) {
+    om_config_topic(om_topic, "d", Callback, this);
+  }
+}
+
+om_status_t Trigger::Callback(om_msg_t* msg, void* arg) {
+  (void)(msg);
+
+  Trigger* trigger = static_cast<Trigger*>(arg);
+
+  trigger->seq_.fetch_add(1, std::memory_order_release);
+  trigger->sem_.Give();
+
+  return OM_OK;
+}
+
+void Trigger::Clear() {
+  this->sem_.Take(0);
+  this->last_ = this->Sequence();
+}
+
+bool Trigger::Wait(uint32_t timeout) {
+  uint32_t seq = this->Sequence();
+
+  if (seq == this->last_) {
+    if (!this->sem_.Take(timeout)) {
+      return false;
+    }
+    seq = this->Sequence();
+  } else {
+    /* 清除已经处理过的更新留下的信号 */
+    this->sem_.Take(0);
+  }
+
+  this->last_ = seq;
+
+  return true;
+}
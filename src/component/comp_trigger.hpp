@@ -0,0 +1,34 @@
+/*
+  话题更新触发。
+*/
+
+#pragma once
+
+#include <atomic>
+#include <component.hpp>
+
+namespace Component {
+/* 阻塞等待话题被发布，每次发布序号加一。
+   回调中使用Give释放信号量，不能用于在中断中发布的话题 */
+class Trigger {
+ public:
+  /* 话题必须已经创建 */
+  explicit Trigger(const char* topic);
+
+  /* 上次返回后有新数据时立即返回true，否则等待timeout毫秒，超时返回false */
+  bool Wait(uint32_t timeout);
+
+  /* 丢弃之前的发布，之后的Wait只在新发布时返回true */
+  void Clear();
+
+  uint32_t Sequence() { return this->seq_.load(std::memory_order_acquire); }
+
+ private:
+  static om_status_t Callback(om_msg_t* msg, void* arg);
+
+  std::atomic<uint32_t> seq_{0};
+  uint32_t last_ = 0;
+
+  System::Semaphore sem_;
+};
+}  // namespace Component
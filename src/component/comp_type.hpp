@@ -5,6 +5,9 @@
 #pragma once
 
 #include <cmath>
+#include <cstdint>
+
+#include "comp_fast_math.hpp"
 
 #define M_DEG2RAD_MULT (0.01745329251f)
 #define M_RAD2DEG_MULT (57.2957795131f)
@@ -23,6 +26,78 @@
 
 namespace Component {
 namespace Type {
+/* 二进制角度，uint32_t的整个范围为一周，加减的回绕由整数溢出完成，
+   没有分支和取模。累加时也不会产生浮点误差 */
+class BinaryAngle {
+ public:
+  static constexpr float RAD_PER_LSB = M_2PI / 4294967296.0f;
+  static constexpr float LSB_PER_RAD = 4294967296.0f / M_2PI;
+
+  BinaryAngle() : raw_(0) {}
+
+  static BinaryAngle FromRaw(uint32_t raw) {
+    BinaryAngle ans;
+    ans.raw_ = raw;
+    return ans;
+  }
+
+  /* 任意弧度，超出一周的部分自然回绕 */
+  static BinaryAngle FromRadian(float value) {
+    return FromRaw(static_cast<uint32_t>(
+        static_cast<int64_t>(value * LSB_PER_RAD)));
+  }
+
+  /* 编码器读数，range为一周的计数，为常数时除法在编译期化简 */
+  static BinaryAngle FromFraction(uint32_t value, uint32_t range) {
+    return FromRaw(static_cast<uint32_t>(
+        (static_cast<uint64_t>(value) << 32) / range));
+  }
+
+  /* [0, 2pi)，只取高24位，保证结果小于M_2PI */
+  float Radian() const {
+    return static_cast<float>(this->raw_ >> 8) * (M_2PI / 16777216.0f);
+  }
+
+  /* 有符号的计数，[-pi, pi)对应[INT32_MIN, INT32_MAX] */
+  int32_t Signed() const { return static_cast<int32_t>(this->raw_); }
+
+  /* [-pi, pi) */
+  float SignedRadian() const {
+    return static_cast<float>(this->Signed() >> 8) *
+           (M_2PI / 16777216.0f);
+  }
+
+  BinaryAngle operator+(const BinaryAngle& value) const {
+    return FromRaw(this->raw_ + value.raw_);
+  }
+
+  BinaryAngle operator-(const BinaryAngle& value) const {
+    return FromRaw(this->raw_ - value.raw_);
+  }
+
+  BinaryAngle operator-() const { return FromRaw(0u - this->raw_); }
+
+  BinaryAngle& operator+=(const BinaryAngle& value) {
+    this->raw_ += value.raw_;
+    return *this;
+  }
+
+  BinaryAngle& operator-=(const BinaryAngle& value) {
+    this->raw_ -= value.raw_;
+    return *this;
+  }
+
+  bool operator==(const BinaryAngle& value) const {
+    return this->raw_ == value.raw_;
+  }
+
+  bool operator!=(const BinaryAngle& value) const {
+    return this->raw_ != value.raw_;
+  }
+
+  uint32_t raw_;
+};
+
 class CycleValue {
  public:
   static float Calculate(float value) {
@@ -48,6 +123,9 @@ class CycleValue {
     }
   }
 
+  /* BinaryAngle已经在[0, 2pi)内，不需要取模 */
+  CycleValue(const BinaryAngle& value) : value_(value.Radian()) {}
+
   CycleValue() = default;
 
   CycleValue operator+(const float& value) {
@@ -216,7 +294,7 @@ class Position2 {
   static float Distance(const Position2& source, const Position2& target) {
     float dx = source.x_ - target.x_;
     float dy = source.y_ - target.y_;
-    return sqrtf(dx * dx + dy * dy);
+    return FastMath::Sqrt(dx * dx + dy * dy);
   }
 
   Position2() = default;
@@ -224,10 +302,10 @@ class Position2 {
   Position2(float x, float y) : x_(x), y_(y) {}
 
   inline float GetLength() {
-    return sqrtf(this->x_ * this->x_ + this->y_ * this->y_);
+    return FastMath::Sqrt(this->x_ * this->x_ + this->y_ * this->y_);
   }
 
-  inline float GetAngle() { return atan2f(this->y_, this->x_); }
+  inline float GetAngle() { return FastMath::Atan2(this->y_, this->x_); }
 
   const Position2 operator+(const Position2& pos) {
     return Position2(pos.x_ + this->x_, pos.y_ + this->y_);
@@ -241,8 +319,9 @@ class Position2 {
 class Polar2 {
  public:
   operator Position2() {
-    return Position2(this->distance_ * cosf(this->angle_),
-                     this->distance_ * sinf(this->angle_));
+    float sin_angle = 0.0f, cos_angle = 0.0f;
+    FastMath::SinCos(this->angle_, &sin_angle, &cos_angle);
+    return Position2(this->distance_ * cos_angle, this->distance_ * sin_angle);
   }
 
   Polar2() = default;
@@ -292,14 +371,14 @@ class Line {
     float dy = this->end_.y_ - this->start_.y_;
     float dx = this->end_.x_ - this->start_.x_;
 
-    return sqrtf(dx * dx + dy * dy);
+    return FastMath::Sqrt(dx * dx + dy * dy);
   }
 
   float Angle() {
     float dy = this->end_.y_ - this->start_.y_;
     float dx = this->end_.x_ - this->start_.x_;
 
-    return atan2f(dy, dx);
+    return FastMath::Atan2(dy, dx);
   }
 
   Position2 start_, end_;
@@ -12,22 +12,7 @@
  * @param x 输入
  * @return float 计算结果
  */
-float inv_sqrtf(float x) {
-#if 0
-  /* Fast inverse square-root */
-  /* See: http://en.wikipedia.org/wiki/Fast_inverse_square_root */
-	float halfx = 0.5f * x;
-	float y = x;
-	long i = *(long*)&y;
-	i = 0x5f3759df - (i>>1);
-	y = *(float*)&i;
-	y = y * (1.5f - (halfx * y * y));
-	y = y * (1.5f - (halfx * y * y));
-	return y;
-#else
-  return 1.0f / sqrtf(x);
-#endif
-}
+float inv_sqrtf(float x) { return Component::FastMath::InvSqrt(x); }
 
 /**
  * @brief 将值限制在-limit和limit之间。
@@ -7,7 +7,6 @@
 
 #include "bsp_time.h"
 
-#define BETA_IMU (0.033f)
 using namespace Device;
 
 AHRS::AHRS()
@@ -16,7 +15,8 @@ AHRS::AHRS()
       cmd_(this, AHRS::ShowCMD, "AHRS", System::Term::DevDir()),
       accl_ready_(false),
       gyro_ready_(false),
-      ready_(false) {
+      ready_(false),
+      probe_("ahrs", 1000) {
   this->quat_.q0 = 1.0f;
   this->quat_.q1 = 0.0f;
   this->quat_.q2 = 0.0f;
@@ -109,98 +109,16 @@ int AHRS::ShowCMD(AHRS *ahrs, int argc, char **argv) {
   return 0;
 }
 
-static float recip_norm;
-static float s0, s1, s2, s3;
-static float q_dot1, q_dot2, q_dot3, q_dot4;
-static float q_2q0, q_2q1, q_2q2, q_2q3, q_4q0, q_4q1, q_4q2, q_8q1, q_8q2,
-    q0q0, q1q1, q2q2, q3q3;
-
 void AHRS::Update() {
+  Component::Probe::Scope probe(this->probe_);
+
   this->now_ = bsp_time_get();
 
   this->dt_ = this->now_ - this->last_update_;
   this->last_update_ = this->now_;
 
-  float ax = this->accl_.x;
-  float ay = this->accl_.y;
-  float az = this->accl_.z;
-
-  float gx = this->gyro_.x;
-  float gy = this->gyro_.y;
-  float gz = this->gyro_.z;
-
-  /* Rate of change of quaternion from gyroscope */
-  q_dot1 =
-      0.5f * (-this->quat_.q1 * gx - this->quat_.q2 * gy - this->quat_.q3 * gz);
-  q_dot2 =
-      0.5f * (this->quat_.q0 * gx + this->quat_.q2 * gz - this->quat_.q3 * gy);
-  q_dot3 =
-      0.5f * (this->quat_.q0 * gy - this->quat_.q1 * gz + this->quat_.q3 * gx);
-  q_dot4 =
-      0.5f * (this->quat_.q0 * gz + this->quat_.q1 * gy - this->quat_.q2 * gx);
-
-  /* Compute feedback only if accelerometer measurement valid (avoids NaN in
-   * accelerometer normalisation) */
-  if (!((ax == 0.0f) && (ay == 0.0f) && (az == 0.0f))) {
-    /* Normalise accelerometer measurement */
-    recip_norm = inv_sqrtf(ax * ax + ay * ay + az * az);
-    ax *= recip_norm;
-    ay *= recip_norm;
-    az *= recip_norm;
-
-    /* Auxiliary variables to avoid repeated arithmetic */
-    q_2q0 = 2.0f * this->quat_.q0;
-    q_2q1 = 2.0f * this->quat_.q1;
-    q_2q2 = 2.0f * this->quat_.q2;
-    q_2q3 = 2.0f * this->quat_.q3;
-    q_4q0 = 4.0f * this->quat_.q0;
-    q_4q1 = 4.0f * this->quat_.q1;
-    q_4q2 = 4.0f * this->quat_.q2;
-    q_8q1 = 8.0f * this->quat_.q1;
-    q_8q2 = 8.0f * this->quat_.q2;
-    q0q0 = this->quat_.q0 * this->quat_.q0;
-    q1q1 = this->quat_.q1 * this->quat_.q1;
-    q2q2 = this->quat_.q2 * this->quat_.q2;
-    q3q3 = this->quat_.q3 * this->quat_.q3;
-
-    /* Gradient decent algorithm corrective step */
-    s0 = q_4q0 * q2q2 + q_2q2 * ax + q_4q0 * q1q1 - q_2q1 * ay;
-    s1 = q_4q1 * q3q3 - q_2q3 * ax + 4.0f * q0q0 * this->quat_.q1 - q_2q0 * ay -
-         q_4q1 + q_8q1 * q1q1 + q_8q1 * q2q2 + q_4q1 * az;
-    s2 = 4.0f * q0q0 * this->quat_.q2 + q_2q0 * ax + q_4q2 * q3q3 - q_2q3 * ay -
-         q_4q2 + q_8q2 * q1q1 + q_8q2 * q2q2 + q_4q2 * az;
-    s3 = 4.0f * q1q1 * this->quat_.q3 - q_2q1 * ax +
-         4.0f * q2q2 * this->quat_.q3 - q_2q2 * ay;
-
-    /* normalise step magnitude */
-    recip_norm = inv_sqrtf(s0 * s0 + s1 * s1 + s2 * s2 + s3 * s3);
-
-    s0 *= recip_norm;
-    s1 *= recip_norm;
-    s2 *= recip_norm;
-    s3 *= recip_norm;
-
-    /* Apply feedback step */
-    q_dot1 -= BETA_IMU * s0;
-    q_dot2 -= BETA_IMU * s1;
-    q_dot3 -= BETA_IMU * s2;
-    q_dot4 -= BETA_IMU * s3;
-  }
-
-  /* Integrate rate of change of quaternion to yield quaternion */
-  this->quat_.q0 += q_dot1 * this->dt_;
-  this->quat_.q1 += q_dot2 * this->dt_;
-  this->quat_.q2 += q_dot3 * this->dt_;
-  this->quat_.q3 += q_dot4 * this->dt_;
-
-  /* Normalise quaternion */
-  recip_norm = inv_sqrtf(
-      this->quat_.q0 * this->quat_.q0 + this->quat_.q1 * this->quat_.q1 +
-      this->quat_.q2 * this->quat_.q2 + this->quat_.q3 * this->quat_.q3);
-  this->quat_.q0 *= recip_norm;
-  this->quat_.q1 *= recip_norm;
-  this->quat_.q2 *= recip_norm;
-  this->quat_.q3 *= recip_norm;
+  Component::Madgwick::Update(this->quat_, this->accl_, this->gyro_,
+                              this->dt_);
 }
 
 void AHRS::GetEulr() {
@@ -208,7 +126,7 @@ void AHRS::GetEulr() {
                                   this->quat_.q2 * this->quat_.q3);
   const float COSR_COSP = 1.0f - 2.0f * (this->quat_.q1 * this->quat_.q1 +
                                          this->quat_.q2 * this->quat_.q2);
-  this->eulr_.pit = atan2f(SINR_COSP, COSR_COSP);
+  this->eulr_.pit = Component::FastMath::Atan2(SINR_COSP, COSR_COSP);
 
   const float SINP = 2.0f * (this->quat_.q0 * this->quat_.q2 -
                              this->quat_.q3 * this->quat_.q1);
@@ -216,12 +134,12 @@ void AHRS::GetEulr() {
   if (fabsf(SINP) >= 1.0f) {
     this->eulr_.rol = copysignf(M_PI / 2.0f, SINP);
   } else {
-    this->eulr_.rol = asinf(SINP);
+    this->eulr_.rol = Component::FastMath::Asin(SINP);
   }
 
   const float SINY_COSP = 2.0f * (this->quat_.q0 * this->quat_.q3 +
                                   this->quat_.q1 * this->quat_.q2);
   const float COSY_COSP = 1.0f - 2.0f * (this->quat_.q2 * this->quat_.q2 +
                                          this->quat_.q3 * this->quat_.q3);
-  this->eulr_.yaw = atan2f(SINY_COSP, COSY_COSP);
+  this->eulr_.yaw = Component::FastMath::Atan2(SINY_COSP, COSY_COSP);
 }
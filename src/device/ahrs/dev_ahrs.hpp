@@ -7,6 +7,9 @@
 
 #include <device.hpp>
 
+#include "comp_ahrs.hpp"
+#include "comp_probe.hpp"
+
 namespace Device {
 class AHRS {
  public:
@@ -40,5 +43,7 @@ class AHRS {
   System::Semaphore accl_ready_;
   System::Semaphore gyro_ready_;
   System::Semaphore ready_;
+
+  Component::Probe probe_;
 };
 }  // namespace Device
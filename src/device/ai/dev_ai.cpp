@@ -31,7 +31,7 @@ AI::AI() : data_ready_(false), cmd_tp_("cmd_ai") {
 
   auto ai_thread = [](AI *ai) {
     auto quat_sub = Message::Subscriber("imu_quat", ai->quat_);
-    Message::Subscriber ref_sub("referee", ai->raw_ref_);
+    Component::Snapshot<Device::Referee::Data>::Reader ref_snap("referee");
 
     while (1) {
       /* 接收指令 */
@@ -50,8 +50,7 @@ AI::AI() : data_ready_(false), cmd_tp_("cmd_ai") {
       quat_sub.DumpData();
       ai->PackMCU();
 
-      if (ref_sub.DumpData()) {
-        ai->PraseRef();
+      if (ref_snap.Read(ai->ref_, AI::PraseRef)) {
         ai->PackRef();
       }
 
@@ -149,66 +148,65 @@ bool AI::PackCMD() {
   return true;
 }
 
-void AI::PraseRef() {
+void AI::PraseRef(const Device::Referee::Data &raw_ref, RefForAI &ref) {
 #if RB_HERO
-  this->ref_.ball_speed = this->ref_.data_.robot_status.launcher_42_speed_limit;
+  ref.ball_speed = raw_ref.robot_status.launcher_42_speed_limit;
 #else
-  this->ref_.ball_speed =
-      this->raw_ref_.robot_status.launcher_id1_17_speed_limit;
+  ref.ball_speed = raw_ref.robot_status.launcher_id1_17_speed_limit;
 #endif
 
-  this->ref_.max_hp = this->raw_ref_.robot_status.max_hp;
+  ref.max_hp = raw_ref.robot_status.max_hp;
 
-  this->ref_.hp = this->raw_ref_.robot_status.remain_hp;
+  ref.hp = raw_ref.robot_status.remain_hp;
 
-  if (this->raw_ref_.robot_status.robot_id < Referee::REF_BOT_BLU_HERO) {
-    this->ref_.team = AI_TEAM_RED;
+  if (raw_ref.robot_status.robot_id < Referee::REF_BOT_BLU_HERO) {
+    ref.team = AI_TEAM_RED;
   } else {
-    this->ref_.team = AI_TEAM_BLUE;
+    ref.team = AI_TEAM_BLUE;
   }
-  this->ref_.status = this->raw_ref_.status;
+  ref.status = raw_ref.status;
 
-  if (this->raw_ref_.rfid.high_ground == 1) {
-    this->ref_.robot_buff |= AI_RFID_SNIP;
-  } else if (this->raw_ref_.rfid.energy_mech == 1) {
-    this->ref_.robot_buff |= AI_RFID_BUFF;
+  if (raw_ref.rfid.high_ground == 1) {
+    ref.robot_buff |= AI_RFID_SNIP;
+  } else if (raw_ref.rfid.energy_mech == 1) {
+    ref.robot_buff |= AI_RFID_BUFF;
   } else {
-    this->ref_.robot_buff = 0;
+    ref.robot_buff = 0;
   }
-  switch (this->raw_ref_.game_status.game_type) {
+  switch (raw_ref.game_status.game_type) {
     case Referee::REF_GAME_TYPE_RMUC:
-      this->ref_.game_type = AI_RACE_RMUC;
+      ref.game_type = AI_RACE_RMUC;
       break;
     case Referee::REF_GAME_TYPE_RMUT:
-      this->ref_.game_type = AI_RACE_RMUT;
+      ref.game_type = AI_RACE_RMUT;
       break;
     case Referee::REF_GAME_TYPE_RMUL_3V3:
-      this->ref_.game_type = AI_RACE_RMUL3;
+      ref.game_type = AI_RACE_RMUL3;
       break;
     case Referee::REF_GAME_TYPE_RMUL_1V1:
-      this->ref_.game_type = AI_RACE_RMUL1;
+      ref.game_type = AI_RACE_RMUL1;
       break;
     default:
       return;
   }
 
-  switch (this->raw_ref_.robot_status.robot_id % 100) {
+  switch (raw_ref.robot_status.robot_id % 100) {
     case Referee::REF_BOT_RED_HERO:
-      this->ref_.robot_id = AI_ARM_HERO;
+      ref.robot_id = AI_ARM_HERO;
       break;
     case Referee::REF_BOT_RED_ENGINEER:
-      this->ref_.robot_id = AI_ARM_ENGINEER;
+      ref.robot_id = AI_ARM_ENGINEER;
       break;
     case Referee::REF_BOT_RED_DRONE:
-      this->ref_.robot_id = AI_ARM_DRONE;
+      ref.robot_id = AI_ARM_DRONE;
       break;
     case Referee::REF_BOT_RED_SENTRY:
-      this->ref_.robot_id = AI_ARM_SENTRY;
+      ref.robot_id = AI_ARM_SENTRY;
       break;
     case Referee::REF_BOT_RED_RADER:
-      this->ref_.robot_id = AI_ARM_RADAR;
+      ref.robot_id = AI_ARM_RADAR;
       break;
     default:
-      this->ref_.robot_id = AI_ARM_INFANTRY;
+      ref.robot_id = AI_ARM_INFANTRY;
   }
 }
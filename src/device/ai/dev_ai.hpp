@@ -46,7 +46,7 @@ class AI {
 
   bool PackRef();
 
-  void PraseRef();
+  static void PraseRef(const Device::Referee::Data &raw_ref, RefForAI &ref);
 
   bool PackCMD();
 
@@ -72,6 +72,5 @@ class AI {
   Component::CMD::Data cmd_;
 
   Component::Type::Quaternion quat_;
-  Device::Referee::Data raw_ref_;
 };
 }  // namespace Device
@@ -301,6 +301,8 @@ int BMI088::CaliCMD(BMI088 *bmi088, int argc, char **argv) {
 
       printf("保存校准数据\r\n");
 
+      System::Database::Sync();
+
       printf("完成\r\n");
     }
   } else if (argc == 4) {
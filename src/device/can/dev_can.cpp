@@ -3,6 +3,14 @@
 #include <array>
 
 #include "bsp_can.h"
+#include "bsp_time.h"
+#include "comp_executor.hpp"
+
+#define CAN_BIT_RATE (1000000) /* 总线波特率 */
+
+/* 8字节数据帧的平均位数，包含填充位 */
+#define CAN_STD_FRAME_BITS (130)
+#define CAN_EXT_FRAME_BITS (155)
 
 using namespace Device;
 
@@ -10,15 +18,58 @@ std::array<Message::Topic<Can::Pack>*, BSP_CAN_NUM> Can::can_tp_;
 
 std::array<System::Semaphore*, BSP_CAN_NUM> Can::can_sem_;
 
+std::array<Can::TxQueue, BSP_CAN_NUM> Can::tx_queue_;
+
+std::array<std::array<Can::TxSlot, CAN_TX_SLOT_NUM>, BSP_CAN_NUM>
+    Can::tx_slot_;
+
+std::array<std::atomic<uint32_t>, BSP_CAN_NUM> Can::tx_slot_num_;
+
+std::array<Can::TxStat, BSP_CAN_NUM> Can::tx_stat_;
+
+System::Semaphore* Can::flush_sem_;
+
+bool Can::tx_inline_ = false;
+
 static std::array<Can::Pack, BSP_CAN_NUM> pack;
 
-Can::Can() {
+/* 以下变量只在持有flush_sem_时使用 */
+static Can::TxQueue tx_batch;
+
+static std::array<uint32_t, BSP_CAN_NUM> tx_bits;
+
+static uint32_t last_stat_time;
+
+/* 接收分发表，只在初始化时写入 */
+static std::array<Message::Topic<Can::Pack>*, CAN_SUB_MAX_NUM> sub_list;
+
+static uint8_t sub_num;
+
+static std::array<std::array<uint8_t, CAN_STD_ID_NUM>, BSP_CAN_NUM> std_map;
+
+static std::array<std::array<Can::ExtMap, CAN_EXT_HASH_SIZE>, BSP_CAN_NUM>
+    ext_map;
+
+static std::array<uint32_t, BSP_CAN_NUM> ext_num;
+
+static std::array<std::array<Can::WideSub, CAN_WIDE_SUB_NUM>, BSP_CAN_NUM>
+    wide_sub;
+
+static std::array<uint8_t, BSP_CAN_NUM> wide_sub_num;
+
+static uint32_t ext_hash(uint32_t id) {
+  return (id * 2654435761u) >> 26 & (CAN_EXT_HASH_SIZE - 1);
+}
+
+Can::Can() : cmd_(this, Can::ShowCMD, "can", System::Term::DevDir()) {
   for (int i = 0; i < BSP_CAN_NUM; i++) {
     can_tp_[i] =
         new Message::Topic<Can::Pack>(("dev_can_" + std::to_string(i)).c_str());
     can_sem_[i] = new System::Semaphore(true);
   }
 
+  flush_sem_ = new System::Semaphore(true);
+
   auto rx_callback = [](bsp_can_t can, uint32_t id, uint8_t* data, void* arg) {
     (void)(arg);
 
@@ -27,6 +78,8 @@ Can::Can() {
     memcpy(pack[can].data, data, sizeof(pack[can].data));
 
     can_tp_[can]->PublishFromISR(pack[can]);
+
+    Dispatch(can, pack[can]);
   };
 
   for (int i = 0; i < BSP_CAN_NUM; i++) {
@@ -35,29 +88,337 @@ Can::Can() {
   }
 
   bsp_can_init();
+
+  /* 由执行器放在控制组的最后一步，本周期所有控制帧写入后统一发出。
+     没有执行器声明时使用独立线程按周期发送槽位，队列中的帧立即发出 */
+  tx_inline_ = Component::Executor::Find("can") == NULL;
+
+  auto can_init = [](Can* can) {
+    (void)(can);
+    last_stat_time = bsp_time_get_ms();
+  };
+
+  auto can_step = [](Can* can) {
+    (void)(can);
+    Flush();
+  };
+
+  Component::Executor::Register("can", DEVICE_CAN_TX_PERIOD, can_init,
+                                can_step, this, DEVICE_CAN_TASK_STACK_DEPTH,
+                                System::Thread::MEDIUM);
+}
+
+bool Can::SendStdPack(bsp_can_t can, Pack& pack, bool coalesce) {
+  return AddPack(can, pack, CAN_FORMAT_STD, coalesce);
+}
+
+bool Can::SendExtPack(bsp_can_t can, Pack& pack, bool coalesce) {
+  return AddPack(can, pack, CAN_FORMAT_EXT, coalesce);
 }
 
-bool Can::SendStdPack(bsp_can_t can, Pack& pack) {
+bool Can::AddPack(bsp_can_t can, Pack& pack, bsp_can_format_t format,
+                  bool coalesce) {
+  if (coalesce) {
+    return WriteSlot(can, pack, format);
+  }
+
+  bool ans = Enqueue(can, pack, format);
+
+  /* 队列满时不等下一个周期，发出已缓存的帧后重试 */
+  if (!ans && FlushNow(can)) {
+    ans = Enqueue(can, pack, format);
+  }
+
+  if (!ans) {
+    tx_stat_[can].dropped.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+
+  /* 没有执行器在控制周期末尾发送，不等待独立线程轮询 */
+  if (tx_inline_) {
+    FlushNow(can);
+  }
+
+  return true;
+}
+
+bool Can::Enqueue(bsp_can_t can, Pack& pack, bsp_can_format_t format) {
+  TxQueue& queue = tx_queue_[can];
+  TxStat& stat = tx_stat_[can];
+
   can_sem_[can]->Take(UINT32_MAX);
-  bool ans = bsp_can_trans_packet(can, CAN_FORMAT_STD, pack.index, pack.data) ==
-             BSP_OK;
+
+  if (queue.num >= CAN_TX_QUEUE_LEN) {
+    can_sem_[can]->Give();
+    return false;
+  }
+
+  TxPack& tx = queue.buff[queue.num++];
+  memcpy(&tx.pack, &pack, sizeof(pack));
+  tx.format = format;
+
+  if (queue.num > stat.max_depth) {
+    stat.max_depth = queue.num;
+  }
+
   can_sem_[can]->Give();
-  return ans;
+
+  return true;
 }
 
-bool Can::SendExtPack(bsp_can_t can, Pack& pack) {
+bool Can::FlushNow(bsp_can_t can) {
+  if (!flush_sem_->Take(CAN_TX_WAIT_MS)) {
+    return false;
+  }
+
+  FlushBus(can);
+
+  flush_sem_->Give();
+
+  return true;
+}
+
+bool Can::WriteSlot(bsp_can_t can, Pack& pack, bsp_can_format_t format) {
+  TxStat& stat = tx_stat_[can];
+  TxSlot* slot = NULL;
+
+  uint32_t num = tx_slot_num_[can].load(std::memory_order_acquire);
+  for (uint32_t i = 0; i < num; i++) {
+    TxPack& tx = tx_slot_[can][i].tx;
+    if (tx.pack.index == pack.index && tx.format == format) {
+      slot = &tx_slot_[can][i];
+      break;
+    }
+  }
+
+  /* 每个ID只在第一次发送时加锁分配槽位 */
+  if (slot == NULL) {
+    can_sem_[can]->Take(UINT32_MAX);
+
+    num = tx_slot_num_[can].load(std::memory_order_relaxed);
+    for (uint32_t i = 0; i < num; i++) {
+      TxPack& tx = tx_slot_[can][i].tx;
+      if (tx.pack.index == pack.index && tx.format == format) {
+        slot = &tx_slot_[can][i];
+        break;
+      }
+    }
+
+    if (slot == NULL && num < CAN_TX_SLOT_NUM) {
+      slot = &tx_slot_[can][num];
+      slot->tx.pack.index = pack.index;
+      slot->tx.format = format;
+      tx_slot_num_[can].store(num + 1, std::memory_order_release);
+    }
+
+    can_sem_[can]->Give();
+
+    if (slot == NULL) {
+      stat.dropped.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+  }
+
+  uint32_t seq = slot->seq.load(std::memory_order_relaxed);
+
+  slot->seq.store(seq + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  memcpy(slot->tx.pack.data, pack.data, sizeof(pack.data));
+
+  slot->seq.store(seq + 2, std::memory_order_release);
+
+  /* 上一帧还没有发出，被本帧覆盖 */
+  if (slot->dirty.exchange(true, std::memory_order_release)) {
+    stat.coalesced.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  return true;
+}
+
+void Can::Flush() {
+  flush_sem_->Take(UINT32_MAX);
+
+  for (int i = 0; i < BSP_CAN_NUM; i++) {
+    FlushBus(static_cast<bsp_can_t>(i));
+  }
+
+  flush_sem_->Give();
+}
+
+void Can::FlushBus(bsp_can_t can) {
+  TxStat& stat = tx_stat_[can];
+
   can_sem_[can]->Take(UINT32_MAX);
-  bool ans = bsp_can_trans_packet(can, CAN_FORMAT_EXT, pack.index, pack.data) ==
-             BSP_OK;
+  memcpy(&tx_batch, &tx_queue_[can], sizeof(tx_batch));
+  tx_queue_[can].num = 0;
   can_sem_[can]->Give();
-  return ans;
+
+  /* 正在写入的槽位保持dirty，写入完成后下次发送 */
+  uint32_t slot_num = tx_slot_num_[can].load(std::memory_order_acquire);
+  for (uint32_t i = 0; i < slot_num; i++) {
+    TxSlot& slot = tx_slot_[can][i];
+    if (!slot.dirty.exchange(false, std::memory_order_acquire)) {
+      continue;
+    }
+
+    uint32_t seq = slot.seq.load(std::memory_order_acquire);
+    if (seq & 1) {
+      continue;
+    }
+
+    TxPack tmp;
+    memcpy(&tmp, &slot.tx, sizeof(tmp));
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot.seq.load(std::memory_order_relaxed) != seq) {
+      continue;
+    }
+
+    if (tx_batch.num < CAN_TX_QUEUE_LEN) {
+      tx_batch.buff[tx_batch.num++] = tmp;
+    } else {
+      stat.dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+  /* 按ID排序，与总线仲裁顺序一致，同ID保持入队顺序 */
+  for (uint32_t i = 1; i < tx_batch.num; i++) {
+    TxPack tmp = tx_batch.buff[i];
+    uint32_t j = i;
+    while (j > 0 && tx_batch.buff[j - 1].pack.index > tmp.pack.index) {
+      tx_batch.buff[j] = tx_batch.buff[j - 1];
+      j--;
+    }
+    tx_batch.buff[j] = tmp;
+  }
+
+  /* bsp_can_trans_packet在三个发送邮箱都满时等待 */
+  for (uint32_t i = 0; i < tx_batch.num; i++) {
+    TxPack& tx = tx_batch.buff[i];
+    if (bsp_can_trans_packet(can, tx.format, tx.pack.index, tx.pack.data) ==
+        BSP_OK) {
+      stat.sent++;
+      tx_bits[can] += tx.format == CAN_FORMAT_STD ? CAN_STD_FRAME_BITS
+                                                  : CAN_EXT_FRAME_BITS;
+    } else {
+      stat.dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+  uint32_t now = bsp_time_get_ms();
+  if (now - last_stat_time >= 1000) {
+    for (int i = 0; i < BSP_CAN_NUM; i++) {
+      tx_stat_[i].load = static_cast<float>(tx_bits[i]) /
+                         static_cast<float>(CAN_BIT_RATE) * 1000.0f /
+                         static_cast<float>(now - last_stat_time);
+      tx_bits[i] = 0;
+    }
+    last_stat_time = now;
+  }
 }
 
 bool Can::Subscribe(Message::Topic<Can::Pack>& tp, bsp_can_t can,
                     uint32_t index, uint32_t num) {
   ASSERT(num > 0);
+  ASSERT(sub_num < CAN_SUB_MAX_NUM);
+
+  uint8_t sub = ++sub_num;
+  sub_list[sub - 1] = new Message::Topic<Can::Pack>(tp);
+
+  /* 同一个ID已经有订阅者时，通过Link转发 */
+  auto add_id = [&](uint8_t& slot) {
+    if (slot == 0) {
+      slot = sub;
+    } else {
+      tp.Link(*sub_list[slot - 1]);
+    }
+  };
+
+  if (index < CAN_STD_ID_NUM && num <= CAN_STD_ID_NUM - index) {
+    for (uint32_t i = index; i < index + num; i++) {
+      add_id(std_map[can][i]);
+    }
+
+    bsp_can_add_filter(can, CAN_FORMAT_STD, index, num);
+
+  } else if (index >= CAN_STD_ID_NUM && num <= CAN_EXT_RANGE_MAX) {
+    for (uint32_t i = index; i < index + num; i++) {
+      /* 保留空位，查找时遇到空位结束 */
+      ASSERT(ext_num[can] < CAN_EXT_HASH_SIZE - 1);
+
+      uint32_t pos = ext_hash(i);
+      while (ext_map[can][pos].sub != 0 && ext_map[can][pos].id != i) {
+        pos = (pos + 1) & (CAN_EXT_HASH_SIZE - 1);
+      }
+      if (ext_map[can][pos].sub == 0) {
+        ext_num[can]++;
+      }
+      ext_map[can][pos].id = i;
+      add_id(ext_map[can][pos].sub);
+    }
+
+    bsp_can_add_filter(can, CAN_FORMAT_EXT, index, num);
+
+  } else {
+    ASSERT(wide_sub_num[can] < CAN_WIDE_SUB_NUM);
+
+    WideSub& wide = wide_sub[can][wide_sub_num[can]++];
+    wide.index = index;
+    wide.num = num;
+    wide.sub = sub;
+
+    bsp_can_add_filter(can, CAN_FORMAT_EXT, index, num);
+  }
 
-  can_tp_[can]->RangeDivide(tp, sizeof(Pack), offsetof(Pack, index),
-                            om_member_size_of(Pack, index), index, num);
   return true;
 }
+
+void Can::Dispatch(bsp_can_t can, Pack& pack) {
+  uint8_t sub = 0;
+
+  if (pack.index < CAN_STD_ID_NUM) {
+    sub = std_map[can][pack.index];
+  } else {
+    uint32_t pos = ext_hash(pack.index);
+    while (ext_map[can][pos].sub != 0) {
+      if (ext_map[can][pos].id == pack.index) {
+        sub = ext_map[can][pos].sub;
+        break;
+      }
+      pos = (pos + 1) & (CAN_EXT_HASH_SIZE - 1);
+    }
+  }
+
+  if (sub != 0) {
+    sub_list[sub - 1]->PublishFromISR(pack);
+  }
+
+  for (uint8_t i = 0; i < wide_sub_num[can]; i++) {
+    WideSub& wide = wide_sub[can][i];
+    if (pack.index - wide.index < wide.num) {
+      sub_list[wide.sub - 1]->PublishFromISR(pack);
+    }
+  }
+}
+
+int Can::ShowCMD(Can* can, int argc, char** argv) {
+  (void)(can);
+  (void)(argv);
+
+  if (argc != 1) {
+    printf("命令错误。\r\n");
+    return 0;
+  }
+
+  for (int i = 0; i < BSP_CAN_NUM; i++) {
+    TxStat& stat = tx_stat_[i];
+    printf("CAN%d 负载:%.1f%% 队列深度:%d/%d 已发送:%d 丢弃:%d 合并:%d\r\n",
+           i + 1, stat.load * 100.0f, static_cast<int>(stat.max_depth),
+           CAN_TX_QUEUE_LEN, static_cast<int>(stat.sent),
+           static_cast<int>(stat.dropped.load()),
+           static_cast<int>(stat.coalesced.load()));
+  }
+
+  return 0;
+}
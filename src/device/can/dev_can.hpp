@@ -1,10 +1,21 @@
 #pragma once
 
+#include <atomic>
 #include <device.hpp>
 #include <semaphore.hpp>
 
 #include "bsp_can.h"
 
+#define CAN_TX_QUEUE_LEN (32) /* 每条总线每个周期最多缓存的帧数 */
+#define CAN_TX_SLOT_NUM (16)  /* 每条总线电机控制帧槽位数量 */
+#define CAN_TX_WAIT_MS (5)    /* 立即发送时等待发送权的最长时间 */
+
+#define CAN_STD_ID_NUM (0x800)  /* 标准帧ID数量，直接查表 */
+#define CAN_SUB_MAX_NUM (64)    /* 订阅者数量上限 */
+#define CAN_EXT_HASH_SIZE (64)  /* 扩展帧ID哈希表大小，必须为2的幂 */
+#define CAN_EXT_RANGE_MAX (16)  /* 超过该数量的扩展帧ID区间不再逐个登记 */
+#define CAN_WIDE_SUB_NUM (4)    /* 大范围订阅者数量上限 */
+
 namespace Device {
 class Can {
  public:
@@ -13,16 +24,86 @@ class Can {
     uint8_t data[8];  // NOLINT(modernize-avoid-c-arrays)
   } Pack;
 
+  typedef struct {
+    Pack pack;
+    bsp_can_format_t format;
+  } TxPack;
+
+  /* 每个ID一个槽位，只能由一个线程写入 */
+  typedef struct {
+    TxPack tx;
+    std::atomic<uint32_t> seq;  /* 奇数表示正在写入 */
+    std::atomic<bool> dirty;    /* 写入后还没有发送 */
+  } TxSlot;
+
+  typedef struct {
+    TxPack buff[CAN_TX_QUEUE_LEN];  // NOLINT(modernize-avoid-c-arrays)
+    uint32_t num;
+  } TxQueue;
+
+  typedef struct {
+    uint32_t id;
+    uint8_t sub; /* 订阅者序号加一，0表示空 */
+  } ExtMap;
+
+  typedef struct {
+    uint32_t index;
+    uint32_t num;
+    uint8_t sub;
+  } WideSub;
+
+  typedef struct {
+    uint32_t sent;                     /* 已发送帧数 */
+    std::atomic<uint32_t> dropped;     /* 队列满或发送失败丢弃的帧数 */
+    std::atomic<uint32_t> coalesced;   /* 被同ID新数据覆盖的帧数 */
+    uint32_t max_depth;                /* 队列深度最大值 */
+    float load;                        /* 最近一秒的总线负载率 */
+  } TxStat;
+
   Can();
 
-  static bool SendStdPack(bsp_can_t can, Pack& pack);
+  /* coalesce为true时写入该ID的槽位，不加锁，同一周期内的旧数据被覆盖；
+     否则进入发送队列，队列满时在调用线程中先发出已缓存的帧。
+     没有执行器声明"can"时，队列中的帧在调用线程中立即发出。
+     返回true表示已缓存或已发出，返回false表示丢弃 */
+  static bool SendStdPack(bsp_can_t can, Pack& pack, bool coalesce = false);
+
+  static bool SendExtPack(bsp_can_t can, Pack& pack, bool coalesce = false);
 
-  static bool SendExtPack(bsp_can_t can, Pack& pack);
+  /* 按ID顺序发出所有总线上缓存的帧，由执行器任务"can"调用 */
+  static void Flush();
 
+  /* ID小于0x800的按标准帧处理，其余按扩展帧处理 */
   static bool Subscribe(Message::Topic<Can::Pack>& tp, bsp_can_t can,
                         uint32_t index, uint32_t num);
 
+  static int ShowCMD(Can* can, int argc, char** argv);
+
   static std::array<Message::Topic<Can::Pack>*, BSP_CAN_NUM> can_tp_;
   static std::array<System::Semaphore*, BSP_CAN_NUM> can_sem_;
+
+ private:
+  static void Dispatch(bsp_can_t can, Pack& pack);
+
+  static bool AddPack(bsp_can_t can, Pack& pack, bsp_can_format_t format,
+                      bool coalesce);
+
+  static bool Enqueue(bsp_can_t can, Pack& pack, bsp_can_format_t format);
+
+  static bool FlushNow(bsp_can_t can);
+
+  static bool WriteSlot(bsp_can_t can, Pack& pack, bsp_can_format_t format);
+
+  static void FlushBus(bsp_can_t can);
+
+  static std::array<TxQueue, BSP_CAN_NUM> tx_queue_;
+  static std::array<std::array<TxSlot, CAN_TX_SLOT_NUM>, BSP_CAN_NUM>
+      tx_slot_;
+  static std::array<std::atomic<uint32_t>, BSP_CAN_NUM> tx_slot_num_;
+  static std::array<TxStat, BSP_CAN_NUM> tx_stat_;
+  static System::Semaphore* flush_sem_;
+  static bool tx_inline_;
+
+  System::Term::Command<Can*> cmd_;
 };
 }  // namespace Device
@@ -27,25 +27,23 @@ Cap::Cap(Cap::Param &param) : param_(param), info_tp_("cap_info") {
 
   Can::Subscribe(cap_tp, this->param_.can, this->param_.index, 1);
 
-  auto ref_cb = [](Device::Referee::Data &ref, Cap *cap) {
-    if (ref.status != Device::Referee::RUNNING) {
-      cap->out_.power_limit_ = 40.0f;
-    } else {
-      cap->out_.power_limit_ = ref.robot_status.chassis_power_limit;
-    }
-
-    clampf(&cap->out_.power_limit_, 20.0f, 100.0f);
+  auto cap_thread = [](Cap *cap) {
+    auto ref_cb = [](const Device::Referee::Data &ref, float &power_limit) {
+      if (ref.status != Device::Referee::RUNNING) {
+        power_limit = 40.0f;
+      } else {
+        power_limit = ref.robot_status.chassis_power_limit;
+      }
 
-    return true;
-  };
+      clampf(&power_limit, 20.0f, 100.0f);
+    };
 
-  Message::Topic<Device::Referee::Data>(
-      Message::Topic<Device::Referee::Data>::Find("referee"))
-      .RegisterCallback(ref_cb, this);
+    Component::Snapshot<Device::Referee::Data>::Reader ref_snap("referee");
 
-  auto cap_thread = [](Cap *cap) {
     while (1) {
       /* 读取裁判系统信息 */
+      ref_snap.Read(cap->out_.power_limit_, ref_cb);
+
       if (!cap->Update()) {
         /* 一定时间长度内接收不到电容反馈值，使电容离线 */
         cap->Offline();
@@ -68,7 +66,7 @@ Cap::Cap(Cap::Param &param) : param_(param), info_tp_("cap_info") {
 
 bool Cap::Update() {
   Can::Pack rx;
-  while (this->control_feedback_.Receive(rx, 0)) {
+  while (this->control_feedback_.Receive(rx)) {
     this->Decode(rx);
     this->info_.online_ = 1;
     this->last_online_time_ = bsp_time_get();
@@ -106,7 +104,8 @@ bool Cap::Control() {
   tx_buff.data[0] = (pwr_lim >> 8) & 0xFF;
   tx_buff.data[1] = pwr_lim & 0xFF;
 
-  return Can::SendStdPack(this->param_.can, tx_buff);
+  /* 功率限制只需要最新值 */
+  return Can::SendStdPack(this->param_.can, tx_buff, true);
 }
 
 bool Cap::Offline() {
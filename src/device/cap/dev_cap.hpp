@@ -37,6 +37,7 @@ class Cap {
 
   bool Update();
 
+  /* 返回true表示控制帧已放入CAN发送缓存，由Can::Flush发出 */
   bool Control();
 
   bool Offline();
@@ -54,7 +55,7 @@ class Cap {
 
   float last_online_time_ = 0.0f;
 
-  System::Queue<Can::Pack> control_feedback_ = System::Queue<Can::Pack>(1);
+  System::SpscQueue<Can::Pack, 1> control_feedback_;
 
   System::Thread thread_;
 
@@ -12,6 +12,7 @@
 #include <memory.hpp>
 #include <queue.hpp>
 #include <semaphore.hpp>
+#include <spsc_queue.hpp>
 #include <string>
 #include <term.hpp>
 #include <thread.hpp>
@@ -41,7 +41,7 @@ IMU::IMU(IMU::Param &param)
 
 void IMU::Update() {
   Can::Pack rx;
-  while (this->recv_.Receive(rx, 0)) {
+  while (this->recv_.Receive(rx)) {
     this->Decode(rx);
     this->online_ = true;
     this->last_online_time_ = bsp_time_get();
@@ -44,7 +44,7 @@ class IMU {
   Component::Type::Vector3 gyro_;
   Component::Type::Eulr eulr_;
 
-  System::Queue<Device::Can::Pack> recv_ = System::Queue<Can::Pack>(4);
+  System::SpscQueue<Device::Can::Pack, 4> recv_;
 
   System::Thread thread_;
 };
@@ -66,7 +66,7 @@ MitMotor::MitMotor(const Param &param, const char *name)
 bool MitMotor::Update() {
   Can::Pack pack;
 
-  while (this->recv_.Receive(pack, 0)) {
+  while (this->recv_.Receive(pack)) {
     this->Decode(pack);
     last_online_time_ = bsp_time_get();
   }
@@ -90,7 +90,8 @@ void MitMotor::Decode(Can::Pack &rx) {
   float current = uint_to_float(raw_current, -T_MAX, T_MAX, 12);
 
   this->feedback_.rotational_speed = speed;
-  this->feedback_.rotor_abs_angle = raw_pos_;
+  this->feedback_.rotor_abs_angle =
+      Component::Type::BinaryAngle::FromRadian(raw_pos_);
   this->feedback_.torque_current = current;
 }
 
@@ -156,7 +157,7 @@ void MitMotor::SetPos(float pos) {
   tx_buff.data[6] = ((kd_int & 0xF) << 4) | (t_int >> 8);
   tx_buff.data[7] = t_int & 0xff;
 
-  Can::SendStdPack(this->param_.can, tx_buff);
+  Can::SendStdPack(this->param_.can, tx_buff, true);
 }
 
 void MitMotor::Relax() {
@@ -41,7 +41,7 @@ class MitMotor : public BaseMotor {
 
   float current_ = 0.0f;
 
-  System::Queue<Can::Pack> recv_ = System::Queue<Can::Pack>(1);
+  System::SpscQueue<Can::Pack, 1> recv_;
 
   static std::array<Message::Topic<Can::Pack> *, BSP_CAN_NUM> mit_tp_;
 };
@@ -6,10 +6,10 @@ namespace Device {
 class BaseMotor {
  public:
   typedef struct {
-    Component::Type::CycleValue rotor_abs_angle; /* 转子绝对角度 单位：rad */
-    float rotational_speed;                      /* 转速 单位：rpm */
-    float torque_current;                        /* 转矩电流 单位：A*/
-    float temp;                                  /* 电机温度 单位：℃*/
+    Component::Type::BinaryAngle rotor_abs_angle; /* 转子绝对角度 */
+    float rotational_speed;                       /* 转速 单位：rpm */
+    float torque_current;                         /* 转矩电流 单位：A*/
+    float temp;                                   /* 电机温度 单位：℃*/
   } Feedback;
 
   BaseMotor(const char *name, bool reverse)
@@ -25,7 +25,9 @@ class BaseMotor {
 
   virtual void Relax() = 0;
 
-  Component::Type::CycleValue GetAngle() {
+  Component::Type::CycleValue GetAngle() { return this->GetBinaryAngle(); }
+
+  Component::Type::BinaryAngle GetBinaryAngle() {
     if (reverse_) {
       return -this->feedback_.rotor_abs_angle;
     } else {
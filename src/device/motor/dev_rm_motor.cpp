@@ -85,7 +85,7 @@ RMMotor::RMMotor(const Param &param, const char *name)
 bool RMMotor::Update() {
   Can::Pack pack;
 
-  while (this->recv_.Receive(pack, 0)) {
+  while (this->recv_.Receive(pack)) {
     if ((pack.index == this->param_.id_feedback) &&
         (MOTOR_NONE != this->param_.model)) {
       this->Decode(pack);
@@ -100,7 +100,7 @@ void RMMotor::Decode(Can::Pack &rx) {
   int16_t raw_current = static_cast<int16_t>((rx.data[4] << 8) | rx.data[5]);
 
   this->feedback_.rotor_abs_angle =
-      static_cast<float>(raw_angle) / MOTOR_ENC_RES * M_2PI;
+      Component::Type::BinaryAngle::FromFraction(raw_angle, MOTOR_ENC_RES);
   this->feedback_.rotational_speed =
       static_cast<int16_t>((rx.data[2] << 8) | rx.data[3]);
   this->feedback_.torque_current =
@@ -160,7 +160,7 @@ bool RMMotor::SendData() {
   memcpy(tx_buff.data, motor_tx_buff_[this->param_.can][this->index_],
          sizeof(tx_buff.data));
 
-  Can::SendStdPack(this->param_.can, tx_buff);
+  Can::SendStdPack(this->param_.can, tx_buff, true);
 
   motor_tx_flag_[this->param_.can][this->index_] = 0;
 
@@ -78,6 +78,6 @@ class RMMotor : public BaseMotor {
   // NOLINTNEXTLINE(modernize-avoid-c-arrays)
   static uint8_t motor_tx_map_[BSP_CAN_NUM][MOTOR_CTRL_ID_NUMBER];
 
-  System::Queue<Can::Pack> recv_ = System::Queue<Can::Pack>(1);
+  System::SpscQueue<Can::Pack, 1> recv_;
 };
 }  // namespace Device
@@ -43,7 +43,7 @@ RMDMotor::RMDMotor(const Param &param, const char *name)
 bool RMDMotor::Update() {
   Can::Pack pack;
 
-  while (this->recv_.Receive(pack, 0)) {
+  while (this->recv_.Receive(pack)) {
     this->Decode(pack);
   }
 
@@ -55,7 +55,7 @@ void RMDMotor::Decode(Can::Pack &rx) {
   int16_t raw_current = static_cast<int16_t>((rx.data[3] << 8) | rx.data[2]);
   float raw_speed = static_cast<int16_t>((rx.data[5] << 8) | rx.data[4]);
   this->feedback_.rotor_abs_angle =
-      static_cast<float>(raw_angle) / MOTOR_ENC_RES * M_2PI;
+      Component::Type::BinaryAngle::FromFraction(raw_angle, MOTOR_ENC_RES);
   this->feedback_.rotational_speed = raw_speed / 360.0f * 60.0f;
   this->feedback_.torque_current =
       static_cast<float>(raw_current) / MOTOR_CUR_RES;
@@ -99,7 +99,7 @@ bool RMDMotor::SendData() {
 
   memcpy(tx_buff.data, motor_tx_buff_[this->param_.can], sizeof(tx_buff.data));
 
-  Can::SendStdPack(this->param_.can, tx_buff);
+  Can::SendStdPack(this->param_.can, tx_buff, true);
 
   motor_tx_flag_[this->param_.can] = 0;
 
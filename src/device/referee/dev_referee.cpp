@@ -11,9 +11,12 @@
 #include "comp_crc8.hpp"
 
 #define REF_HEADER_SOF (0xA5)
-#define REF_LEN_RX_BUFF (0xFF)
+#define REF_LEN_RX_BUFF (0x200) /* 环形接收缓冲区，需大于100ms内的数据量 */
 #define REF_LEN_TX_BUFF (0xFF)
 
+/* 令牌桶容量，允许短时间内连续发送两个最大的数据包 */
+#define REF_UI_BUCKET_SIZE (2 * sizeof(Referee::UIElePack_7))
+
 #define REF_UI_BOX_UP_OFFSET (4)
 #define REF_UI_BOX_BOT_OFFSET (-14)
 
@@ -41,10 +44,16 @@ static uint8_t rxbuf[REF_LEN_RX_BUFF];
 Referee::UIPack Referee::ui_pack_;
 Referee *Referee::self_;
 
-Referee::Referee() {
+Referee::Referee()
+    : ui_cmd_(this, Referee::ShowUICMD, "ref_ui", System::Term::DevDir()) {
   self_ = this;
 
-  auto rx_cplt_callback = [](void *arg) {
+  memset(&this->ele_slot_, 0, sizeof(this->ele_slot_));
+  memset(&this->str_slot_, 0, sizeof(this->str_slot_));
+  memset(&this->ui_stat_, 0, sizeof(this->ui_stat_));
+
+  /* 环形DMA在半满、全满和空闲时都唤醒接收线程 */
+  auto rx_callback = [](void *arg) {
     Referee *ref = static_cast<Referee *>(arg);
     ref->raw_ready_.GiveFromISR();
   };
@@ -54,22 +63,20 @@ Referee::Referee() {
     ref->packet_sent_.GiveFromISR();
   };
 
-  auto idle_line_callback = [](void *arg) {
-    static_cast<void>(arg);
-    bsp_uart_abort_receive(BSP_UART_REF);
-  };
-
-  auto abort_rx_cplt_callback = [](void *arg) {
+  auto error_callback = [](void *arg) {
     Referee *ref = static_cast<Referee *>(arg);
+    ref->rx_error_ = true;
     ref->raw_ready_.GiveFromISR();
   };
 
-  bsp_uart_register_callback(BSP_UART_REF, BSP_UART_RX_CPLT_CB,
-                             rx_cplt_callback, this);
-  bsp_uart_register_callback(BSP_UART_REF, BSP_UART_ABORT_RX_CPLT_CB,
-                             abort_rx_cplt_callback, this);
-  bsp_uart_register_callback(BSP_UART_REF, BSP_UART_IDLE_LINE_CB,
-                             idle_line_callback, this);
+  bsp_uart_register_callback(BSP_UART_REF, BSP_UART_RX_HALF_CPLT_CB,
+                             rx_callback, this);
+  bsp_uart_register_callback(BSP_UART_REF, BSP_UART_RX_CPLT_CB, rx_callback,
+                             this);
+  bsp_uart_register_callback(BSP_UART_REF, BSP_UART_IDLE_LINE_CB, rx_callback,
+                             this);
+  bsp_uart_register_callback(BSP_UART_REF, BSP_UART_ERROR_CB, error_callback,
+                             this);
   bsp_uart_register_callback(BSP_UART_REF, BSP_UART_TX_CPLT_CB,
                              tx_cplt_callback, this);
 #if !UI_MODE_NONE
@@ -77,9 +84,9 @@ Referee::Referee() {
 #endif
 
   auto ref_recv_thread = [](Referee *ref) {
-    while (1) {
-      ref->StartRecv();
+    ref->StartRecv();
 
+    while (1) {
 #if REF_FORCE_ONLINE
       ref->raw_ready_.Take(100);
       ref->Prase();
@@ -91,8 +98,24 @@ Referee::Referee() {
       }
 #endif
 
-      /* 发布裁判系统数据 */
-      ref->ref_data_tp_.Publish(ref->ref_data_);
+      /* 出错后DMA已停止，重新开始接收 */
+      if (ref->rx_error_) {
+        ref->rx_error_ = false;
+        bsp_uart_abort_receive(BSP_UART_REF);
+        ref->StartRecv();
+      }
+
+      /* 数据有变化时才发布，updated标记出本次有变化的命令 */
+      if (ref->ref_data_.status != ref->last_status_) {
+        ref->dirty_ |= REF_UPDATE_STATUS;
+        ref->last_status_ = ref->ref_data_.status;
+      }
+      if (ref->dirty_ != 0) {
+        ref->ref_data_.updated = ref->dirty_;
+        ref->ref_data_snap_.Write(ref->ref_data_);
+        ref->ref_data_tp_.Publish(ref->ref_data_);
+        ref->dirty_ = 0;
+      }
     }
   };
 
@@ -102,7 +125,8 @@ Referee::Referee() {
   auto ref_trans_thread = [](Referee *ref) {
     while (1) {
       ref->UpdateUI();
-      ref->trans_thread_.SleepUntil(40);
+      /* 裁判系统限制UI数据包的发送频率 */
+      ref->trans_thread_.SleepUntil(1000 / UI_MAX_FREQ);
     }
   };
   this->trans_thread_.Create(ref_trans_thread, this, "ref_trans_thread",
@@ -113,147 +137,25 @@ Referee::Referee() {
 void Referee::Offline() { this->ref_data_.status = OFFLINE; }
 
 bool Referee::StartRecv() {
-  return bsp_uart_receive(BSP_UART_REF, rxbuf, REF_LEN_RX_BUFF, false) ==
+  this->read_pos_ = 0;
+  this->parse_state_ = REF_PARSE_SOF;
+
+  return bsp_uart_receive_circular(BSP_UART_REF, rxbuf, REF_LEN_RX_BUFF) ==
          BSP_OK;
 }
 
 void Referee::Prase() {
   this->ref_data_.status = RUNNING;
-  size_t data_length = bsp_uart_get_count(BSP_UART_REF);
-
-  const uint8_t *index = rxbuf; /* const 保护原始rxbuf不被修改 */
-  const uint8_t *const RXBUF_END = rxbuf + data_length;
-
-  while (index < RXBUF_END) {
-    /* 1.处理帧头 */
-    /* 1.1遍历所有找到SOF */
-    while ((*index != REF_HEADER_SOF) && (index < RXBUF_END)) {
-      index++;
-    }
-    /* 1.2将剩余数据当做帧头部 */
-    const Referee::Header *header =
-        reinterpret_cast<const Referee::Header *>(index);
-
-    /* 1.3验证完整性 */
-    if (!Component::CRC8::Verify(reinterpret_cast<const uint8_t *>(header),
-                                 sizeof(*header))) {
-      index++;
-      continue;
-    }
-    index += sizeof(*header);
-
-    /* 2.处理CMD ID */
-    /* 2.1将剩余数据当做CMD ID处理 */
-    const Referee::CMDID *cmd_id =
-        reinterpret_cast<const Referee::CMDID *>(index);
-    index += sizeof(*cmd_id);
-
-    /* 3.处理数据段 */
-    const void *source = index;
-    void *destination = NULL;
-    size_t size = 0;
-
-    switch (static_cast<int>(*cmd_id)) {
-      case REF_CMD_ID_GAME_STATUS:
-        destination = &(this->ref_data_.game_status);
-        size = sizeof(this->ref_data_.game_status);
-        break;
-      case REF_CMD_ID_GAME_RESULT:
-        destination = &(this->ref_data_.game_result);
-        size = sizeof(this->ref_data_.game_result);
-        break;
-      case REF_CMD_ID_GAME_ROBOT_HP:
-        destination = &(this->ref_data_.game_robot_hp);
-        size = sizeof(this->ref_data_.game_robot_hp);
-        break;
-      case REF_CMD_ID_DART_STATUS:
-        destination = &(this->ref_data_.dart_status);
-        size = sizeof(this->ref_data_.dart_status);
-        break;
-      case REF_CMD_ID_ICRA_ZONE_STATUS:
-        destination = &(this->ref_data_.icra_zone);
-        size = sizeof(this->ref_data_.icra_zone);
-        break;
-      case REF_CMD_ID_FIELD_EVENTS:
-        destination = &(this->ref_data_.field_event);
-        size = sizeof(this->ref_data_.field_event);
-        break;
-      case REF_CMD_ID_SUPPLY_ACTION:
-        destination = &(this->ref_data_.supply_action);
-        size = sizeof(this->ref_data_.supply_action);
-        break;
-      case REF_CMD_ID_WARNING:
-        destination = &(this->ref_data_.warning);
-        size = sizeof(this->ref_data_.warning);
-        break;
-      case REF_CMD_ID_DART_COUNTDOWN:
-        destination = &(this->ref_data_.dart_countdown);
-        size = sizeof(this->ref_data_.dart_countdown);
-        break;
-      case REF_CMD_ID_ROBOT_STATUS:
-        destination = &(this->ref_data_.robot_status);
-        size = sizeof(this->ref_data_.robot_status);
-        break;
-      case REF_CMD_ID_POWER_HEAT_DATA:
-        destination = &(this->ref_data_.power_heat);
-        size = sizeof(this->ref_data_.power_heat);
-        break;
-      case REF_CMD_ID_ROBOT_POS:
-        destination = &(this->ref_data_.robot_pos);
-        size = sizeof(this->ref_data_.robot_pos);
-        break;
-      case REF_CMD_ID_ROBOT_BUFF:
-        destination = &(this->ref_data_.robot_buff);
-        size = sizeof(this->ref_data_.robot_buff);
-        break;
-      case REF_CMD_ID_DRONE_ENERGY:
-        destination = &(this->ref_data_.drone_energy);
-        size = sizeof(this->ref_data_.drone_energy);
-        break;
-      case REF_CMD_ID_ROBOT_DMG:
-        destination = &(this->ref_data_.robot_danage);
-        size = sizeof(this->ref_data_.robot_danage);
-        break;
-      case REF_CMD_ID_LAUNCHER_DATA:
-        destination = &(this->ref_data_.launcher_data);
-        size = sizeof(this->ref_data_.launcher_data);
-        break;
-      case REF_CMD_ID_BULLET_REMAINING:
-        destination = &(this->ref_data_.bullet_remain);
-        size = sizeof(this->ref_data_.bullet_remain);
-        break;
-      case REF_CMD_ID_RFID:
-        destination = &(this->ref_data_.rfid);
-        size = sizeof(this->ref_data_.rfid);
-        break;
-      case REF_CMD_ID_DART_CLIENT:
-        destination = &(this->ref_data_.dart_client);
-        size = sizeof(this->ref_data_.dart_client);
-        break;
-      case REF_CMD_ID_CLIENT_MAP:
-        destination = &(this->ref_data_.client_map);
-        size = sizeof(this->ref_data_.client_map);
-        break;
-      case REF_CMD_ID_KEYBOARD_MOUSE:
-        destination = &(this->ref_data_.keyboard_mouse);
-        size = sizeof(this->ref_data_.keyboard_mouse);
-        break;
-      default:
-        return;
-    }
-    index += size;
 
-    /* 4.处理帧尾 */
-    index += sizeof(Referee::Tail);
+  /* DMA当前写入位置，写到末尾后回到开头 */
+  uint32_t write_pos = bsp_uart_get_count(BSP_UART_REF) % REF_LEN_RX_BUFF;
 
-    /* 验证无误则接受数据 */
-    if (Component::CRC16::Verify(
-            reinterpret_cast<const uint8_t *>((header)),
-            static_cast<uint8_t>(
-                index - reinterpret_cast<const uint8_t *>((header))))) {
-      memcpy(destination, source, size);
-    }
+  /* 逐字节送入状态机，跨越两次接收的帧也能拼接完整 */
+  while (this->read_pos_ != write_pos) {
+    this->ParseByte(rxbuf[this->read_pos_]);
+    this->read_pos_ = (this->read_pos_ + 1) % REF_LEN_RX_BUFF;
   }
+
 #if REF_VIRTUAL
 #if REF_FORCE_ONLINE
   this->ref_data_.status = RUNNING;
@@ -267,128 +169,317 @@ void Referee::Prase() {
 #endif
 }
 
+void Referee::ParseByte(uint8_t data) {
+  switch (this->parse_state_) {
+    case REF_PARSE_SOF:
+      if (data == REF_HEADER_SOF) {
+        this->frame_buff_[0] = data;
+        this->frame_index_ = 1;
+        this->parse_state_ = REF_PARSE_HEADER;
+      }
+      break;
+
+    case REF_PARSE_HEADER: {
+      this->frame_buff_[this->frame_index_++] = data;
+      if (this->frame_index_ < sizeof(Referee::Header)) {
+        break;
+      }
+
+      const Referee::Header *header =
+          reinterpret_cast<const Referee::Header *>(this->frame_buff_.data());
+
+      /* 先检查data_length再求和，避免帧长回绕 */
+      if (Component::CRC8::Verify(this->frame_buff_.data(),
+                                  sizeof(Referee::Header)) &&
+          header->data_length <= REF_LEN_FRAME_MAX) {
+        this->frame_len_ = sizeof(Referee::Header) + sizeof(uint16_t) +
+                           header->data_length + sizeof(Referee::Tail);
+        if (this->frame_len_ <= REF_LEN_FRAME_MAX) {
+          this->parse_state_ = REF_PARSE_DATA;
+          break;
+        }
+      }
+
+      /* 帧头校验失败，从缓存中的下一个SOF重新开始 */
+      uint16_t offset = 1;
+      while (offset < this->frame_index_ &&
+             this->frame_buff_[offset] != REF_HEADER_SOF) {
+        offset++;
+      }
+      this->frame_index_ -= offset;
+      memmove(this->frame_buff_.data(), this->frame_buff_.data() + offset,
+              this->frame_index_);
+      this->parse_state_ =
+          this->frame_index_ > 0 ? REF_PARSE_HEADER : REF_PARSE_SOF;
+      break;
+    }
+
+    case REF_PARSE_DATA:
+      this->frame_buff_[this->frame_index_++] = data;
+      if (this->frame_index_ < this->frame_len_) {
+        break;
+      }
+
+      if (Component::CRC16::Verify(this->frame_buff_.data(),
+                                   this->frame_len_)) {
+        this->ParseFrame();
+      }
+      this->parse_state_ = REF_PARSE_SOF;
+      break;
+
+    default:
+      this->parse_state_ = REF_PARSE_SOF;
+      break;
+  }
+}
+
+void Referee::ParseFrame() {
+  uint16_t cmd_id = 0;
+  memcpy(&cmd_id, this->frame_buff_.data() + sizeof(Referee::Header),
+         sizeof(cmd_id));
+
+  const uint8_t *source =
+      this->frame_buff_.data() + sizeof(Referee::Header) + sizeof(cmd_id);
+  size_t data_length = this->frame_len_ - sizeof(Referee::Header) -
+                       sizeof(cmd_id) - sizeof(Referee::Tail);
+
+  void *destination = NULL;
+  size_t size = 0;
+  uint32_t mask = 0;
+
+  switch (cmd_id) {
+    case REF_CMD_ID_GAME_STATUS:
+      destination = &(this->ref_data_.game_status);
+      size = sizeof(this->ref_data_.game_status);
+      mask = REF_UPDATE_GAME_STATUS;
+      break;
+    case REF_CMD_ID_GAME_RESULT:
+      destination = &(this->ref_data_.game_result);
+      size = sizeof(this->ref_data_.game_result);
+      mask = REF_UPDATE_GAME_RESULT;
+      break;
+    case REF_CMD_ID_GAME_ROBOT_HP:
+      destination = &(this->ref_data_.game_robot_hp);
+      size = sizeof(this->ref_data_.game_robot_hp);
+      mask = REF_UPDATE_GAME_ROBOT_HP;
+      break;
+    case REF_CMD_ID_DART_STATUS:
+      destination = &(this->ref_data_.dart_status);
+      size = sizeof(this->ref_data_.dart_status);
+      mask = REF_UPDATE_DART_STATUS;
+      break;
+    case REF_CMD_ID_ICRA_ZONE_STATUS:
+      destination = &(this->ref_data_.icra_zone);
+      size = sizeof(this->ref_data_.icra_zone);
+      mask = REF_UPDATE_ICRA_ZONE_STATUS;
+      break;
+    case REF_CMD_ID_FIELD_EVENTS:
+      destination = &(this->ref_data_.field_event);
+      size = sizeof(this->ref_data_.field_event);
+      mask = REF_UPDATE_FIELD_EVENTS;
+      break;
+    case REF_CMD_ID_SUPPLY_ACTION:
+      destination = &(this->ref_data_.supply_action);
+      size = sizeof(this->ref_data_.supply_action);
+      mask = REF_UPDATE_SUPPLY_ACTION;
+      break;
+    case REF_CMD_ID_WARNING:
+      destination = &(this->ref_data_.warning);
+      size = sizeof(this->ref_data_.warning);
+      mask = REF_UPDATE_WARNING;
+      break;
+    case REF_CMD_ID_DART_COUNTDOWN:
+      destination = &(this->ref_data_.dart_countdown);
+      size = sizeof(this->ref_data_.dart_countdown);
+      mask = REF_UPDATE_DART_COUNTDOWN;
+      break;
+    case REF_CMD_ID_ROBOT_STATUS:
+      destination = &(this->ref_data_.robot_status);
+      size = sizeof(this->ref_data_.robot_status);
+      mask = REF_UPDATE_ROBOT_STATUS;
+      break;
+    case REF_CMD_ID_POWER_HEAT_DATA:
+      destination = &(this->ref_data_.power_heat);
+      size = sizeof(this->ref_data_.power_heat);
+      mask = REF_UPDATE_POWER_HEAT_DATA;
+      break;
+    case REF_CMD_ID_ROBOT_POS:
+      destination = &(this->ref_data_.robot_pos);
+      size = sizeof(this->ref_data_.robot_pos);
+      mask = REF_UPDATE_ROBOT_POS;
+      break;
+    case REF_CMD_ID_ROBOT_BUFF:
+      destination = &(this->ref_data_.robot_buff);
+      size = sizeof(this->ref_data_.robot_buff);
+      mask = REF_UPDATE_ROBOT_BUFF;
+      break;
+    case REF_CMD_ID_DRONE_ENERGY:
+      destination = &(this->ref_data_.drone_energy);
+      size = sizeof(this->ref_data_.drone_energy);
+      mask = REF_UPDATE_DRONE_ENERGY;
+      break;
+    case REF_CMD_ID_ROBOT_DMG:
+      destination = &(this->ref_data_.robot_danage);
+      size = sizeof(this->ref_data_.robot_danage);
+      mask = REF_UPDATE_ROBOT_DMG;
+      break;
+    case REF_CMD_ID_LAUNCHER_DATA:
+      destination = &(this->ref_data_.launcher_data);
+      size = sizeof(this->ref_data_.launcher_data);
+      mask = REF_UPDATE_LAUNCHER_DATA;
+      break;
+    case REF_CMD_ID_BULLET_REMAINING:
+      destination = &(this->ref_data_.bullet_remain);
+      size = sizeof(this->ref_data_.bullet_remain);
+      mask = REF_UPDATE_BULLET_REMAINING;
+      break;
+    case REF_CMD_ID_RFID:
+      destination = &(this->ref_data_.rfid);
+      size = sizeof(this->ref_data_.rfid);
+      mask = REF_UPDATE_RFID;
+      break;
+    case REF_CMD_ID_DART_CLIENT:
+      destination = &(this->ref_data_.dart_client);
+      size = sizeof(this->ref_data_.dart_client);
+      mask = REF_UPDATE_DART_CLIENT;
+      break;
+    case REF_CMD_ID_CLIENT_MAP:
+      destination = &(this->ref_data_.client_map);
+      size = sizeof(this->ref_data_.client_map);
+      mask = REF_UPDATE_CLIENT_MAP;
+      break;
+    case REF_CMD_ID_KEYBOARD_MOUSE:
+      destination = &(this->ref_data_.keyboard_mouse);
+      size = sizeof(this->ref_data_.keyboard_mouse);
+      mask = REF_UPDATE_KEYBOARD_MOUSE;
+      break;
+    default:
+      return;
+  }
+
+  /* 协议版本不一致时只复制两者都有的部分 */
+  if (size > data_length) {
+    size = data_length;
+  }
+
+  if (memcmp(destination, source, size) != 0) {
+    memcpy(destination, source, size);
+    this->dirty_ |= mask;
+  }
+}
+
 bool Referee::UpdateUI() {
   this->packet_sent_.Take(UINT32_MAX);
 
   this->ui_lock_.Take(UINT32_MAX);
 
-  bool done = false;
-  uint32_t ele_counter = 0;
+  uint32_t now = bsp_time_get_ms();
   uint32_t pack_size = 0;
+  uint32_t ele_counter = 0;
   CMDID cmd_id = REF_STDNT_CMD_ID_UI_DEL;
-  Component::UI::GraphicOperation op = Component::UI::UI_GRAPHIC_OP_NOTHING;
 
-  if (!done && this->static_del_data_.Size() > 0) {
-    cmd_id = REF_STDNT_CMD_ID_UI_DEL;
-    pack_size = sizeof(UIDelPack);
-    done = true;
-    op = Component::UI::UI_GRAPHIC_OP_ADD;
+  /* 按链路字节速率补充令牌，单位为千分之一字节 */
+  uint32_t elapsed = now - this->ui_bucket_time_;
+  if (elapsed > 1000) {
+    elapsed = 1000;
   }
+  this->ui_bucket_time_ = now;
+  this->ui_bucket_ += elapsed * UI_MAX_BYTE_RATE;
+  if (this->ui_bucket_ > REF_UI_BUCKET_SIZE * 1000) {
+    this->ui_bucket_ = REF_UI_BUCKET_SIZE * 1000;
+  }
+  uint32_t tokens = this->ui_bucket_ / 1000;
+
+  /* 令牌不够最大的数据包时静态元素延后，带宽留给动态元素 */
+  bool dynamic_only = tokens < sizeof(UIElePack_7);
+
+  uint32_t ele_max = 0;
+  if (tokens >= sizeof(UIElePack_7)) {
+    ele_max = 7;
+  } else if (tokens >= sizeof(UIElePack_5)) {
+    ele_max = 5;
+  } else if (tokens >= sizeof(UIElePack_2)) {
+    ele_max = 2;
+  } else if (tokens >= sizeof(UIElePack_1)) {
+    ele_max = 1;
+  }
+
+  bool waiting = this->del_data_.Size() > 0;
 
-  if (bsp_time_get_ms() % 6000 > 3000) {
-    if (!done && this->static_string_data_.Size() > 0) {
-      cmd_id = REF_STDNT_CMD_ID_UI_STR;
-      pack_size = sizeof(UIStringPack);
-      done = true;
-      op = Component::UI::UI_GRAPHIC_OP_ADD;
+  /* 优先级最高的字符 */
+  UIStrSlot *str = NULL;
+  uint8_t str_rank = UINT8_MAX;
+  for (auto &slot : this->str_slot_) {
+    if (!slot.pending) {
+      continue;
+    }
+    waiting = true;
+    if (tokens < sizeof(UIStringPack) ||
+        (dynamic_only && IsStatic(slot.str.graphic))) {
+      continue;
+    }
+    uint8_t rank = UIRank(slot.str.graphic, slot.time, now);
+    if (rank < str_rank || (rank == str_rank && slot.time < str->time)) {
+      str = &slot;
+      str_rank = rank;
     }
+  }
 
-    static_ele_data_.Reset();
-  } else {
-    if (!done && this->static_ele_data_.Size() > 0) {
-      switch (this->static_ele_data_.Size()) {
-        case 0:
-          break;
-        case 1:
-          cmd_id = REF_STDNT_CMD_ID_UI_DRAW1;
-          done = true;
-          op = Component::UI::UI_GRAPHIC_OP_ADD;
-          ele_counter = 1;
-          pack_size = sizeof(UIElePack_1);
-          break;
-        case 2:
-        case 3:
-        case 4:
-          cmd_id = REF_STDNT_CMD_ID_UI_DRAW2;
-          done = true;
-          op = Component::UI::UI_GRAPHIC_OP_ADD;
-          ele_counter = 2;
-          pack_size = sizeof(UIElePack_2);
-          break;
-        case 5:
-        case 6:
-          cmd_id = REF_STDNT_CMD_ID_UI_DRAW5;
-          done = true;
-          op = Component::UI::UI_GRAPHIC_OP_ADD;
-          ele_counter = 5;
-          pack_size = sizeof(UIElePack_5);
-          break;
-        default:
-          cmd_id = REF_STDNT_CMD_ID_UI_DRAW7;
-          done = true;
-          op = Component::UI::UI_GRAPHIC_OP_ADD;
-          ele_counter = 7;
-          pack_size = sizeof(UIElePack_7);
-          break;
+  uint8_t ele_rank = UINT8_MAX;
+  for (auto &slot : this->ele_slot_) {
+    waiting |= slot.pending;
+    if (slot.pending && ele_max > 0 &&
+        !(dynamic_only && IsStatic(slot.ele))) {
+      uint8_t rank = UIRank(slot.ele, slot.time, now);
+      if (rank < ele_rank) {
+        ele_rank = rank;
       }
     }
-
-    static_string_data_.Reset();
   }
 
-  if (!done && this->del_data_.Size() > 0) {
+  if (this->del_data_.Size() > 0 && tokens >= sizeof(UIDelPack)) {
+    /* 删除操作最先发送 */
     cmd_id = REF_STDNT_CMD_ID_UI_DEL;
     pack_size = sizeof(UIDelPack);
-    done = true;
-    op = Component::UI::UI_GRAPHIC_OP_REWRITE;
-  }
+    this->del_data_.Receive(this->ui_pack_.del.del_data, 0);
+    ele_counter = 1;
+  } else if (ele_rank != UINT8_MAX && ele_rank <= str_rank) {
+    ele_counter = this->PackUIEle(now, ele_max, dynamic_only);
+
+    /* 选用能装下所有图形的最小数据包，空位为无操作 */
+    if (ele_counter == 1) {
+      cmd_id = REF_STDNT_CMD_ID_UI_DRAW1;
+      pack_size = sizeof(UIElePack_1);
+    } else if (ele_counter == 2) {
+      cmd_id = REF_STDNT_CMD_ID_UI_DRAW2;
+      pack_size = sizeof(UIElePack_2);
+    } else if (ele_counter <= 5) {
+      cmd_id = REF_STDNT_CMD_ID_UI_DRAW5;
+      pack_size = sizeof(UIElePack_5);
+    } else {
+      cmd_id = REF_STDNT_CMD_ID_UI_DRAW7;
+      pack_size = sizeof(UIElePack_7);
+    }
 
-  if (!done && this->string_data_.Size() > 0) {
+    uint32_t slot_num = (pack_size - sizeof(UIElePack_1)) /
+                            sizeof(Component::UI::Ele) +
+                        1;
+
+    for (uint32_t i = ele_counter; i < slot_num; i++) {
+      memset(&this->ui_pack_.ele_7.ele_data[i], 0,
+             sizeof(Component::UI::Ele));
+    }
+  } else if (str != NULL) {
     cmd_id = REF_STDNT_CMD_ID_UI_STR;
     pack_size = sizeof(UIStringPack);
-    done = true;
-    op = Component::UI::UI_GRAPHIC_OP_REWRITE;
-  }
-
-  if (!done && this->ele_data_.Size() > 0) {
-    switch (this->ele_data_.Size()) {
-      case 0:
-        break;
-      case 1:
-        cmd_id = REF_STDNT_CMD_ID_UI_DRAW1;
-        done = true;
-        op = Component::UI::UI_GRAPHIC_OP_REWRITE;
-        ele_counter = 1;
-        pack_size = sizeof(UIElePack_1);
-        break;
-      case 2:
-      case 3:
-      case 4:
-        cmd_id = REF_STDNT_CMD_ID_UI_DRAW2;
-        done = true;
-        op = Component::UI::UI_GRAPHIC_OP_REWRITE;
-        ele_counter = 2;
-        pack_size = sizeof(UIElePack_2);
-        break;
-      case 5:
-      case 6:
-        cmd_id = REF_STDNT_CMD_ID_UI_DRAW5;
-        done = true;
-        op = Component::UI::UI_GRAPHIC_OP_REWRITE;
-        ele_counter = 5;
-        pack_size = sizeof(UIElePack_5);
-        break;
-      default:
-        cmd_id = REF_STDNT_CMD_ID_UI_DRAW7;
-        done = true;
-        ele_counter = 7;
-        op = Component::UI::UI_GRAPHIC_OP_REWRITE;
-        pack_size = sizeof(UIElePack_7);
-        break;
+    memcpy(&this->ui_pack_.str.str_data, &str->str, sizeof(str->str));
+    str->pending = false;
+    ele_counter = 1;
+  } else {
+    /* 有等待发送的内容但令牌不足 */
+    if (waiting) {
+      this->ui_stat_.deferred++;
     }
-  }
-
-  if (!done) {
     this->ui_lock_.Give();
     this->packet_sent_.Give();
     return false;
@@ -401,59 +492,144 @@ bool Referee::UpdateUI() {
 
   SetPacketHeader(this->ui_pack_.raw.frame_header, pack_size - 9);
 
-  if (ele_counter) {
-    for (uint32_t i = 0; i < ele_counter; i++) {
-      if (op == Component::UI::UI_GRAPHIC_OP_REWRITE) {
-        this->ele_data_.Receive(this->ui_pack_.ele_7.ele_data[i], UINT32_MAX);
-      } else {
-        this->static_ele_data_.Receive(this->ui_pack_.ele_7.ele_data[i],
-                                       UINT32_MAX);
-      }
-    }
+  uint16_t crc16 = Component::CRC16::Calculate(
+      reinterpret_cast<const uint8_t *>(&this->ui_pack_),
+      pack_size - sizeof(uint16_t), CRC16_INIT);
+  memcpy(reinterpret_cast<uint8_t *>(&this->ui_pack_) + pack_size -
+             sizeof(uint16_t),
+         &crc16, sizeof(crc16));
 
-    uint16_t *crc_addr = reinterpret_cast<uint16_t *>(
-        &this->ui_pack_.ele_7.ele_data[ele_counter]);
+  this->ui_stat_.packet++;
+  this->ui_stat_.ele += ele_counter;
+  this->ui_stat_.bytes += pack_size;
+  this->ui_bucket_ -= pack_size * 1000;
 
-    *crc_addr = Component::CRC16::Calculate(
-        reinterpret_cast<const uint8_t *>(&this->ui_pack_),
-        pack_size - sizeof(uint16_t), CRC16_INIT);
-  } else if (cmd_id == REF_STDNT_CMD_ID_UI_DEL) {
-    if (op == Component::UI::UI_GRAPHIC_OP_REWRITE) {
-      this->del_data_.Receive(this->ui_pack_.del.del_data, UINT32_MAX);
-    } else {
-      this->static_del_data_.Receive(this->ui_pack_.del.del_data, UINT32_MAX);
+  bsp_uart_transmit(BSP_UART_REF, reinterpret_cast<uint8_t *>(&this->ui_pack_),
+                    pack_size, false);
+
+  this->ui_lock_.Give();
+
+  return true;
+}
+
+uint32_t Referee::PackUIEle(uint32_t now, uint32_t max_num,
+                            bool dynamic_only) {
+  uint32_t num = 0;
+
+  /* 每次取出优先级最高、等待最久的图形，最多max_num个 */
+  while (num < max_num && num < UI_MAX_GRAPHIC_NUM) {
+    UIEleSlot *best = NULL;
+    uint8_t best_rank = UINT8_MAX;
+
+    for (auto &slot : this->ele_slot_) {
+      if (!slot.pending || (dynamic_only && IsStatic(slot.ele))) {
+        continue;
+      }
+      uint8_t rank = UIRank(slot.ele, slot.time, now);
+      if (rank < best_rank || (rank == best_rank && slot.time < best->time)) {
+        best = &slot;
+        best_rank = rank;
+      }
     }
-    this->ui_pack_.del.crc16 = Component::CRC16::Calculate(
-        reinterpret_cast<const uint8_t *>(&this->ui_pack_),
-        pack_size - sizeof(uint16_t), CRC16_INIT);
 
-  } else if (cmd_id == REF_STDNT_CMD_ID_UI_STR) {
-    if (op == Component::UI::UI_GRAPHIC_OP_REWRITE) {
-      this->string_data_.Receive(this->ui_pack_.str.str_data, UINT32_MAX);
-    } else {
-      this->static_string_data_.Receive(this->ui_pack_.str.str_data,
-                                        UINT32_MAX);
+    if (best == NULL) {
+      break;
     }
-    this->ui_pack_.str.crc16 = Component::CRC16::Calculate(
-        reinterpret_cast<const uint8_t *>(&this->ui_pack_),
-        pack_size - sizeof(uint16_t), CRC16_INIT);
+
+    memcpy(&this->ui_pack_.ele_7.ele_data[num++], &best->ele,
+           sizeof(best->ele));
+    best->pending = false;
   }
 
-  bsp_uart_transmit(BSP_UART_REF, reinterpret_cast<uint8_t *>(&this->ui_pack_),
-                    pack_size, false);
+  return num;
+}
 
-  this->ui_lock_.Give();
+bool Referee::IsStatic(const Component::UI::Ele &ele) {
+  return ele.op == Component::UI::UI_GRAPHIC_OP_ADD;
+}
 
-  return true;
+uint8_t Referee::UIRank(const Component::UI::Ele &ele, uint32_t time,
+                        uint32_t now) {
+  /* 静态元素等待过久时提到最前，避免一直被动态元素挤占 */
+  if (IsStatic(ele)) {
+    return now - time > UI_STATIC_CYCLE ? 0 : 3;
+  }
+
+  if (ele.layer == Component::UI::UI_GRAPHIC_LAYER_AUTOAIM ||
+      ele.layer == Component::UI::UI_GRAPHIC_LAYER_CAP) {
+    return 1;
+  }
+
+  return 2;
+}
+
+int Referee::ShowUICMD(Referee *ref, int argc, char **argv) {
+  (void)(argv);
+
+  if (argc != 1) {
+    printf("命令错误。\r\n");
+    return 0;
+  }
+
+  uint32_t ele_pending = 0, str_pending = 0;
+  for (auto &slot : ref->ele_slot_) {
+    ele_pending += slot.pending;
+  }
+  for (auto &slot : ref->str_slot_) {
+    str_pending += slot.pending;
+  }
+
+  UIStat &stat = ref->ui_stat_;
+
+  printf("已发送:%d 平均每包:%.2f 字节:%d\r\n", static_cast<int>(stat.packet),
+         stat.packet ? static_cast<float>(stat.ele) /
+                           static_cast<float>(stat.packet)
+                     : 0.0f,
+         static_cast<int>(stat.bytes));
+  printf("合并:%d 丢弃:%d 等待图形:%d 等待字符:%d\r\n",
+         static_cast<int>(stat.merged), static_cast<int>(stat.dropped),
+         static_cast<int>(ele_pending), static_cast<int>(str_pending));
+  printf("令牌:%d/%d 字节/秒:%d 延后:%d\r\n",
+         static_cast<int>(ref->ui_bucket_ / 1000),
+         static_cast<int>(REF_UI_BUCKET_SIZE), UI_MAX_BYTE_RATE,
+         static_cast<int>(stat.deferred));
+
+  return 0;
 }
 
 bool Referee::AddUI(Component::UI::Ele ui_data) {
+  UIEleSlot *target = NULL;
+
   self_->ui_lock_.Take(UINT32_MAX);
-  if (ui_data.op == Component::UI::UI_GRAPHIC_OP_ADD) {
-    self_->static_ele_data_.Send(ui_data, 0);
-  } else {
-    self_->ele_data_.Send(ui_data, 0);
+
+  for (auto &slot : self_->ele_slot_) {
+    if (slot.pending && memcmp(slot.ele.name, ui_data.name,
+                               sizeof(ui_data.name)) == 0) {
+      /* 还没发出的新增操作不能被修改操作覆盖 */
+      if (slot.ele.op == Component::UI::UI_GRAPHIC_OP_ADD &&
+          ui_data.op == Component::UI::UI_GRAPHIC_OP_REWRITE) {
+        ui_data.op = Component::UI::UI_GRAPHIC_OP_ADD;
+      }
+      slot.ele = ui_data;
+      self_->ui_stat_.merged++;
+      self_->ui_lock_.Give();
+      return true;
+    }
+    if (!slot.pending && target == NULL) {
+      target = &slot;
+    }
+  }
+
+  if (target == NULL) {
+    self_->ui_stat_.dropped++;
+    self_->ui_lock_.Give();
+    return false;
   }
+
+  target->ele = ui_data;
+  target->time = bsp_time_get_ms();
+  target->pending = true;
+
   self_->ui_lock_.Give();
 
   return true;
@@ -461,19 +637,47 @@ bool Referee::AddUI(Component::UI::Ele ui_data) {
 
 bool Referee::AddUI(Component::UI::Del ui_data) {
   self_->ui_lock_.Take(UINT32_MAX);
-  self_->del_data_.Send(ui_data, 0);
+  bool ans = self_->del_data_.Send(ui_data, 0);
+  if (!ans) {
+    self_->ui_stat_.dropped++;
+  }
   self_->ui_lock_.Give();
 
-  return true;
+  return ans;
 }
 
 bool Referee::AddUI(Component::UI::Str ui_data) {
+  UIStrSlot *target = NULL;
+
   self_->ui_lock_.Take(UINT32_MAX);
-  if (ui_data.graphic.op == Component::UI::UI_GRAPHIC_OP_ADD) {
-    self_->static_string_data_.Send(ui_data, 0);
-  } else {
-    self_->string_data_.Send(ui_data, 0);
+
+  for (auto &slot : self_->str_slot_) {
+    if (slot.pending && memcmp(slot.str.graphic.name, ui_data.graphic.name,
+                               sizeof(ui_data.graphic.name)) == 0) {
+      if (slot.str.graphic.op == Component::UI::UI_GRAPHIC_OP_ADD &&
+          ui_data.graphic.op == Component::UI::UI_GRAPHIC_OP_REWRITE) {
+        ui_data.graphic.op = Component::UI::UI_GRAPHIC_OP_ADD;
+      }
+      slot.str = ui_data;
+      self_->ui_stat_.merged++;
+      self_->ui_lock_.Give();
+      return true;
+    }
+    if (!slot.pending && target == NULL) {
+      target = &slot;
+    }
   }
+
+  if (target == NULL) {
+    self_->ui_stat_.dropped++;
+    self_->ui_lock_.Give();
+    return false;
+  }
+
+  target->str = ui_data;
+  target->time = bsp_time_get_ms();
+  target->pending = true;
+
   self_->ui_lock_.Give();
 
   return true;
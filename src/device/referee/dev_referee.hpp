@@ -6,6 +6,7 @@
 
 #include <device.hpp>
 
+#include "comp_snapshot.hpp"
 #include "comp_ui.hpp"
 #include "comp_utils.hpp"
 
@@ -13,6 +14,11 @@
 #define GAME_HEAT_INCREASE_17MM (10.0f) /* 每发射一颗17mm弹丸增加10热量 */
 
 #define GAME_CHASSIS_MAX_POWER_WO_REF 40.0f /* 裁判系统离线时底盘最大功率 */
+
+#define REF_LEN_FRAME_MAX (128) /* 单帧最大长度，超过的帧直接丢弃 */
+
+#define REF_UI_ELE_SLOT_NUM (32) /* 等待发送的图形数量上限 */
+#define REF_UI_STR_SLOT_NUM (8)  /* 等待发送的字符数量上限 */
 #define REF_UI_BOX_UP_OFFSET (4)
 #define REF_UI_BOX_BOT_OFFSET (-14)
 
@@ -50,6 +56,12 @@ class Referee {
     RUNNING,
   } Status;
 
+  typedef enum {
+    REF_PARSE_SOF,
+    REF_PARSE_HEADER,
+    REF_PARSE_DATA,
+  } ParseState;
+
   typedef enum {
     REF_CMD_ID_GAME_STATUS = 0x0001,
     REF_CMD_ID_GAME_RESULT = 0x0002,
@@ -323,7 +335,34 @@ class Referee {
     uint16_t id_receiver;
   } InterStudentHeader;
 
+  /* Data::updated中的位，每个命令一位 */
+  typedef enum {
+    REF_UPDATE_STATUS = 1 << 0,
+    REF_UPDATE_GAME_STATUS = 1 << 1,
+    REF_UPDATE_GAME_RESULT = 1 << 2,
+    REF_UPDATE_GAME_ROBOT_HP = 1 << 3,
+    REF_UPDATE_DART_STATUS = 1 << 4,
+    REF_UPDATE_ICRA_ZONE_STATUS = 1 << 5,
+    REF_UPDATE_FIELD_EVENTS = 1 << 6,
+    REF_UPDATE_SUPPLY_ACTION = 1 << 7,
+    REF_UPDATE_WARNING = 1 << 8,
+    REF_UPDATE_DART_COUNTDOWN = 1 << 9,
+    REF_UPDATE_ROBOT_STATUS = 1 << 10,
+    REF_UPDATE_POWER_HEAT_DATA = 1 << 11,
+    REF_UPDATE_ROBOT_POS = 1 << 12,
+    REF_UPDATE_ROBOT_BUFF = 1 << 13,
+    REF_UPDATE_DRONE_ENERGY = 1 << 14,
+    REF_UPDATE_ROBOT_DMG = 1 << 15,
+    REF_UPDATE_LAUNCHER_DATA = 1 << 16,
+    REF_UPDATE_BULLET_REMAINING = 1 << 17,
+    REF_UPDATE_RFID = 1 << 18,
+    REF_UPDATE_DART_CLIENT = 1 << 19,
+    REF_UPDATE_CLIENT_MAP = 1 << 20,
+    REF_UPDATE_KEYBOARD_MOUSE = 1 << 21,
+  } UpdateMask;
+
   typedef struct {
+    uint32_t updated; /* 与上一次发布相比有变化的命令，见UpdateMask */
     Status status;
     GameStatus game_status;
     GameResult game_result;
@@ -407,9 +446,28 @@ class Referee {
     } raw;
   };
 
-  Referee();
+  typedef struct {
+    Component::UI::Ele ele;
+    uint32_t time; /* 开始等待发送的时间 */
+    bool pending;
+  } UIEleSlot;
+
+  typedef struct {
+    Component::UI::Str str;
+    uint32_t time;
+    bool pending;
+  } UIStrSlot;
 
-  bool UIStackEmpty();
+  typedef struct {
+    uint32_t packet;   /* 已发送的数据包数量 */
+    uint32_t ele;      /* 已发送的图形和字符数量 */
+    uint32_t merged;   /* 发送前被同名新数据覆盖的数量 */
+    uint32_t dropped;  /* 缓冲区满丢弃的数量 */
+    uint32_t bytes;    /* 已发送的字节数 */
+    uint32_t deferred; /* 令牌不足延后发送的次数 */
+  } UIStat;
+
+  Referee();
 
   void Offline();
 
@@ -417,8 +475,22 @@ class Referee {
 
   void Prase();
 
+  void ParseByte(uint8_t data);
+
+  void ParseFrame();
+
   bool UpdateUI();
 
+  /* dynamic_only为true时跳过静态元素 */
+  uint32_t PackUIEle(uint32_t now, uint32_t max_num, bool dynamic_only);
+
+  static bool IsStatic(const Component::UI::Ele &ele);
+
+  static uint8_t UIRank(const Component::UI::Ele &ele, uint32_t time,
+                        uint32_t now);
+
+  static int ShowUICMD(Referee *ref, int argc, char **argv);
+
   static bool AddUI(Component::UI::Ele ui_data);
   static bool AddUI(Component::UI::Del ui_data);
   static bool AddUI(Component::UI::Str ui_data);
@@ -426,10 +498,6 @@ class Referee {
   static float UIGetHeight() { return 1080.0f; }
   static float UIGetWidth() { return 1920.0f; }
 
-  bool PackUI();
-
-  bool StartTrans();
-
   void SetUIHeader(InterStudentHeader &header, const CMDID CMD_ID,
                    RobotID robot_id);
 
@@ -444,30 +512,42 @@ class Referee {
 
   Message::Topic<Data> ref_data_tp_ = Message::Topic<Data>("referee");
 
-  System::Queue<Component::UI::Ele> ele_data_ =
-      System::Queue<Component::UI::Ele>(10);
+  /* 控制线程通过快照读取，不再复制整个Data */
+  Component::Snapshot<Data> ref_data_snap_ =
+      Component::Snapshot<Data>("referee");
 
-  System::Queue<Component::UI::Str> string_data_ =
-      System::Queue<Component::UI::Str>(10);
+  /* 同名图形只保留最新的一份 */
+  std::array<UIEleSlot, REF_UI_ELE_SLOT_NUM> ele_slot_;
+  std::array<UIStrSlot, REF_UI_STR_SLOT_NUM> str_slot_;
 
   System::Queue<Component::UI::Del> del_data_ =
       System::Queue<Component::UI::Del>(10);
 
-  System::Queue<Component::UI::Ele> static_ele_data_ =
-      System::Queue<Component::UI::Ele>(10);
-
-  System::Queue<Component::UI::Str> static_string_data_ =
-      System::Queue<Component::UI::Str>(10);
+  UIStat ui_stat_;
 
-  System::Queue<Component::UI::Del> static_del_data_ =
-      System::Queue<Component::UI::Del>(10);
+  /* 令牌桶，按UI_MAX_BYTE_RATE补充，单位为千分之一字节 */
+  uint32_t ui_bucket_ = 0;
+  uint32_t ui_bucket_time_ = 0;
 
   System::Semaphore ui_lock_ = System::Semaphore(true);
 
   Data ref_data_;
 
+  /* 接收状态机，帧可以跨越多次DMA接收 */
+  ParseState parse_state_ = REF_PARSE_SOF;
+  std::array<uint8_t, REF_LEN_FRAME_MAX> frame_buff_;
+  uint16_t frame_index_ = 0;
+  uint16_t frame_len_ = 0;
+  uint32_t read_pos_ = 0;
+
+  uint32_t dirty_ = UINT32_MAX; /* 启动后先发布一次 */
+  bool rx_error_ = false;
+  Status last_status_ = OFFLINE;
+
   static UIPack ui_pack_;
 
+  System::Term::Command<Referee *> ui_cmd_;
+
   static Referee *self_;
 };
 }  // namespace Device
@@ -12,6 +12,7 @@ Referee::Referee() {
       ref->Prase();
 
       /* 发布裁判系统数据 */
+      ref->ref_data_snap_.Write(ref->ref_data_);
       ref->ref_data_tp_.Publish(ref->ref_data_);
 
       ref->recv_thread_.Sleep(10);
@@ -6,6 +6,7 @@
 
 #include <device.hpp>
 
+#include "comp_snapshot.hpp"
 #include "comp_ui.hpp"
 
 #define REF_UI_BOX_UP_OFFSET (4)
@@ -374,6 +375,10 @@ class Referee {
 
   Message::Topic<Data> ref_data_tp_ = Message::Topic<Data>("referee");
 
+  /* 控制线程通过快照读取，不再复制整个Data */
+  Component::Snapshot<Data> ref_data_snap_ =
+      Component::Snapshot<Data>("referee");
+
   Data ref_data_;
 };
 }  // namespace Device
@@ -49,7 +49,7 @@ void Tof::Decode(Can::Pack &rx) {
 bool Tof::Update() {
   Can::Pack pack;
 
-  while (this->recv_.Receive(pack, 2)) {
+  while (this->recv_.Receive(pack)) {
     this->Decode(pack);
   }
 
@@ -37,7 +37,7 @@ class Tof {
  private:
   Param param_;
 
-  System::Queue<Can::Pack> recv_ = System::Queue<Can::Pack>(1);
+  System::SpscQueue<Can::Pack, 1> recv_;
 
   System::Thread thread_;
 
@@ -25,7 +25,8 @@ Balance<Motor, MotorParam>::Balance(Param& param, float control_freq)
     : param_(param),
       offset_pid_(param.offset_pid, control_freq),
       speed_filter_(control_freq, param.speed_filter_cutoff_freq),
-      ctrl_lock_(true) {
+      ctrl_lock_(true),
+      probe_("chassis", 2000) {
   constexpr auto WHELL_NAMES = magic_enum::enum_names<Wheel>();
 
   memset(&this->move_vec_, 0, sizeof(this->move_vec_));
@@ -67,49 +68,53 @@ Balance<Motor, MotorParam>::Balance(Param& param, float control_freq)
   Component::CMD::RegisterEvent<Balance*, ChassisEvent>(event_callback, this,
                                                         this->param_.EVENT_MAP);
 
-  auto chassis_thread = [](Balance* chassis) {
-    auto raw_ref_sub = Message::Subscriber("referee", chassis->raw_ref_);
-    auto cmd_sub = Message::Subscriber("cmd_chassis", chassis->cmd_);
-    auto eulr_sub = Message::Subscriber("chassis_eulr", chassis->eulr_);
-    auto gyro_sub = Message::Subscriber("chassis_gyro", chassis->gyro_);
-    auto yaw_sub = Message::Subscriber("chassis_yaw", chassis->yaw_);
-    auto leg_sub = Message::Subscriber("leg_whell_polor", chassis->leg_);
-    auto cap_sub = Message::Subscriber("cap_info", chassis->cap_);
-
-    while (1) {
-      /* 读取控制指令、电容、裁判系统、电机反馈 */
-      cmd_sub.DumpData();
-      raw_ref_sub.DumpData();
-      eulr_sub.DumpData();
-      gyro_sub.DumpData();
-      yaw_sub.DumpData();
-      leg_sub.DumpData();
-      cap_sub.DumpData();
-
-      /* 更新反馈值 */
-      chassis->PraseRef();
-      chassis->ctrl_lock_.Take(UINT32_MAX);
-      chassis->UpdateFeedback();
-      chassis->UpdateStatus();
-      chassis->Control();
-      chassis->ctrl_lock_.Give();
-
-      /* 运行结束，等待下一次唤醒 */
-      chassis->thread_.SleepUntil(2);
-    }
+  auto chassis_init = [](Balance* chassis) {
+    chassis->cmd_sub_ = new Message::Subscriber<Component::CMD::ChassisCMD>(
+        "cmd_chassis", chassis->cmd_);
+    chassis->eulr_sub_ = new Message::Subscriber<Component::Type::Eulr>(
+        "chassis_eulr", chassis->eulr_);
+    chassis->gyro_sub_ = new Message::Subscriber<Component::Type::Vector3>(
+        "chassis_gyro", chassis->gyro_);
+    chassis->yaw_sub_ =
+        new Message::Subscriber<float>("chassis_yaw", chassis->yaw_);
+    chassis->leg_sub_ = new Message::Subscriber<Component::Type::Polar2>(
+        "leg_whell_polor", chassis->leg_);
+    chassis->cap_sub_ =
+        new Message::Subscriber<Device::Cap::Info>("cap_info", chassis->cap_);
+  };
+
+  auto chassis_step = [](Balance* chassis) {
+    /* 读取控制指令、电容、裁判系统、电机反馈 */
+    chassis->cmd_sub_->DumpData();
+    chassis->eulr_sub_->DumpData();
+    chassis->gyro_sub_->DumpData();
+    chassis->yaw_sub_->DumpData();
+    chassis->leg_sub_->DumpData();
+    chassis->cap_sub_->DumpData();
+
+    /* 裁判系统数据有变化时才更新 */
+    chassis->ref_snap_.Read(chassis->ref_, Balance::PraseRef);
+
+    /* 更新反馈值 */
+    chassis->ctrl_lock_.Take(UINT32_MAX);
+    chassis->UpdateFeedback();
+    chassis->UpdateStatus();
+    chassis->Control();
+    chassis->ctrl_lock_.Give();
   };
 
-  this->thread_.Create(chassis_thread, this, "chassis_thread",
-                       MODULE_BALANCE_TASK_STACK_DEPTH, System::Thread::MEDIUM);
+  Component::Executor::Register("chassis", 2, chassis_init, chassis_step, this,
+                                MODULE_BALANCE_TASK_STACK_DEPTH,
+                                System::Thread::MEDIUM);
 }
 
 template <typename Motor, typename MotorParam>
-void Balance<Motor, MotorParam>::PraseRef() {
-  this->ref_.chassis_power_limit =
-      this->raw_ref_.robot_status.chassis_power_limit;
-  this->ref_.chassis_pwr_buff = this->raw_ref_.power_heat.chassis_pwr_buff;
-  this->ref_.chassis_watt = this->raw_ref_.power_heat.chassis_watt;
-  this->ref_.status = this->raw_ref_.status;
+void Balance<Motor, MotorParam>::PraseRef(
+    const Device::Referee::Data& raw_ref, RefForChassis& ref) {
+  ref.chassis_power_limit = raw_ref.robot_status.chassis_power_limit;
+  ref.chassis_pwr_buff = raw_ref.power_heat.chassis_pwr_buff;
+  ref.chassis_watt = raw_ref.power_heat.chassis_watt;
+  ref.status = raw_ref.status;
 }
 
 template <typename Motor, typename MotorParam>
@@ -194,6 +199,8 @@ bool Balance<Motor, MotorParam>::LowPowerDetect() {
 
 template <typename Motor, typename MotorParam>
 void Balance<Motor, MotorParam>::Control() {
+  Component::Probe::Scope probe(this->probe_);
+
   this->now_ = bsp_time_get();
 
   this->dt_ = this->now_ - this->last_wakeup_;
@@ -209,8 +216,8 @@ void Balance<Motor, MotorParam>::Control() {
     case Balance::INDENPENDENT:
     case Balance::FOLLOW_GIMBAL:
     case Balance::ROTOR: {
-      float cos_beta = cosf(yaw_);
-      float sin_beta = sinf(yaw_);
+      float cos_beta = 0.0f, sin_beta = 0.0f;
+      Component::FastMath::SinCos(yaw_, &sin_beta, &cos_beta);
       this->move_vec_.vx = cos_beta * this->cmd_.x - sin_beta * this->cmd_.y;
       this->move_vec_.vy = sin_beta * this->cmd_.x + cos_beta * this->cmd_.y;
       this->move_vec_.wz = this->cmd_.z;
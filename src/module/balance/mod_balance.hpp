@@ -6,8 +6,10 @@
 
 #include "comp_actuator.hpp"
 #include "comp_cmd.hpp"
+#include "comp_executor.hpp"
 #include "comp_filter.hpp"
 #include "comp_pid.hpp"
+#include "comp_probe.hpp"
 #include "dev_cap.hpp"
 #include "dev_referee.hpp"
 #include "dev_rm_motor.hpp"
@@ -91,7 +93,8 @@ class Balance {
 
   void Control();
 
-  void PraseRef();
+  static void PraseRef(const Device::Referee::Data &raw_ref,
+                       RefForChassis &ref);
 
   void SetMode(Mode mode);
 
@@ -150,13 +153,23 @@ class Balance {
   Component::LowPassFilter2p speed_filter_;
 
   System::Semaphore ctrl_lock_;
-  Device::Referee::Data raw_ref_;
 
-  Component::CMD::ChassisCMD cmd_;
+  Component::Probe probe_;
 
-  System::Thread thread_;
+  Component::CMD::ChassisCMD cmd_;
 
   Message::Topic<float> speed_err_ = Message::Topic<float>("chassis_speed_err");
+
+  /* 在控制线程中创建 */
+  Message::Subscriber<Component::CMD::ChassisCMD> *cmd_sub_ = NULL;
+  Message::Subscriber<Component::Type::Eulr> *eulr_sub_ = NULL;
+  Message::Subscriber<Component::Type::Vector3> *gyro_sub_ = NULL;
+  Message::Subscriber<float> *yaw_sub_ = NULL;
+  Message::Subscriber<Component::Type::Polar2> *leg_sub_ = NULL;
+  Message::Subscriber<Device::Cap::Info> *cap_sub_ = NULL;
+
+  Component::Snapshot<Device::Referee::Data>::Reader ref_snap_ =
+      Component::Snapshot<Device::Referee::Data>::Reader("referee");
 };
 
 typedef Balance<Device::RMMotor, Device::RMMotor::Param> RMBalance;
@@ -45,15 +45,14 @@ template <typename Motor, typename MotorParam>
 Chassis<Motor, MotorParam>::Chassis(Param& param, float control_freq)
     : param_(param),
       mode_(Chassis::RELAX),
+      actuator_(param.actuator_param, control_freq),
       mixer_(param.type),
       follow_pid_(param.follow_pid_param, control_freq),
-      ctrl_lock_(true) {
+      ctrl_lock_(true),
+      probe_("chassis", 2000) {
   memset(&(this->cmd_), 0, sizeof(this->cmd_));
 
   for (uint8_t i = 0; i < this->mixer_.len_; i++) {
-    this->actuator_.at(i) =
-        new Component::SpeedActuator(param.actuator_param.at(i), control_freq);
-
     this->motor_.at(i) =
         new Motor(param.motor_param.at(i),
                   (std::string("Chassis_") + std::to_string(i)).c_str());
@@ -90,37 +89,36 @@ Chassis<Motor, MotorParam>::Chassis(Param& param, float control_freq)
   Component::CMD::RegisterEvent<Chassis*, ChassisEvent>(event_callback, this,
                                                         this->param_.EVENT_MAP);
 
-  auto chassis_thread = [](Chassis* chassis) {
-    auto raw_ref_sub = Message::Subscriber("referee", chassis->raw_ref_);
-
-    auto yaw_sub = Message::Subscriber("chassis_yaw", chassis->yaw_);
+  auto chassis_init = [](Chassis* chassis) {
+    chassis->yaw_sub_ =
+        new Message::Subscriber<float>("chassis_yaw", chassis->yaw_);
 
-    auto cmd_sub = Message::Subscriber("cmd_chassis", chassis->cmd_);
+    chassis->cmd_sub_ = new Message::Subscriber<Component::CMD::ChassisCMD>(
+        "cmd_chassis", chassis->cmd_);
 
-    auto cap_sub = Message::Subscriber("cap_info", chassis->cap_);
-
-    while (1) {
-      /* 读取控制指令、电容、裁判系统、电机反馈 */
-      yaw_sub.DumpData();
-      raw_ref_sub.DumpData();
-      cmd_sub.DumpData();
-      cap_sub.DumpData();
+    chassis->cap_sub_ =
+        new Message::Subscriber<Device::Cap::Info>("cap_info", chassis->cap_);
+  };
 
-      /* 更新反馈值 */
-      chassis->PraseRef();
+  auto chassis_step = [](Chassis* chassis) {
+    /* 读取控制指令、电容、裁判系统、电机反馈 */
+    chassis->yaw_sub_->DumpData();
+    chassis->cmd_sub_->DumpData();
+    chassis->cap_sub_->DumpData();
 
-      chassis->ctrl_lock_.Take(UINT32_MAX);
-      chassis->UpdateFeedback();
-      chassis->Control();
-      chassis->ctrl_lock_.Give();
+    /* 裁判系统数据有变化时才更新 */
+    chassis->ref_snap_.Read(chassis->ref_, Chassis::PraseRef);
 
-      /* 运行结束，等待下一次唤醒 */
-      chassis->thread_.SleepUntil(2);
-    }
+    /* 更新反馈值 */
+    chassis->ctrl_lock_.Take(UINT32_MAX);
+    chassis->UpdateFeedback();
+    chassis->Control();
+    chassis->ctrl_lock_.Give();
   };
 
-  this->thread_.Create(chassis_thread, this, "chassis_thread",
-                       MODULE_CHASSIS_TASK_STACK_DEPTH, System::Thread::MEDIUM);
+  Component::Executor::Register("chassis", 2, chassis_init, chassis_step, this,
+                                MODULE_CHASSIS_TASK_STACK_DEPTH,
+                                System::Thread::MEDIUM);
 
   System::Timer::Create(this->DrawUIStatic, this, 2100);
 
@@ -137,6 +135,8 @@ void Chassis<Motor, MotorParam>::UpdateFeedback() {
 
 template <typename Motor, typename MotorParam>
 void Chassis<Motor, MotorParam>::Control() {
+  Component::Probe::Scope probe(this->probe_);
+
   this->now_ = bsp_time_get();
 
   this->dt_ = this->now_ - this->last_wakeup_;
@@ -161,8 +161,8 @@ void Chassis<Motor, MotorParam>::Control() {
                                   */
     case Chassis::ROTOR: {
       float beta = this->yaw_;
-      float cos_beta = cosf(beta);
-      float sin_beta = sinf(beta);
+      float cos_beta = 0.0f, sin_beta = 0.0f;
+      Component::FastMath::SinCos(beta, &sin_beta, &cos_beta);
       this->move_vec_.vx = cos_beta * this->cmd_.x - sin_beta * this->cmd_.y;
       this->move_vec_.vy = sin_beta * this->cmd_.x + cos_beta * this->cmd_.y;
       break;
@@ -218,12 +218,18 @@ void Chassis<Motor, MotorParam>::Control() {
 
       clampf(&percentage, 0.0f, 1.0f);
 
+      /* 所有轮子一次计算，未使用的通道输入为零 */
+      std::array<float, 4> setpoint = {}, feedback = {}, out;
       for (unsigned i = 0; i < this->mixer_.len_; i++) {
-        float out = this->actuator_[i]->Calculate(
-            this->setpoint_.motor_rotational_speed[i] *
-                MOTOR_MAX_ROTATIONAL_SPEED,
-            this->motor_[i]->GetSpeed(), this->dt_);
-        this->motor_[i]->Control(out * percentage);
+        setpoint[i] = this->setpoint_.motor_rotational_speed[i] *
+                      MOTOR_MAX_ROTATIONAL_SPEED;
+        feedback[i] = this->motor_[i]->GetSpeed();
+      }
+
+      this->actuator_.Calculate(setpoint, feedback, this->dt_, out);
+
+      for (unsigned i = 0; i < this->mixer_.len_; i++) {
+        this->motor_[i]->Control(out[i] * percentage);
       }
 
       break;
@@ -240,17 +246,19 @@ void Chassis<Motor, MotorParam>::Control() {
 }
 
 template <typename Motor, typename MotorParam>
-void Chassis<Motor, MotorParam>::PraseRef() {
-  this->ref_.chassis_power_limit =
-      this->raw_ref_.robot_status.chassis_power_limit;
-  this->ref_.chassis_pwr_buff = this->raw_ref_.power_heat.chassis_pwr_buff;
-  this->ref_.chassis_watt = this->raw_ref_.power_heat.chassis_watt;
-  this->ref_.status = this->raw_ref_.status;
+void Chassis<Motor, MotorParam>::PraseRef(
+    const Device::Referee::Data& raw_ref, RefForChassis& ref) {
+  ref.chassis_power_limit = raw_ref.robot_status.chassis_power_limit;
+  ref.chassis_pwr_buff = raw_ref.power_heat.chassis_pwr_buff;
+  ref.chassis_watt = raw_ref.power_heat.chassis_watt;
+  ref.status = raw_ref.status;
 }
 
 template <typename Motor, typename MotorParam>
 float Chassis<Motor, MotorParam>::CalcWz(const float LO, const float HI) {
-  float wz_vary = fabsf(0.2f * sinf(ROTOR_OMEGA * this->now_)) + LO;
+  /* 相位随运行时间增大，先限制在一个周期内再使用快速正弦 */
+  float phase = fmodf(ROTOR_OMEGA * this->now_, M_2PI);
+  float wz_vary = fabsf(0.2f * Component::FastMath::Sin(phase)) + LO;
   clampf(&wz_vary, LO, HI);
   return wz_vary;
 }
@@ -266,9 +274,7 @@ void Chassis<Motor, MotorParam>::SetMode(Chassis::Mode mode) {
     this->wz_dir_mult_ = (std::rand() % 2) ? -1 : 1;
   }
   /* 切换模式后重置PID和滤波器 */
-  for (size_t i = 0; i < this->mixer_.len_; i++) {
-    this->actuator_[i]->Reset();
-  }
+  this->actuator_.Reset();
   this->mode_ = mode;
 }
 
@@ -15,9 +15,11 @@
 
 #include "comp_actuator.hpp"
 #include "comp_cmd.hpp"
+#include "comp_executor.hpp"
 #include "comp_filter.hpp"
 #include "comp_mixer.hpp"
 #include "comp_pid.hpp"
+#include "comp_probe.hpp"
 #include "dev_cap.hpp"
 #include "dev_motor.hpp"
 #include "dev_referee.hpp"
@@ -73,7 +75,8 @@ class Chassis {
 
   void PackOutput();
 
-  void PraseRef();
+  static void PraseRef(const Device::Referee::Data &raw_ref,
+                       RefForChassis &ref);
 
   static void DrawUIStatic(Chassis<Motor, MotorParam> *chassis);
 
@@ -96,7 +99,7 @@ class Chassis {
 
   Device::Cap::Info cap_;
 
-  std::array<Component::SpeedActuator *, 4> actuator_;
+  Component::SpeedActuatorBank<4> actuator_;
 
   std::array<Device::BaseMotor *, 4> motor_;
 
@@ -116,12 +119,11 @@ class Chassis {
 
   Component::PID follow_pid_; /* 跟随云台用的PID */
 
-  System::Thread thread_;
-
   System::Semaphore ctrl_lock_;
 
+  Component::Probe probe_;
+
   float yaw_;
-  Device::Referee::Data raw_ref_;
   Component::CMD::ChassisCMD cmd_;
 
   Component::UI::String string_;
@@ -129,6 +131,14 @@ class Chassis {
   Component::UI::Line line_;
 
   Component::UI::Rectangle rectange_;
+
+  /* 在控制线程中创建 */
+  Message::Subscriber<float> *yaw_sub_ = NULL;
+  Message::Subscriber<Component::CMD::ChassisCMD> *cmd_sub_ = NULL;
+  Message::Subscriber<Device::Cap::Info> *cap_sub_ = NULL;
+
+  Component::Snapshot<Device::Referee::Data>::Reader ref_snap_ =
+      Component::Snapshot<Device::Referee::Data>::Reader("referee");
 };
 
 typedef Chassis<Device::RMMotor, Device::RMMotor::Param> RMChassis;
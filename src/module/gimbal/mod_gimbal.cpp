@@ -21,7 +21,8 @@ Gimbal::Gimbal(Param& param, float control_freq)
       pit_actuator_(this->param_.pit_actr, control_freq),
       yaw_motor_(this->param_.yaw_motor, "Gimbal_Yaw"),
       pit_motor_(this->param_.pit_motor, "Gimbal_Pitch"),
-      ctrl_lock_(true) {
+      ctrl_lock_(true),
+      probe_("gimbal", 2000) {
   auto event_callback = [](GimbalEvent event, Gimbal* gimbal) {
     gimbal->ctrl_lock_.Take(UINT32_MAX);
 
@@ -43,33 +44,34 @@ Gimbal::Gimbal(Param& param, float control_freq)
   Component::CMD::RegisterEvent<Gimbal*, GimbalEvent>(event_callback, this,
                                                       this->param_.EVENT_MAP);
 
-  auto gimbal_thread = [](Gimbal* gimbal) {
-    auto eulr_sub = Message::Subscriber("imu_eulr", gimbal->eulr_);
+  auto gimbal_init = [](Gimbal* gimbal) {
+    gimbal->eulr_sub_ = new Message::Subscriber<Component::Type::Eulr>(
+        "imu_eulr", gimbal->eulr_);
 
-    auto gyro_sub = Message::Subscriber("imu_gyro", gimbal->gyro_);
+    gimbal->gyro_sub_ = new Message::Subscriber<Component::Type::Vector3>(
+        "imu_gyro", gimbal->gyro_);
 
-    auto cmd_sub = Message::Subscriber("cmd_gimbal", gimbal->cmd_);
-
-    while (1) {
-      /* 读取控制指令、姿态、IMU、电机反馈 */
-      eulr_sub.DumpData();
-      gyro_sub.DumpData();
-      cmd_sub.DumpData();
+    gimbal->cmd_sub_ = new Message::Subscriber<Component::CMD::GimbalCMD>(
+        "cmd_gimbal", gimbal->cmd_);
+  };
 
-      gimbal->ctrl_lock_.Take(UINT32_MAX);
-      gimbal->UpdateFeedback();
-      gimbal->Control();
-      gimbal->ctrl_lock_.Give();
+  auto gimbal_step = [](Gimbal* gimbal) {
+    /* 读取控制指令、姿态、IMU、电机反馈 */
+    gimbal->eulr_sub_->DumpData();
+    gimbal->gyro_sub_->DumpData();
+    gimbal->cmd_sub_->DumpData();
 
-      gimbal->yaw_tp_.Publish(gimbal->yaw_);
+    gimbal->ctrl_lock_.Take(UINT32_MAX);
+    gimbal->UpdateFeedback();
+    gimbal->Control();
+    gimbal->ctrl_lock_.Give();
 
-      /* 运行结束，等待下一次唤醒 */
-      gimbal->thread_.SleepUntil(2);
-    }
+    gimbal->yaw_tp_.Publish(gimbal->yaw_);
   };
 
-  this->thread_.Create(gimbal_thread, this, "gimbal_thread",
-                       MODULE_GIMBAL_TASK_STACK_DEPTH, System::Thread::MEDIUM);
+  Component::Executor::Register("gimbal", 2, gimbal_init, gimbal_step, this,
+                                MODULE_GIMBAL_TASK_STACK_DEPTH,
+                                System::Thread::MEDIUM);
 
   System::Timer::Create(this->DrawUIStatic, this, 2000);
 
@@ -84,6 +86,8 @@ void Gimbal::UpdateFeedback() {
 }
 
 void Gimbal::Control() {
+  Component::Probe::Scope probe(this->probe_);
+
   this->now_ = bsp_time_get();
   this->dt_ = this->now_ - this->last_wakeup_;
   this->last_wakeup_ = this->now_;
@@ -10,9 +10,11 @@
 
 #include "comp_actuator.hpp"
 #include "comp_cf.hpp"
+#include "comp_executor.hpp"
 #include "comp_cmd.hpp"
 #include "comp_filter.hpp"
 #include "comp_pid.hpp"
+#include "comp_probe.hpp"
 #include "dev_ahrs.hpp"
 #include "dev_bmi088.hpp"
 #include "dev_referee.hpp"
@@ -98,10 +100,10 @@ class Gimbal {
   Device::RMMotor yaw_motor_;
   Device::RMMotor pit_motor_;
 
-  System::Thread thread_;
-
   System::Semaphore ctrl_lock_;
 
+  Component::Probe probe_;
+
   Message::Topic<float> yaw_tp_ = Message::Topic<float>("chassis_yaw");
 
   float yaw_;
@@ -115,5 +117,10 @@ class Gimbal {
   Component::Type::Eulr eulr_;
   Component::Type::Vector3 gyro_;
   Component::CMD::GimbalCMD cmd_;
+
+  /* 在控制线程中创建 */
+  Message::Subscriber<Component::Type::Eulr> *eulr_sub_ = NULL;
+  Message::Subscriber<Component::Type::Vector3> *gyro_sub_ = NULL;
+  Message::Subscriber<Component::CMD::GimbalCMD> *cmd_sub_ = NULL;
 };
 }  // namespace Module
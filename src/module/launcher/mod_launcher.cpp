@@ -19,7 +19,10 @@
 using namespace Module;
 
 Launcher::Launcher(Param& param, float control_freq)
-    : param_(param), ctrl_lock_(true) {
+    : param_(param),
+      fric_actuator_(param.fric_actr, control_freq),
+      ctrl_lock_(true),
+      probe_("launcher", 2000) {
   for (size_t i = 0; i < LAUNCHER_ACTR_TRIG_NUM; i++) {
     this->trig_actuator_.at(i) =
         new Component::PosActuator(param.trig_actr.at(i), control_freq);
@@ -30,9 +33,6 @@ Launcher::Launcher(Param& param, float control_freq)
   }
 
   for (size_t i = 0; i < LAUNCHER_ACTR_FRIC_NUM; i++) {
-    this->fric_actuator_.at(i) =
-        new Component::SpeedActuator(param.fric_actr.at(i), control_freq);
-
     this->fric_motor_.at(i) =
         new Device::RMMotor(this->param_.fric_motor.at(i),
                             ("Launcher_Fric" + std::to_string(i)).c_str());
@@ -83,36 +83,30 @@ Launcher::Launcher(Param& param, float control_freq)
   bsp_pwm_start(BSP_PWM_LAUNCHER_SERVO);
   bsp_pwm_set_comp(BSP_PWM_LAUNCHER_SERVO, this->param_.cover_close_duty);
 
-  auto launcher_thread = [](Launcher* launcher) {
-    auto ref_sub = Message::Subscriber("referee", launcher->raw_ref_);
-
-    while (1) {
-      ref_sub.DumpData();
+  auto launcher_init = [](Launcher* launcher) { (void)(launcher); };
 
-      launcher->PraseRef();
+  auto launcher_step = [](Launcher* launcher) {
+    launcher->ref_snap_.Read(launcher->ref_, Launcher::PraseRef);
 
-      launcher->ctrl_lock_.Take(UINT32_MAX);
-
-      launcher->UpdateFeedback();
-      launcher->Control();
+    launcher->ctrl_lock_.Take(UINT32_MAX);
 
-      launcher->ctrl_lock_.Give();
+    launcher->UpdateFeedback();
+    launcher->Control();
 
-      /* 运行结束，等待下一次唤醒 */
-      launcher->thread_.SleepUntil(2);
-    }
+    launcher->ctrl_lock_.Give();
   };
 
-  this->thread_.Create(launcher_thread, this, "launcher_thread",
-                       MODULE_LAUNCHER_TASK_STACK_DEPTH,
-                       System::Thread::MEDIUM);
+  Component::Executor::Register("launcher", 2, launcher_init, launcher_step,
+                                this, MODULE_LAUNCHER_TASK_STACK_DEPTH,
+                                System::Thread::MEDIUM);
   System::Timer::Create(this->DrawUIStatic, this, 2200);
 
   System::Timer::Create(this->DrawUIDynamic, this, 100);
 }
 
 void Launcher::UpdateFeedback() {
-  const float LAST_TRIG_MOTOR_ANGLE = this->trig_motor_[0]->GetAngle();
+  const Component::Type::BinaryAngle LAST_TRIG_MOTOR_ANGLE =
+      this->trig_motor_[0]->GetBinaryAngle();
 
   for (size_t i = 0; i < LAUNCHER_ACTR_FRIC_NUM; i++) {
     this->fric_motor_[i]->Update();
@@ -122,12 +116,18 @@ void Launcher::UpdateFeedback() {
     this->trig_motor_[i]->Update();
   }
 
-  const float DELTA_MOTOR_ANGLE =
-      this->trig_motor_[0]->GetAngle() - LAST_TRIG_MOTOR_ANGLE;
-  this->trig_angle_ += DELTA_MOTOR_ANGLE / this->param_.trig_gear_ratio;
+  /* 电机转过的角度用整数累加，每次重新换算，不会累积浮点误差 */
+  const Component::Type::BinaryAngle DELTA_MOTOR_ANGLE =
+      this->trig_motor_[0]->GetBinaryAngle() - LAST_TRIG_MOTOR_ANGLE;
+  this->trig_motor_count_ += DELTA_MOTOR_ANGLE.Signed();
+  this->trig_angle_ = static_cast<float>(this->trig_motor_count_) *
+                      Component::Type::BinaryAngle::RAD_PER_LSB /
+                      this->param_.trig_gear_ratio;
 }
 
 void Launcher::Control() {
+  Component::Probe::Scope probe(this->probe_);
+
   this->now_ = bsp_time_get();
   this->dt_ = this->now_ - this->last_wakeup_;
   this->last_wakeup_ = this->now_;
@@ -226,6 +226,8 @@ void Launcher::Control() {
     }
   }
 
+  std::array<float, LAUNCHER_ACTR_FRIC_NUM> fric_speed, fric_out;
+
   switch (this->fire_ctrl_.fire_mode_) {
     case RELAX:
       for (size_t i = 0; i < LAUNCHER_ACTR_TRIG_NUM; i++) {
@@ -249,13 +251,16 @@ void Launcher::Control() {
         this->trig_motor_[i]->Control(trig_out);
       }
 
+      /* 控制摩擦轮 */
       for (size_t i = 0; i < LAUNCHER_ACTR_FRIC_NUM; i++) {
-        /* 控制摩擦轮 */
-        float fric_out = this->fric_actuator_[i]->Calculate(
-            this->setpoint_.fric_rpm_[i], this->fric_motor_[i]->GetSpeed(),
-            this->dt_);
+        fric_speed[i] = this->fric_motor_[i]->GetSpeed();
+      }
+
+      this->fric_actuator_.Calculate(this->setpoint_.fric_rpm_, fric_speed,
+                                     this->dt_, fric_out);
 
-        this->fric_motor_[i]->Control(fric_out);
+      for (size_t i = 0; i < LAUNCHER_ACTR_FRIC_NUM; i++) {
+        this->fric_motor_[i]->Control(fric_out[i]);
       }
 
       /* 根据弹仓盖开关状态更新弹舱盖打开时舵机PWM占空比 */
@@ -283,9 +288,7 @@ void Launcher::SetFireMode(FireMode mode) {
     return;
   }
 
-  for (size_t i = 0; i < LAUNCHER_ACTR_FRIC_NUM; i++) {
-    this->fric_actuator_[i]->Reset();
-  }
+  this->fric_actuator_.Reset();
 
   if (mode == LOADED) {
     this->fire_ctrl_.to_launch = 0;
@@ -332,14 +335,14 @@ void Launcher::HeatLimit() {
   }
 }
 
-void Launcher::PraseRef() {
-  memcpy(&(this->ref_.power_heat), &(this->raw_ref_.power_heat),
-         sizeof(this->ref_.power_heat));
-  memcpy(&(this->ref_.robot_status), &(this->raw_ref_.robot_status),
-         sizeof(this->ref_.robot_status));
-  memcpy(&(this->ref_.launcher_data), &(this->raw_ref_.launcher_data),
-         sizeof(this->ref_.launcher_data));
-  this->ref_.status = this->raw_ref_.status;
+void Launcher::PraseRef(const Device::Referee::Data& raw_ref,
+                        RefForLauncher& ref) {
+  memcpy(&(ref.power_heat), &(raw_ref.power_heat), sizeof(ref.power_heat));
+  memcpy(&(ref.robot_status), &(raw_ref.robot_status),
+         sizeof(ref.robot_status));
+  memcpy(&(ref.launcher_data), &(raw_ref.launcher_data),
+         sizeof(ref.launcher_data));
+  ref.status = raw_ref.status;
 }
 
 float Launcher::LimitLauncherFreq() {
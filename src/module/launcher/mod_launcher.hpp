@@ -15,8 +15,10 @@
 
 #include "comp_actuator.hpp"
 #include "comp_cmd.hpp"
+#include "comp_executor.hpp"
 #include "comp_filter.hpp"
 #include "comp_pid.hpp"
+#include "comp_probe.hpp"
 #include "dev_referee.hpp"
 #include "dev_rm_motor.hpp"
 
@@ -144,7 +146,8 @@ class Launcher {
 
   float LimitLauncherFreq();
 
-  void PraseRef();
+  static void PraseRef(const Device::Referee::Data &raw_ref,
+                       RefForLauncher &ref);
 
   static void DrawUIStatic(Launcher *launcher);
 
@@ -159,6 +162,8 @@ class Launcher {
 
   float trig_angle_;
 
+  int64_t trig_motor_count_ = 0; /* 拨弹电机转过的总角度，单位：BinaryAngle */
+
   Param param_;
 
   CoverMode cover_mode_ = CLOSE; /* 弹舱盖模式 */
@@ -173,23 +178,24 @@ class Launcher {
   FireControl fire_ctrl_;
 
   std::array<Component::PosActuator *, LAUNCHER_ACTR_TRIG_NUM> trig_actuator_;
-  std::array<Component::SpeedActuator *, LAUNCHER_ACTR_FRIC_NUM> fric_actuator_;
+  Component::SpeedActuatorBank<LAUNCHER_ACTR_FRIC_NUM> fric_actuator_;
 
   std::array<Device::RMMotor *, LAUNCHER_ACTR_TRIG_NUM> trig_motor_;
   std::array<Device::RMMotor *, LAUNCHER_ACTR_FRIC_NUM> fric_motor_;
 
   RefForLauncher ref_;
 
-  System::Thread thread_;
-
   System::Semaphore ctrl_lock_;
 
-  Device::Referee::Data raw_ref_;
+  Component::Probe probe_;
 
   Component::UI::String string_;
 
   Component::UI::Rectangle rectangle_;
 
   Component::UI::Arc arc_;
+
+  Component::Snapshot<Device::Referee::Data>::Reader ref_snap_ =
+      Component::Snapshot<Device::Referee::Data>::Reader("referee");
 };
 }  // namespace Module
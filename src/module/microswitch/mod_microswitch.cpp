@@ -48,14 +48,16 @@ void MicroSwitch::TransData() {
   }
 
   if (bsp_time_get_ms() - last_send_time_ >= delay) {
-    last_send_time_ = bsp_time_get_ms();
     for (int i = 0; i < SWITCH_NUM; i++) {
       send_buff_.data[i * 2] = i;
       send_buff_.data[i * 2 + 1] = gpio_status_[i];
     }
     send_buff_.index = can_id_.data_;
 
-    Device::Can::SendStdPack(BSP_CAN_1, send_buff_);
+    /* 发送失败时不更新时间，下次立即重发 */
+    if (Device::Can::SendStdPack(BSP_CAN_1, send_buff_)) {
+      last_send_time_ = bsp_time_get_ms();
+    }
   }
 }
 
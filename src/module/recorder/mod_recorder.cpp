@@ -0,0 +1,478 @@
+#include "mod_recorder.hpp"
+
+#ifdef MODULE_RECORDER_FILE
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include "bsp_time.h"
+
+using namespace Module;
+
+/* pos小于cap，len不大于cap */
+static void ring_write(uint8_t* ring, uint32_t cap, uint32_t pos,
+                       const void* src, uint32_t len) {
+  uint32_t first = cap - pos < len ? cap - pos : len;
+  memcpy(ring + pos, src, first);
+  memcpy(ring, static_cast<const uint8_t*>(src) + first, len - first);
+}
+
+static void ring_read(const uint8_t* ring, uint32_t cap, uint32_t pos,
+                      void* dst, uint32_t len) {
+  uint32_t first = cap - pos < len ? cap - pos : len;
+  memcpy(dst, ring + pos, first);
+  memcpy(static_cast<uint8_t*>(dst) + first, ring, len - first);
+}
+
+Recorder::Recorder(Param& param)
+    : param_(param),
+      recording_(false),
+      replay_(false),
+      replay_speed_(param.speed),
+      lock_(true),
+      cmd_(this, RecorderCMD, "recorder") {
+  ASSERT(param_.topics.size() > 0);
+  ASSERT(param_.topics.size() <= RECORDER_TOPIC_MAX_NUM);
+
+  replay_file_[0] = '\0';
+
+  this->channel_ = new Channel[param_.topics.size()]();
+
+  if (param_.replay) {
+    ASSERT(param_.file);
+    strncpy(replay_file_.data(), param_.file, replay_file_.size() - 1);
+    replay_file_[replay_file_.size() - 1] = '\0';
+    this->replay_ = true;
+  } else if (!this->OpenStorage()) {
+    OMLOG_ERROR("recorder: 无法创建记录区");
+  } else {
+    for (uint16_t i = 0; i < param_.topics.size(); i++) {
+      Channel& channel = this->channel_[i];
+      channel.recorder = this;
+      channel.index = i;
+
+      om_topic_t* topic = static_cast<om_topic_t*>(
+          Message::Topic<uint8_t>::Find(param_.topics[i]));
+      if (topic == NULL) {
+        OMLOG_WARNING("recorder: 找不到话题%s", param_.topics[i]);
+        continue;
+      }
+
+      /* 原话题的回调可能已被Trigger等占用，Link到记录仪自己的话题上，
+         回调在发布者的上下文中运行，只做一次拷贝 */
+      Message::Topic<uint8_t> source(topic);
+      auto forward = new Message::Topic<uint8_t>(
+          ("rec_" + std::string(param_.topics[i])).c_str());
+      forward->Link(source);
+      om_config_topic(forward->om_topic_, "d", RecordCallback, &channel);
+    }
+
+    this->recording_ = true;
+  }
+
+  auto recorder_thread = [](Recorder* recorder) {
+    while (1) {
+      if (recorder->replay_.load(std::memory_order_acquire)) {
+        bool recording = recorder->recording_;
+        recorder->recording_ = false;
+
+        /* 回放前先把缓冲区中的记录写完，回放期间不记录 */
+        recorder->WriteRecords();
+
+        if (recorder->replay_file_[0] == '\0') {
+          if (recorder->storage_ != NULL) {
+            recorder->Replay(recorder->storage_, recorder->replay_speed_);
+          }
+        } else {
+#ifdef MODULE_RECORDER_FILE
+          size_t len = 0;
+          const uint8_t* file = MapFile(recorder->replay_file_.data(), len);
+          if (file != NULL) {
+            recorder->Replay(file, recorder->replay_speed_);
+            munmap(const_cast<uint8_t*>(file), len);
+          } else {
+            OMLOG_ERROR("recorder: 无法打开%s", recorder->replay_file_.data());
+          }
+#endif
+        }
+
+        recorder->replay_ = false;
+        recorder->recording_ = recording;
+      }
+
+      recorder->WriteRecords();
+
+      recorder->thread_.Sleep(RECORDER_WRITE_CYCLE);
+    }
+  };
+
+  this->thread_.Create(recorder_thread, this, "recorder_thread",
+                       MODULE_RECORDER_TASK_STACK_DEPTH, System::Thread::LOW);
+}
+
+bool Recorder::OpenStorage() {
+  uint32_t topic_num = static_cast<uint32_t>(param_.topics.size());
+  size_t total = sizeof(FileHeader) + topic_num * RECORDER_NAME_LEN +
+                 param_.size;
+
+#ifdef MODULE_RECORDER_FILE
+  ASSERT(param_.file);
+
+  /* 保留上一次的记录 */
+  std::string old = std::string(param_.file) + ".old";
+  rename(param_.file, old.c_str());
+
+  int fd = open(param_.file, O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0) {
+    return false;
+  }
+
+  /* 提前分配磁盘空间，记录过程中不会因为空间不足产生SIGBUS */
+  if (posix_fallocate(fd, 0, static_cast<off_t>(total)) != 0) {
+    close(fd);
+    return false;
+  }
+
+  void* addr = mmap(NULL, total, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+
+  if (addr == MAP_FAILED) {
+    return false;
+  }
+
+  this->storage_ = static_cast<uint8_t*>(addr);
+#else
+  this->storage_ = new uint8_t[total];
+#endif
+
+  memset(this->storage_, 0, sizeof(FileHeader) + topic_num * RECORDER_NAME_LEN);
+
+  for (uint32_t i = 0; i < topic_num; i++) {
+    strncpy(reinterpret_cast<char*>(this->storage_ + sizeof(FileHeader) +
+                                    i * RECORDER_NAME_LEN),
+            param_.topics[i], RECORDER_NAME_LEN - 1);
+  }
+
+  this->header_ = reinterpret_cast<FileHeader*>(this->storage_);
+  this->header_->topic_num = static_cast<uint16_t>(topic_num);
+  this->header_->version = RECORDER_VERSION;
+  this->header_->capacity = param_.size;
+  this->header_->magic = RECORDER_MAGIC;
+
+  return true;
+}
+
+#ifdef MODULE_RECORDER_FILE
+const uint8_t* Recorder::MapFile(const char* path, size_t& len) {
+  int fd = open(path, O_RDONLY);
+  if (fd < 0) {
+    return NULL;
+  }
+
+  off_t size = lseek(fd, 0, SEEK_END);
+  if (size < static_cast<off_t>(sizeof(FileHeader))) {
+    close(fd);
+    return NULL;
+  }
+
+  void* addr = mmap(NULL, static_cast<size_t>(size), PROT_READ, MAP_SHARED,
+                    fd, 0);
+  close(fd);
+
+  if (addr == MAP_FAILED) {
+    return NULL;
+  }
+
+  len = static_cast<size_t>(size);
+
+  const FileHeader* header = static_cast<const FileHeader*>(addr);
+  if (header->magic != RECORDER_MAGIC || header->version != RECORDER_VERSION ||
+      sizeof(FileHeader) + header->topic_num * RECORDER_NAME_LEN +
+              header->capacity >
+          len) {
+    munmap(addr, len);
+    return NULL;
+  }
+
+  return static_cast<const uint8_t*>(addr);
+}
+#endif
+
+om_status_t Recorder::RecordCallback(om_msg_t* msg, void* arg) {
+  Channel* channel = static_cast<Channel*>(arg);
+
+  if (!channel->recorder->recording_.load(std::memory_order_relaxed)) {
+    return OM_OK;
+  }
+
+  /* 缓冲区只允许一个生产者，多个发布者同时发布时丢弃后进入的一条 */
+  if (channel->writing.exchange(true, std::memory_order_acquire)) {
+    channel->dropped.fetch_add(1, std::memory_order_relaxed);
+    return OM_OK;
+  }
+
+  uint32_t len = RecordLen(msg->size);
+  uint32_t head = channel->head.load(std::memory_order_relaxed);
+  uint32_t tail = channel->tail.load(std::memory_order_acquire);
+
+  if (len > RECORDER_CHANNEL_SIZE / 2 ||
+      RECORDER_CHANNEL_SIZE - (head - tail) < len) {
+    channel->dropped.fetch_add(1, std::memory_order_relaxed);
+  } else {
+    RecordHeader record;
+    record.time = bsp_time_get_us();
+    record.topic = channel->index;
+    record.size = static_cast<uint16_t>(msg->size);
+
+    uint32_t pos = head & (RECORDER_CHANNEL_SIZE - 1);
+    ring_write(channel->buff, RECORDER_CHANNEL_SIZE, pos, &record,
+               sizeof(record));
+    pos = (pos + sizeof(record)) & (RECORDER_CHANNEL_SIZE - 1);
+    ring_write(channel->buff, RECORDER_CHANNEL_SIZE, pos, msg->buff,
+               msg->size);
+
+    channel->count++;
+    channel->head.store(head + len, std::memory_order_release);
+  }
+
+  channel->writing.store(false, std::memory_order_release);
+
+  return OM_OK;
+}
+
+void Recorder::WriteRecords() {
+  if (this->storage_ == NULL) {
+    return;
+  }
+
+  this->lock_.Take(UINT32_MAX);
+
+  /* 每次取出各缓冲区中时间最早的一条，记录区按时间排序 */
+  while (1) {
+    Channel* next = NULL;
+    RecordHeader next_record = {};
+
+    for (uint32_t i = 0; i < param_.topics.size(); i++) {
+      Channel& channel = this->channel_[i];
+      uint32_t tail = channel.tail.load(std::memory_order_relaxed);
+      if (channel.head.load(std::memory_order_acquire) == tail) {
+        continue;
+      }
+
+      RecordHeader record;
+      ring_read(channel.buff, RECORDER_CHANNEL_SIZE,
+                tail & (RECORDER_CHANNEL_SIZE - 1), &record, sizeof(record));
+      if (next == NULL ||
+          static_cast<int32_t>(record.time - next_record.time) < 0) {
+        next = &channel;
+        next_record = record;
+      }
+    }
+
+    if (next == NULL) {
+      break;
+    }
+
+    uint32_t tail = next->tail.load(std::memory_order_relaxed);
+    uint32_t len = RecordLen(next_record.size);
+    ring_read(next->buff, RECORDER_CHANNEL_SIZE,
+              tail & (RECORDER_CHANNEL_SIZE - 1), this->record_.data(), len);
+    next->tail.store(tail + len, std::memory_order_release);
+
+    this->Store(this->record_.data(), len);
+  }
+
+  uint32_t dropped = this->overwritten_;
+  for (uint32_t i = 0; i < param_.topics.size(); i++) {
+    dropped += this->channel_[i].dropped.load(std::memory_order_relaxed);
+  }
+  this->header_->dropped = dropped;
+
+  this->lock_.Give();
+}
+
+void Recorder::Store(const uint8_t* record, uint32_t len) {
+  uint8_t* ring = Ring(this->storage_);
+  FileHeader* header = this->header_;
+
+  if (len > header->capacity) {
+    return;
+  }
+
+  /* 空间不足时覆盖最早的记录 */
+  while (header->used + len > header->capacity) {
+    RecordHeader old;
+    ring_read(ring, header->capacity, header->begin, &old, sizeof(old));
+    uint32_t old_len = RecordLen(old.size);
+    header->begin = (header->begin + old_len) % header->capacity;
+    header->used -= old_len;
+    this->overwritten_++;
+  }
+
+  ring_write(ring, header->capacity,
+             (header->begin + header->used) % header->capacity, record, len);
+  header->used += len;
+}
+
+void Recorder::Replay(const uint8_t* storage, float speed) {
+  const FileHeader* header = reinterpret_cast<const FileHeader*>(storage);
+
+  if (header->magic != RECORDER_MAGIC || header->version != RECORDER_VERSION ||
+      header->topic_num > RECORDER_TOPIC_MAX_NUM) {
+    OMLOG_ERROR("recorder: 记录格式错误");
+    return;
+  }
+
+  /* 按名字找到当前程序中的话题，找不到的话题跳过 */
+  for (uint32_t i = 0; i < header->topic_num; i++) {
+    std::array<char, RECORDER_NAME_LEN> name;
+    memcpy(name.data(), storage + sizeof(FileHeader) + i * RECORDER_NAME_LEN,
+           RECORDER_NAME_LEN);
+    name[RECORDER_NAME_LEN - 1] = '\0';
+
+    this->replay_topic_[i] =
+        static_cast<om_topic_t*>(Message::Topic<uint8_t>::Find(name.data()));
+    if (this->replay_topic_[i] == NULL) {
+      OMLOG_WARNING("recorder: 找不到话题%s", name.data());
+    }
+  }
+
+  const uint8_t* ring = Ring(storage);
+  uint32_t pos = header->begin, remain = header->used;
+  uint32_t start = bsp_time_get_us(), last_time = 0, count = 0;
+  uint64_t record_time = 0;
+
+  while (remain >= sizeof(RecordHeader)) {
+    RecordHeader record;
+    ring_read(ring, header->capacity, pos, &record, sizeof(record));
+
+    uint32_t len = RecordLen(record.size);
+    if (len > remain) {
+      break;
+    }
+
+    if (count > 0) {
+      record_time += record.time - last_time;
+    }
+    last_time = record.time;
+
+    /* 不足1ms的间隔不等待，和后面的记录一起发布 */
+    if (speed > 0.0f) {
+      uint64_t target = static_cast<uint64_t>(
+          static_cast<float>(record_time) / speed);
+      uint32_t now = bsp_time_get_us() - start;
+      if (target >= now + 1000) {
+        System::Thread::Sleep(static_cast<uint32_t>((target - now) / 1000));
+      }
+    }
+
+    if (record.topic < header->topic_num &&
+        this->replay_topic_[record.topic] != NULL &&
+        record.size <= this->record_.size()) {
+      ring_read(ring, header->capacity,
+                (pos + sizeof(record)) % header->capacity,
+                this->record_.data(), record.size);
+      om_publish(this->replay_topic_[record.topic], this->record_.data(),
+                 record.size, true, false);
+    }
+
+    pos = (pos + len) % header->capacity;
+    remain -= len;
+    count++;
+  }
+
+  OMLOG_PASS("recorder: 回放完成，共%u条记录", static_cast<unsigned>(count));
+}
+
+void Recorder::Dump() {
+  this->lock_.Take(UINT32_MAX);
+
+  /* 导出时整理成从头开始的线性记录区，可以直接用于回放 */
+  FileHeader header = *this->header_;
+  header.begin = 0;
+  header.capacity = header.used;
+
+  const uint8_t* ring = Ring(this->storage_);
+  uint32_t names_len = header.topic_num * RECORDER_NAME_LEN;
+  uint32_t total = static_cast<uint32_t>(sizeof(header)) + names_len +
+                   header.used;
+
+  for (uint32_t i = 0; i < total; i++) {
+    uint8_t byte = 0;
+    if (i < sizeof(header)) {
+      byte = reinterpret_cast<const uint8_t*>(&header)[i];
+    } else if (i < sizeof(header) + names_len) {
+      byte = this->storage_[i];
+    } else {
+      uint32_t offset = i - static_cast<uint32_t>(sizeof(header)) - names_len;
+      byte = ring[(this->header_->begin + offset) % this->header_->capacity];
+    }
+
+    printf("%02x", byte);
+    if (i % 32 == 31 || i == total - 1) {
+      printf("\r\n");
+    }
+  }
+
+  this->lock_.Give();
+}
+
+void Recorder::ShowInfo() {
+  printf("话题\t\t\t记录\t丢弃\r\n");
+  for (uint32_t i = 0; i < param_.topics.size(); i++) {
+    printf("%-24s%u\t%u\r\n", param_.topics[i],
+           static_cast<unsigned>(this->channel_[i].count),
+           static_cast<unsigned>(this->channel_[i].dropped.load()));
+  }
+
+  if (this->header_ != NULL) {
+    printf("记录区:%u/%u字节 覆盖:%u 状态:%s\r\n",
+           static_cast<unsigned>(this->header_->used),
+           static_cast<unsigned>(this->header_->capacity),
+           static_cast<unsigned>(this->overwritten_),
+           this->replay_ ? "回放" : (this->recording_ ? "记录" : "停止"));
+  }
+}
+
+int Recorder::RecorderCMD(Recorder* recorder, int argc, char** argv) {
+  if (argc == 1) {
+    printf("info                 显示记录状态\r\n");
+    printf("start/stop           开始/停止记录\r\n");
+    printf("dump                 以十六进制导出记录，可用xxd -r -p还原\r\n");
+    printf("replay [speed] [file] 按倍速回放，file只在Linux上可用\r\n");
+  } else if (argc == 2 && strcmp(argv[1], "info") == 0) {
+    recorder->ShowInfo();
+  } else if (argc == 2 && (strcmp(argv[1], "start") == 0 ||
+                           strcmp(argv[1], "stop") == 0)) {
+    if (recorder->storage_ == NULL || recorder->replay_) {
+      printf("记录区不可用\r\n");
+    } else {
+      recorder->recording_ = strcmp(argv[1], "start") == 0;
+    }
+  } else if (argc == 2 && strcmp(argv[1], "dump") == 0) {
+    if (recorder->storage_ == NULL) {
+      printf("记录区不可用\r\n");
+    } else {
+      recorder->Dump();
+    }
+  } else if (argc >= 2 && argc <= 4 && strcmp(argv[1], "replay") == 0) {
+    if (recorder->replay_) {
+      printf("正在回放\r\n");
+      return 0;
+    }
+
+    recorder->replay_speed_ = argc >= 3 ? std::stof(argv[2]) : 1.0f;
+    recorder->replay_file_[0] = '\0';
+    if (argc == 4) {
+      strncpy(recorder->replay_file_.data(), argv[3],
+              recorder->replay_file_.size() - 1);
+      recorder->replay_file_[recorder->replay_file_.size() - 1] = '\0';
+    }
+    recorder->replay_.store(true, std::memory_order_release);
+  } else {
+    printf("命令错误\r\n");
+  }
+
+  return 0;
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <atomic>
+#include <vector>
+
+#include "module.hpp"
+
+#define RECORDER_MAGIC (0x43525258) /* "XRRC" */
+#define RECORDER_VERSION (1)
+#define RECORDER_NAME_LEN (32)
+#define RECORDER_TOPIC_MAX_NUM (32)
+#define RECORDER_CHANNEL_SIZE (1024) /* 每个话题的缓冲区大小，必须为2的幂 */
+#define RECORDER_WRITE_CYCLE (10)    /* 写入线程周期(ms) */
+
+namespace Module {
+/* 话题记录仪。发布线程只把数据拷贝进各话题的缓冲区，
+   写入线程按时间顺序合并到记录区；Linux上记录区是预分配的映射文件，
+   MCU上是RAM环形缓冲区，写满后覆盖最早的记录 */
+class Recorder {
+ public:
+  typedef struct {
+    std::vector<const char*> topics;
+    const char* file; /* 记录文件路径，只在Linux上使用 */
+    uint32_t size;    /* 记录区大小(字节) */
+    bool replay;      /* 启动后回放file，不记录 */
+    float speed;      /* 回放倍速，不大于0时不等待 */
+  } Param;
+
+  typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t topic_num;
+    uint32_t capacity; /* 记录区大小 */
+    uint32_t begin;    /* 最早一条记录在记录区中的偏移 */
+    uint32_t used;     /* 记录区已使用的字节数 */
+    uint32_t dropped;  /* 话题缓冲区满、发布冲突或被覆盖丢弃的记录数 */
+  } FileHeader;
+
+  /* 记录区中的记录，数据按4字节对齐 */
+  typedef struct {
+    uint32_t time; /* 微秒 */
+    uint16_t topic;
+    uint16_t size;
+  } RecordHeader;
+
+  /* 单生产者单消费者，生产者为话题的发布者。话题有多个发布者时由writing
+     保证同一时刻只有一个生产者写入，同时发布的另一条记录被丢弃 */
+  typedef struct {
+    Recorder* recorder;
+    std::atomic<uint32_t> head;
+    std::atomic<uint32_t> tail;
+    std::atomic<bool> writing; /* 生产者正在写入 */
+    uint16_t index;
+    uint32_t count;                /* 写入缓冲区的记录数 */
+    std::atomic<uint32_t> dropped; /* 缓冲区满或发布冲突丢弃的记录数 */
+    uint8_t buff[RECORDER_CHANNEL_SIZE];  // NOLINT(modernize-avoid-c-arrays)
+  } Channel;
+
+  Recorder(Param& param);
+
+  static int RecorderCMD(Recorder* recorder, int argc, char** argv);
+
+ private:
+  static om_status_t RecordCallback(om_msg_t* msg, void* arg);
+
+  bool OpenStorage();
+
+  static const uint8_t* MapFile(const char* path, size_t& len);
+
+  void WriteRecords();
+
+  void Store(const uint8_t* record, uint32_t len);
+
+  void Replay(const uint8_t* storage, float speed);
+
+  void Dump();
+
+  void ShowInfo();
+
+  static uint32_t RecordLen(uint32_t size) {
+    return static_cast<uint32_t>(sizeof(RecordHeader)) + ((size + 3) & ~3U);
+  }
+
+  static uint8_t* Ring(const uint8_t* storage) {
+    const FileHeader* header = reinterpret_cast<const FileHeader*>(storage);
+    return const_cast<uint8_t*>(storage) + sizeof(FileHeader) +
+           header->topic_num * RECORDER_NAME_LEN;
+  }
+
+  Param param_;
+
+  Channel* channel_;
+
+  uint8_t* storage_ = NULL;
+  FileHeader* header_ = NULL;
+
+  uint32_t overwritten_ = 0;
+
+  std::array<om_topic_t*, RECORDER_TOPIC_MAX_NUM> replay_topic_;
+
+  /* 写入线程的暂存区，一条记录不超过话题缓冲区的一半 */
+  std::array<uint8_t, RECORDER_CHANNEL_SIZE / 2> record_;
+
+  std::atomic<bool> recording_;
+  std::atomic<bool> replay_;
+  float replay_speed_;
+  std::array<char, 64> replay_file_;
+
+  /* 写入线程写记录区时持有，导出时暂停写入 */
+  System::Semaphore lock_;
+
+  System::Thread thread_;
+
+  System::Term::Command<Recorder*> cmd_;
+};
+}  // namespace Module
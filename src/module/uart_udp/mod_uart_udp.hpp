@@ -13,6 +13,7 @@
 #include "module.hpp"
 #include "ms.h"
 #include "om_log.h"
+#include "system_log.hpp"
 #include "wearlab.hpp"
 
 namespace Module {
@@ -46,11 +47,11 @@ class UartToUDP {
         memcpy(&udp->udp_rx_[data->area_id], data,
                sizeof(Device::WearLab::UdpData));
         udp->udp_rx_sem_[data->area_id]->Give();
-        OMLOG_PASS("udp pack received.");
+        DLOG_PASS("udp pack received.");
         return;
       }
 
-      OMLOG_ERROR("udp receive pack error. len:%d", size);
+      DLOG_ERROR("udp receive pack error. len:%d", size);
     };
 
     bsp_udp_register_callback(&udp_server_, BSP_UDP_RX_CPLT_CB, udp_rx_cb,
@@ -76,8 +77,8 @@ class UartToUDP {
                          sizeof(uart_udp->uart_rx_[uart]), true);
         if (uart_udp->uart_rx_[uart].end != 0xe3) {
           bsp_uart_abort_receive(uart);
-          OMLOG_ERROR("uart %d receive data error. end:%d", uart,
-                      uart_udp->uart_rx_[uart].end);
+          DLOG_ERROR("uart %d receive data error. end:%d", uart,
+                     uart_udp->uart_rx_[uart].end);
           continue;
         } else {
           uart_udp->header_[uart].raw = uart_udp->uart_rx_[uart].id;
@@ -100,8 +101,8 @@ class UartToUDP {
                    1000) {
               uart_udp->last_log_time[uart] += 1000;
             }
-            OMLOG_NOTICE("uart %d get count %d at 1s", uart,
-                         uart_udp->count[uart]);
+            DLOG_NOTICE("uart %d get count %d at 1s", uart,
+                        uart_udp->count[uart]);
             uart_udp->count[uart] = 0;
           }
 
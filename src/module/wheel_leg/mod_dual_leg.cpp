@@ -11,7 +11,10 @@ using namespace Module;
 using namespace Component::Type;
 
 WheelLeg::WheelLeg(WheelLeg::Param &param, float sample_freq)
-    : param_(param), wheel_polor_("leg_whell_polor"), ctrl_lock_(true) {
+    : param_(param),
+      wheel_polor_("leg_whell_polor"),
+      ctrl_lock_(true),
+      probe_("leg", 5000) {
   constexpr auto LEG_NAMES = magic_enum::enum_names<Leg>();
   constexpr auto MOTOR_NAMES = magic_enum::enum_names<LegMotor>();
   for (uint8_t i = 0; i < LEG_NUM; i++) {
@@ -60,27 +63,24 @@ WheelLeg::WheelLeg(WheelLeg::Param &param, float sample_freq)
   Component::CMD::RegisterEvent<WheelLeg *, ChassisEvent>(
       event_callback, this, this->param_.EVENT_MAP);
 
-  auto leg_thread = [](WheelLeg *leg) {
-    auto eulr_sub = Message::Subscriber("chassis_eulr", leg->eulr_);
-
-    auto gyro_sub = Message::Subscriber("chassis_gyro", leg->gyro_);
-
-    while (1) {
-      eulr_sub.DumpData();
+  auto leg_init = [](WheelLeg *leg) {
+    leg->eulr_sub_ = new Message::Subscriber<Component::Type::Eulr>(
+        "chassis_eulr", leg->eulr_);
+  };
 
-      leg->UpdateFeedback();
+  auto leg_step = [](WheelLeg *leg) {
+    leg->eulr_sub_->DumpData();
 
-      leg->Control();
+    leg->UpdateFeedback();
 
-      leg->wheel_polor_.Publish(leg->feedback_[0].whell_polar);
+    leg->Control();
 
-      leg->thread_.SleepUntil(5);
-    }
+    leg->wheel_polor_.Publish(leg->feedback_[0].whell_polar);
   };
 
-  this->thread_.Create(leg_thread, this, "leg_thread",
-                       MODULE_WHEELLEG_TASK_STACK_DEPTH,
-                       System::Thread::MEDIUM);
+  Component::Executor::Register("leg", 5, leg_init, leg_step, this,
+                                MODULE_WHEELLEG_TASK_STACK_DEPTH,
+                                System::Thread::MEDIUM);
 }
 
 void WheelLeg::UpdateFeedback() {
@@ -112,8 +112,9 @@ void WheelLeg::UpdateFeedback() {
 
     Position2 middle_point = this->feedback_[i].diagonal.MiddlePoint();
 
-    float length = sqrtf(powf(this->param_.l3, 2) -
-                         powf(this->feedback_[i].diagonal.Length() / 2.0f, 2));
+    float half_diagonal = this->feedback_[i].diagonal.Length() / 2.0f;
+    float length = Component::FastMath::Sqrt(
+        this->param_.l3 * this->param_.l3 - half_diagonal * half_diagonal);
     Component::Type::CycleValue angle = -Component::Triangle::Supplementary(
         this->feedback_[i].diagonal.Angle());
     angle += M_PI / 2.0f;
@@ -128,6 +129,8 @@ void WheelLeg::UpdateFeedback() {
 }
 
 void WheelLeg::Control() {
+  Component::Probe::Scope probe(this->probe_);
+
   this->now_ = bsp_time_get();
 
   this->dt_ = this->now_ - this->last_wakeup_;
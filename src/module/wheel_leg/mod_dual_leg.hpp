@@ -4,9 +4,11 @@
 
 #include "comp_actuator.hpp"
 #include "comp_cmd.hpp"
+#include "comp_executor.hpp"
 #include "comp_filter.hpp"
 #include "comp_mixer.hpp"
 #include "comp_pid.hpp"
+#include "comp_probe.hpp"
 #include "comp_triangle.hpp"
 #include "dev_mit_motor.hpp"
 
@@ -112,6 +114,9 @@ class WheelLeg {
 
   System::Semaphore ctrl_lock_;
 
-  System::Thread thread_;
+  Component::Probe probe_;
+
+  /* 在控制线程中创建 */
+  Message::Subscriber<Component::Type::Eulr>* eulr_sub_ = NULL;
 };
 }  // namespace Module
@@ -1,6 +1,7 @@
 #include <database.hpp>
 
 #include "comp_cmd.hpp"
+#include "comp_executor.hpp"
 #include "dev_ahrs.hpp"
 #include "dev_ai.hpp"
 #include "dev_blink_led.hpp"
@@ -32,6 +33,11 @@ class Infantry {
 
   Component::CMD cmd_;
 
+  /* 云台、底盘、发射器在同一个线程中按顺序运行，每个周期在新的姿态数据
+     到达后运行一轮，最后统一发出本周期的CAN帧，腿部使用独立线程。
+     必须在注册任务的设备和模块之前构造 */
+  Component::Executor ctrl_;
+
   Device::AI ai_;
   Device::AHRS ahrs_;
   Device::BMI088 bmi088_;
@@ -48,13 +54,17 @@ class Infantry {
   Module::Launcher launcher_;
 
   Infantry(Param& param, float control_freq)
-      : bmi088_(param.bmi088_rot),
+      : ctrl_("ctrl", 2, {"gimbal", "chassis", "launcher", "can"},
+              "imu_eulr"),
+        bmi088_(param.bmi088_rot),
         can_imu_(param.can_imu),
         cap_(param.cap),
         led_(param.blink),
         leg_(param.leg, control_freq),
         balance_(param.balance, control_freq),
         gimbal_(param.gimbal, control_freq),
-        launcher_(param.launcher, control_freq) {}
+        launcher_(param.launcher, control_freq) {
+    this->ctrl_.Start();
+  }
 };
 }  // namespace Robot
@@ -1,4 +1,5 @@
 #include "comp_cmd.hpp"
+#include "comp_executor.hpp"
 #include "dev_ahrs.hpp"
 #include "dev_ai.hpp"
 #include "dev_bmi088.hpp"
@@ -25,6 +26,11 @@ class Hero {
 
   Component::CMD cmd_;
 
+  /* 云台、底盘、发射器在同一个线程中按顺序运行，每个周期在新的姿态数据
+     到达后运行一轮，最后统一发出本周期的CAN帧。
+     必须在注册任务的设备和模块之前构造 */
+  Component::Executor ctrl_;
+
   Device::AI ai_;
   Device::AHRS ahrs_;
   Device::BMI088 bmi088_;
@@ -39,10 +45,14 @@ class Hero {
   Module::Launcher launcher_;
 
   Hero(Param& param, float control_freq)
-      : bmi088_(param.bmi088_rot),
+      : ctrl_("ctrl", 2, {"gimbal", "chassis", "launcher", "can"},
+              "imu_eulr"),
+        bmi088_(param.bmi088_rot),
         cap_(param.cap),
         chassis_(param.chassis, control_freq),
         gimbal_(param.gimbal, control_freq),
-        launcher_(param.launcher, control_freq) {}
+        launcher_(param.launcher, control_freq) {
+    this->ctrl_.Start();
+  }
 };
 }  // namespace Robot
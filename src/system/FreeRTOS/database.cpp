@@ -2,17 +2,35 @@
 #include <database.hpp>
 #include <term.hpp>
 
+#include "bsp_time.h"
 #include "ms.h"
+#include "task.h"
 
 using namespace System;
 
 static uint8_t sn_buff[33];
 
-static ms_item_t sn_tools;
+static ms_item_t sn_tools, db_info;
+
+/* 只在写入线程中使用 */
+static uint8_t flush_buff[DATABASE_VALUE_MAX_SIZE];
+
+static uint32_t commit_bytes, commit_time_max;
+
+Database::Entry Database::entry_[DATABASE_KEY_MAX_NUM];
+
+uint32_t Database::entry_num_ = 0;
+
+Semaphore* Database::flush_sem_ = NULL;
+
+Semaphore* Database::done_sem_ = NULL;
 
 Database::Database() {
   bsp_flash_init();
 
+  flush_sem_ = new Semaphore(false);
+  done_sem_ = new Semaphore(false);
+
   auto sn_cmd_fn = [](ms_item_t *item, int argc, char **argv) {
     MS_UNUSED(item);
 
@@ -60,6 +78,130 @@ Database::Database() {
     return 0;
   };
 
+  auto db_cmd_fn = [](ms_item_t *item, int argc, char **argv) {
+    MS_UNUSED(item);
+    (void)argc;
+    (void)argv;
+
+    printf("name\t\tsize\tset\tcommit\tdirty\r\n");
+    for (uint32_t i = 0; i < entry_num_; i++) {
+      Entry &entry = entry_[i];
+      printf("%-16s%d\t%d\t%d\t%d\r\n", entry.name,
+             static_cast<int>(entry.size), static_cast<int>(entry.set_count),
+             static_cast<int>(entry.commit_count), entry.dirty);
+    }
+    printf("写入字节数:%d 最长写入时间:%dms\r\n",
+           static_cast<int>(commit_bytes), static_cast<int>(commit_time_max));
+
+    return 0;
+  };
+
   ms_file_init(&sn_tools, "sn_tools", sn_cmd_fn, NULL, NULL);
   ms_cmd_add(&sn_tools);
+
+  ms_file_init(&db_info, "db_info", db_cmd_fn, NULL, NULL);
+  ms_cmd_add(&db_info);
+
+  auto flush_thread = [](Database *db) {
+    (void)db;
+
+    while (1) {
+      flush_sem_->Take(UINT32_MAX);
+
+      /* 等待一段时间，把连续的Set合并为一次写入 */
+      System::Thread::Sleep(DATABASE_FLUSH_DELAY);
+
+      Flush();
+
+      done_sem_->Give();
+    }
+  };
+
+  this->thread_.Create(flush_thread, this, "database", 256,
+                       System::Thread::IDLE);
+}
+
+uint32_t Database::Register(const char *name, void *data, uint32_t size) {
+  configASSERT(entry_num_ < DATABASE_KEY_MAX_NUM);
+  configASSERT(size <= DATABASE_VALUE_MAX_SIZE);
+
+  uint32_t index = entry_num_++;
+
+  Entry &entry = entry_[index];
+  entry.name = name;
+  entry.data = data;
+  entry.size = size;
+  entry.set_count = 0;
+  entry.commit_count = 0;
+  entry.dirty = false;
+  entry.in_flight = false;
+
+  if (bsp_flash_check_blog(name) == size) {
+    bsp_flash_get_blog(name, static_cast<uint8_t *>(data), size);
+  } else {
+    MarkDirty(index);
+  }
+
+  return index;
+}
+
+void Database::MarkDirty(uint32_t index) {
+  entry_[index].set_count++;
+  entry_[index].dirty = true;
+
+  if (flush_sem_ != NULL) {
+    flush_sem_->Give();
+  }
+}
+
+bool Database::Pending() {
+  for (uint32_t i = 0; i < entry_num_; i++) {
+    if (entry_[i].dirty || entry_[i].in_flight) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+void Database::Sync() {
+  while (Pending()) {
+    flush_sem_->Give();
+    done_sem_->Take(UINT32_MAX);
+  }
+
+  /* 一轮写入只唤醒一个等待者，交给下一个等待者重新检查 */
+  done_sem_->Give();
+}
+
+void Database::Flush() {
+  for (uint32_t i = 0; i < entry_num_; i++) {
+    Entry &entry = entry_[i];
+
+    if (!entry.dirty) {
+      continue;
+    }
+
+    /* 复制期间不切换线程，写入过程中再次Set会重新标记 */
+    vTaskSuspendAll();
+    memcpy(flush_buff, entry.data, entry.size);
+    entry.dirty = false;
+    entry.in_flight = true;
+    (void)xTaskResumeAll();
+
+    uint32_t start = bsp_time_get_ms();
+
+    bsp_flash_set_blog(entry.name, flush_buff, entry.size);
+
+    uint32_t time = bsp_time_get_ms() - start;
+    if (time > commit_time_max) {
+      commit_time_max = time;
+    }
+
+    entry.commit_count++;
+    commit_bytes += entry.size;
+
+    /* 写完后才允许Get从Flash读取，Sync才能返回 */
+    entry.in_flight = false;
+  }
 }
@@ -1,56 +1,86 @@
 #pragma once
 
 #include <cstring>
+#include <semaphore.hpp>
+#include <thread.hpp>
 
 #include "bsp_flash.h"
 
+#define DATABASE_KEY_MAX_NUM (32)     /* 键数量上限 */
+#define DATABASE_VALUE_MAX_SIZE (256) /* 单个键的数据大小上限 */
+#define DATABASE_FLUSH_DELAY (100)    /* 合并写入的等待时间，单位为毫秒 */
+
 namespace System {
+/* Set只修改内存并标记为脏，由低优先级线程合并后写入Flash */
 class Database {
  public:
+  typedef struct {
+    const char* name;
+    const void* data;
+    uint32_t size;
+    uint32_t set_count;    /* Set调用次数 */
+    uint32_t commit_count; /* 实际写入Flash的次数 */
+    bool dirty;
+    bool in_flight; /* 已复制到写入缓冲区，还没有写完Flash */
+  } Entry;
+
   Database();
+
   template <typename Data>
   class Key {
    public:
     Key(const char* name) : name_(name) {
-      if (bsp_flash_check_blog(name) == sizeof(Data)) {
-        bsp_flash_get_blog(name, reinterpret_cast<uint8_t*>(&this->data_),
-                           sizeof(Data));
-      } else {
-        memset(&this->data_, 0, sizeof(Data));
-        bsp_flash_set_blog(name, reinterpret_cast<uint8_t*>(&this->data_),
-                           sizeof(Data));
-      }
+      memset(&this->data_, 0, sizeof(Data));
+      this->index_ = Register(name, &this->data_, sizeof(Data));
     }
 
     Key(const char* name, const Data& init_value) : name_(name) {
-      if (bsp_flash_check_blog(name) == sizeof(Data)) {
-        bsp_flash_get_blog(name, reinterpret_cast<uint8_t*>(&this->data_),
-                           sizeof(Data));
-      } else {
-        this->data_ = init_value;
-        bsp_flash_set_blog(name, reinterpret_cast<uint8_t*>(&this->data_),
-                           sizeof(Data));
-      }
+      memcpy(&this->data_, &init_value, sizeof(Data));
+      this->index_ = Register(name, &this->data_, sizeof(Data));
     }
 
-    void Set() {
-      bsp_flash_set_blog(name_, reinterpret_cast<uint8_t*>(&this->data_),
-                         sizeof(Data));
-    }
+    /* 不会阻塞，需要确认写入时调用Sync */
+    void Set() { MarkDirty(this->index_); }
 
     void Set(const Data& data) {
-      this->data_ = data;
-      bsp_flash_set_blog(name_, reinterpret_cast<uint8_t*>(&this->data_),
-                         sizeof(Data));
+      memcpy(&this->data_, &data, sizeof(Data));
+      MarkDirty(this->index_);
     }
 
+    /* 还没有写完Flash时内存中的数据是最新的 */
     void Get() {
-      bsp_flash_get_blog(name_, reinterpret_cast<uint8_t*>(&this->data_),
-                         sizeof(Data));
+      const Entry& entry = entry_[this->index_];
+      if (!entry.dirty && !entry.in_flight) {
+        bsp_flash_get_blog(name_, reinterpret_cast<uint8_t*>(&this->data_),
+                           sizeof(Data));
+      }
     }
 
     Data data_;
     const char* name_;
+
+   private:
+    uint32_t index_;
   };
+
+  /* 等待所有已经Set的键写入Flash */
+  static void Sync();
+
+ private:
+  /* Flash中已有数据时读出到data，否则把data作为初始值写入 */
+  static uint32_t Register(const char* name, void* data, uint32_t size);
+
+  static void MarkDirty(uint32_t index);
+
+  static bool Pending();
+
+  static void Flush();
+
+  static Entry entry_[DATABASE_KEY_MAX_NUM];
+  static uint32_t entry_num_;
+  static Semaphore* flush_sem_;
+  static Semaphore* done_sem_;
+
+  Thread thread_;
 };
 }  // namespace System
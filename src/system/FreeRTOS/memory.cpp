@@ -1,9 +1,205 @@
+#include <cstdio>
 #include <memory.hpp>
 
 #include "portable.h"
+#include "task.h"
 
 using namespace System;
 
-void* operator new(std::size_t size) { return pvPortMalloc(size); }
+#define MEMORY_TAG_HEAP (MEMORY_POOL_CLASS_NUM)
 
-void operator delete(void* ptr) noexcept { vPortFree(ptr); }
+typedef struct {
+  uint32_t tag; /* 块池序号或分配来源 */
+  uint32_t size;
+} BlockHeader;
+
+typedef struct FreeBlock {
+  struct FreeBlock* next;
+} FreeBlock;
+
+static FreeBlock* pool_free[MEMORY_POOL_CLASS_NUM];
+
+static Memory::PoolStat pool_stat[MEMORY_POOL_CLASS_NUM];
+
+static uint8_t* arena_pos = NULL;
+static uint8_t* arena_end = NULL;
+
+static uint32_t arena_size, arena_waste, heap_size, heap_peak, late_alloc;
+
+static bool sealed = false, seal_request = false;
+
+static uint32_t init_pending = 0;
+
+static uint32_t align_size(size_t size) {
+  return static_cast<uint32_t>((size + 7) & ~static_cast<size_t>(7));
+}
+
+static void seal_check() {
+  if (!sealed) {
+    return;
+  }
+
+  late_alloc++;
+
+#ifdef FREERTOS_MEMORY_SEAL
+  /* 运行期间申请新内存 */
+  configASSERT(0);
+#endif
+}
+
+static void* arena_alloc(uint32_t size) {
+  if (arena_pos == NULL || static_cast<uint32_t>(arena_end - arena_pos) < size) {
+    uint8_t* chunk = static_cast<uint8_t*>(pvPortMalloc(MEMORY_ARENA_CHUNK));
+    if (chunk == NULL) {
+      return NULL;
+    }
+
+    if (arena_pos != NULL) {
+      arena_waste += arena_end - arena_pos;
+    }
+
+    arena_pos = chunk;
+    arena_end = chunk + MEMORY_ARENA_CHUNK;
+    arena_size += MEMORY_ARENA_CHUNK;
+  }
+
+  void* ans = arena_pos;
+  arena_pos += size;
+
+  return ans;
+}
+
+void* Memory::Malloc(size_t size) {
+  uint32_t need = align_size(size + sizeof(BlockHeader));
+  BlockHeader* header = NULL;
+
+  vTaskSuspendAll();
+
+  uint32_t tag = 0;
+  uint32_t block_size = MEMORY_POOL_MIN_SIZE;
+  while (tag < MEMORY_POOL_CLASS_NUM && block_size < need) {
+    tag++;
+    block_size <<= 1;
+  }
+
+  if (tag < MEMORY_POOL_CLASS_NUM) {
+    if (pool_free[tag] != NULL) {
+      header = reinterpret_cast<BlockHeader*>(pool_free[tag]);
+      pool_free[tag] = pool_free[tag]->next;
+    } else {
+      seal_check();
+      header = static_cast<BlockHeader*>(arena_alloc(block_size));
+      if (header != NULL) {
+        pool_stat[tag].total++;
+      }
+    }
+
+    if (header != NULL) {
+      PoolStat& stat = pool_stat[tag];
+      stat.used++;
+      if (stat.used > stat.peak) {
+        stat.peak = stat.used;
+      }
+    }
+  } else {
+    seal_check();
+    tag = MEMORY_TAG_HEAP;
+    block_size = need;
+    header = static_cast<BlockHeader*>(pvPortMalloc(need));
+    if (header != NULL) {
+      heap_size += need;
+      if (heap_size > heap_peak) {
+        heap_peak = heap_size;
+      }
+    }
+  }
+
+  if (header != NULL) {
+    header->tag = tag;
+    header->size = block_size;
+  }
+
+  (void)xTaskResumeAll();
+
+  return header == NULL ? NULL : header + 1;
+}
+
+void Memory::Free(void* block) {
+  if (block == NULL) {
+    return;
+  }
+
+  BlockHeader* header = static_cast<BlockHeader*>(block) - 1;
+
+  vTaskSuspendAll();
+
+  if (header->tag < MEMORY_POOL_CLASS_NUM) {
+    /* 空闲链表指针覆盖块头 */
+    uint32_t tag = header->tag;
+    FreeBlock* free_block = reinterpret_cast<FreeBlock*>(header);
+    free_block->next = pool_free[tag];
+    pool_free[tag] = free_block;
+    pool_stat[tag].used--;
+  } else {
+    heap_size -= header->size;
+    vPortFree(header);
+  }
+
+  (void)xTaskResumeAll();
+}
+
+void Memory::Seal() {
+  vTaskSuspendAll();
+  seal_request = true;
+  sealed = init_pending == 0;
+  (void)xTaskResumeAll();
+}
+
+void Memory::BeginInit() {
+  vTaskSuspendAll();
+  init_pending++;
+  (void)xTaskResumeAll();
+}
+
+void Memory::EndInit() {
+  vTaskSuspendAll();
+  init_pending--;
+  if (init_pending == 0 && seal_request) {
+    sealed = true;
+  }
+  (void)xTaskResumeAll();
+}
+
+void Memory::PrintInfo() {
+  printf("size\tused\tpeak\ttotal\r\n");
+
+  uint32_t block_size = MEMORY_POOL_MIN_SIZE;
+  for (int i = 0; i < MEMORY_POOL_CLASS_NUM; i++) {
+    printf("%u\t%u\t%u\t%u\r\n", static_cast<unsigned int>(block_size),
+           static_cast<unsigned int>(pool_stat[i].used),
+           static_cast<unsigned int>(pool_stat[i].peak),
+           static_cast<unsigned int>(pool_stat[i].total));
+    block_size <<= 1;
+  }
+
+  printf("arena: %u bytes, free %u, waste %u\r\n",
+         static_cast<unsigned int>(arena_size),
+         static_cast<unsigned int>(arena_end - arena_pos),
+         static_cast<unsigned int>(arena_waste));
+  printf("large: %u bytes, peak %u\r\n", static_cast<unsigned int>(heap_size),
+         static_cast<unsigned int>(heap_peak));
+  printf("heap free: %u, min %u\r\n",
+         static_cast<unsigned int>(xPortGetFreeHeapSize()),
+         static_cast<unsigned int>(xPortGetMinimumEverFreeHeapSize()));
+  printf("sealed: %s, late alloc: %u\r\n", sealed ? "yes" : "no",
+         static_cast<unsigned int>(late_alloc));
+}
+
+void* operator new(std::size_t size) { return Memory::Malloc(size); }
+
+void operator delete(void* ptr) noexcept { Memory::Free(ptr); }
+
+void operator delete(void* ptr, std::size_t size) noexcept {
+  (void)size;
+  Memory::Free(ptr);
+}
@@ -1,15 +1,39 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 
 #include "FreeRTOS.h"
 
+#define MEMORY_POOL_CLASS_NUM (7) /* 块大小为16~1024字节，包含块头 */
+#define MEMORY_POOL_MIN_SIZE (16) /* 最小块大小 */
+#define MEMORY_ARENA_CHUNK (4096) /* 每次从堆中申请的区块大小 */
+
 void* operator new(std::size_t size);
 void operator delete(void* ptr) noexcept;
+void operator delete(void* ptr, std::size_t size) noexcept;
 namespace System {
+/* 不超过1KiB的对象按大小分级从块池分配，块从只增不减的区块中切分，
+   释放后回到块池复用；更大的对象直接从堆中申请 */
 class Memory {
  public:
-  static void* Malloc(size_t size) { return pvPortMalloc(size); }
-  static void Free(void* block) { vPortFree(block); }
+  typedef struct {
+    uint32_t used;  /* 正在使用的块数 */
+    uint32_t peak;  /* 正在使用块数的最大值 */
+    uint32_t total; /* 已经切分出的块数 */
+  } PoolStat;
+
+  static void* Malloc(size_t size);
+  static void Free(void* block);
+
+  /* 初始化完成后调用，之后只允许复用已释放的块。
+     还有线程没有完成初始化时，推迟到最后一个线程完成后生效 */
+  static void Seal();
+
+  /* 线程在创建前调用BeginInit，自身的初始化完成后调用EndInit */
+  static void BeginInit();
+  static void EndInit();
+
+  static void PrintInfo();
 };
 }  // namespace System
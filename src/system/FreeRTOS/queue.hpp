@@ -1,5 +1,6 @@
 #pragma once
 
+#include <memory.hpp>
 #include <mutex.hpp>
 #include <semaphore.hpp>
 #include <thread.hpp>
@@ -12,7 +13,8 @@ template <typename Data>
 class Queue {
  public:
   Queue(uint16_t length) {
-    om_fifo_create(&fifo_, malloc(length * sizeof(Data)), length, sizeof(Data));
+    om_fifo_create(&fifo_, Memory::Malloc(length * sizeof(Data)), length,
+                   sizeof(Data));
   }
 
   bool Send(const Data& data, uint32_t timeout) {
@@ -8,22 +8,28 @@
 #include <timer.hpp>
 
 #include "om.hpp"
+#include "system_log.hpp"
 
 namespace System {
 template <typename RobotType, typename... RobotParam>
 void Start(RobotParam... param) {
   auto init_fun = [](RobotParam... param) {
-    Message* msg = static_cast<Message*>(pvPortMalloc(sizeof(Message)));
+    Message* msg = static_cast<Message*>(Memory::Malloc(sizeof(Message)));
     new (msg) Message();
-    Term* term = static_cast<Term*>(pvPortMalloc(sizeof(Term)));
+    Term* term = static_cast<Term*>(Memory::Malloc(sizeof(Term)));
     new (term) Term();
-    Database* database = static_cast<Database*>(pvPortMalloc(sizeof(Database)));
+    Database* database =
+        static_cast<Database*>(Memory::Malloc(sizeof(Database)));
     new (database) Database();
-    Timer* timer = static_cast<Timer*>(pvPortMalloc(sizeof(Timer)));
+    Timer* timer = static_cast<Timer*>(Memory::Malloc(sizeof(Timer)));
     new (timer) Timer();
+    Log::Start();
 
     RobotType robot(param...);
 
+    /* 执行器线程的init全部完成后才生效 */
+    Memory::Seal();
+
     while (1) {
       System::Thread::Sleep(UINT32_MAX);
     }
@@ -1,4 +1,5 @@
 #include <cstdlib>
+#include <memory.hpp>
 #include <term.hpp>
 #include <thread.hpp>
 
@@ -10,7 +11,7 @@ using namespace System;
 
 static System::Thread term_thread, usb_thread;
 
-static ms_item_t log_control, task_info;
+static ms_item_t log_control, task_info, mem_info;
 
 static bool log_enable = false;
 
@@ -85,6 +86,19 @@ Term::Term() {
 
   om_config_topic(om_get_log_handle(), "d", print_log, NULL);
 
+  auto mem_cmd_fn = [](ms_item_t *item, int argc, char **argv) {
+    (void)item;
+    (void)argc;
+    (void)argv;
+
+    System::Memory::PrintInfo();
+
+    return 0;
+  };
+
+  ms_file_init(&mem_info, "mem_info", mem_cmd_fn, NULL, NULL);
+  ms_cmd_add(&mem_info);
+
 #ifdef MCU_DEBUG_BUILD
 
   auto task_cmd_fn = [](ms_item_t *item, int argc, char **argv) {
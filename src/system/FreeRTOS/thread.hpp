@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cstdint>
+#include <memory.hpp>
 #include <string>
 
 #include "FreeRTOS.h"
@@ -15,11 +16,12 @@ class Thread {
 
   template <typename FunType, typename ArgType>
   void Create(FunType fun, ArgType arg, const char* name, uint32_t stack_depth,
-              Priority priority) {
+              Priority priority, uint32_t cpu_mask = 0) {
+    (void)cpu_mask;
     (void)static_cast<void (*)(ArgType)>(fun);
 
     TypeErasure<void, ArgType>* type = static_cast<TypeErasure<void, ArgType>*>(
-        pvPortMalloc(sizeof(TypeErasure<void, ArgType>)));
+        Memory::Malloc(sizeof(TypeErasure<void, ArgType>)));
 
     *type = TypeErasure<void, ArgType>(fun, arg);
 
@@ -1,4 +1,6 @@
-#include <poll.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
 
 #include <database.hpp>
 #include <term.hpp>
@@ -7,12 +9,79 @@
 
 using namespace System;
 
-static ms_item_t sn_tools;
+#define DATABASE_MAGIC (0x42445258)        /* XRDB */
+#define DATABASE_RECORD_MAGIC (0x4345524b) /* KREC */
+#define DATABASE_VERSION (1)
+
+typedef struct {
+  uint32_t magic;
+  uint32_t version;
+} FileHeader;
+
+typedef struct {
+  uint32_t magic;
+  uint32_t crc; /* 校验name_len之后的全部内容 */
+  uint16_t name_len;
+  uint16_t data_len;
+  uint32_t reserved;
+} RecordHeader;
+
+static ms_item_t sn_tools, db_info;
+
+static uint32_t crc32_table[256];
 
 std::string Database::path_(std::string(getenv("HOME")) + "/.rm_database/");
 
+pthread_mutex_t Database::mutex_ = PTHREAD_MUTEX_INITIALIZER;
+
+pthread_mutex_t Database::flush_mutex_ = PTHREAD_MUTEX_INITIALIZER;
+
+uint8_t *Database::map_ = NULL;
+
+int Database::fd_ = -1;
+
+uint32_t Database::tail_ = 0;
+
+uint32_t Database::flushed_ = 0;
+
+Database::Entry Database::entry_[DATABASE_KEY_MAX_NUM];
+
+uint32_t Database::entry_num_ = 0;
+
 Database::Key<uint8_t[32]> *sn;  // NOLINT(modernize-avoid-c-arrays)
 
+static void crc32_init() {
+  for (uint32_t i = 0; i < 256; i++) {
+    uint32_t crc = i;
+    for (int j = 0; j < 8; j++) {
+      crc = (crc & 1) ? (crc >> 1) ^ 0xedb88320 : crc >> 1;
+    }
+    crc32_table[i] = crc;
+  }
+}
+
+static uint32_t crc32_calc(const uint8_t *buf, uint32_t len) {
+  uint32_t crc = 0xffffffff;
+  while (len--) {
+    crc = crc32_table[(crc ^ *buf++) & 0xff] ^ (crc >> 8);
+  }
+  return crc ^ 0xffffffff;
+}
+
+static uint32_t record_size(uint32_t name_len, uint32_t data_len) {
+  return (sizeof(RecordHeader) + name_len + data_len + 7) & ~7u;
+}
+
+static uint32_t record_crc(const RecordHeader *record) {
+  return crc32_calc(reinterpret_cast<const uint8_t *>(&record->name_len),
+                    sizeof(RecordHeader) - offsetof(RecordHeader, name_len) +
+                        record->name_len + record->data_len);
+}
+
+static uint8_t *record_data(RecordHeader *record) {
+  return reinterpret_cast<uint8_t *>(record + 1) + record->name_len;
+}
+
 Database::Database() {
   auto sn_cmd_fn = [](ms_item_t *item, int argc, char **argv) {
     MS_UNUSED(item);
@@ -59,12 +128,361 @@ Database::Database() {
     return 0;
   };
 
-  poll(NULL, 0, 1);
+  auto db_cmd_fn = [](ms_item_t *item, int argc, char **argv) {
+    MS_UNUSED(item);
+    (void)argc;
+    (void)argv;
 
-  mkdir(path_.c_str(), S_IRWXU | S_IRWXG | S_IRWXO);
+    pthread_mutex_lock(&mutex_);
+
+    printf("name\t\t\t\tsize\toffset\r\n");
+    for (uint32_t i = 0; i < entry_num_; i++) {
+      printf("%-32s%u\t%u\r\n", entry_[i].name, entry_[i].size,
+             entry_[i].offset);
+    }
+    printf("journal:%u/%d\r\n", tail_, DATABASE_FILE_SIZE);
+
+    pthread_mutex_unlock(&mutex_);
+
+    return 0;
+  };
+
+  pthread_mutex_lock(&mutex_);
+  Open();
+  pthread_mutex_unlock(&mutex_);
 
   sn =
       new Database::Key<uint8_t[32]>("SN");  // NOLINT(modernize-avoid-c-arrays)
   ms_file_init(&sn_tools, "sn_tools", sn_cmd_fn, NULL, NULL);
   ms_cmd_add(&sn_tools);
+
+  ms_file_init(&db_info, "db_info", db_cmd_fn, NULL, NULL);
+  ms_cmd_add(&db_info);
+
+  auto flush_thread = [](Database *db) {
+    (void)db;
+
+    while (1) {
+      Flush();
+      System::Thread::Sleep(DATABASE_FLUSH_CYCLE);
+    }
+  };
+
+  this->thread_.Create(flush_thread, this, "database", 512,
+                       System::Thread::IDLE);
+}
+
+void Database::Open() {
+  if (map_ != NULL) {
+    return;
+  }
+
+  crc32_init();
+
+  mkdir(path_.c_str(), S_IRWXU | S_IRWXG | S_IRWXO);
+
+  fd_ = open((path_ + "database.bin").c_str(), O_RDWR | O_CREAT, 0644);
+
+  struct stat st;
+  if (fd_ < 0 || fstat(fd_, &st) != 0 ||
+      (st.st_size < DATABASE_FILE_SIZE &&
+       ftruncate(fd_, DATABASE_FILE_SIZE) != 0)) {
+    fprintf(stderr, "Database: can not open %sdatabase.bin.\n",
+            path_.c_str());
+    exit(-1);
+  }
+
+  void *map = mmap(NULL, DATABASE_FILE_SIZE, PROT_READ | PROT_WRITE,
+                   MAP_SHARED, fd_, 0);
+  if (map == MAP_FAILED) {
+    fprintf(stderr, "Database: mmap failed.\n");
+    exit(-1);
+  }
+
+  map_ = static_cast<uint8_t *>(map);
+
+  Load();
+}
+
+void Database::Load() {
+  FileHeader *header = reinterpret_cast<FileHeader *>(map_);
+
+  if (header->magic != DATABASE_MAGIC || header->version != DATABASE_VERSION) {
+    memset(map_, 0, DATABASE_FILE_SIZE);
+    header->magic = DATABASE_MAGIC;
+    header->version = DATABASE_VERSION;
+    tail_ = flushed_ = sizeof(FileHeader);
+    return;
+  }
+
+  uint32_t pos = sizeof(FileHeader);
+
+  /* 遇到不完整的记录即停止，之后的内容视为无效 */
+  while (pos + sizeof(RecordHeader) <= DATABASE_FILE_SIZE) {
+    RecordHeader *record = reinterpret_cast<RecordHeader *>(map_ + pos);
+
+    if (record->magic != DATABASE_RECORD_MAGIC || record->name_len == 0 ||
+        record->name_len > DATABASE_NAME_MAX_LEN) {
+      break;
+    }
+
+    uint32_t size = record_size(record->name_len, record->data_len);
+    if (size > DATABASE_FILE_SIZE - pos || record_crc(record) != record->crc) {
+      break;
+    }
+
+    const char *name = reinterpret_cast<const char *>(record + 1);
+    Entry *entry = Find(name, record->name_len);
+    if (entry == NULL && entry_num_ < DATABASE_KEY_MAX_NUM) {
+      entry = &entry_[entry_num_++];
+      memcpy(entry->name, name, record->name_len);
+      entry->name[record->name_len] = '\0';
+    }
+
+    if (entry != NULL) {
+      entry->size = record->data_len;
+      entry->offset = pos;
+    }
+
+    pos += size;
+  }
+
+  /* 清除断电留下的残缺记录，避免之后追加的记录与旧内容拼接 */
+  if (pos < DATABASE_FILE_SIZE) {
+    memset(map_ + pos, 0, DATABASE_FILE_SIZE - pos);
+  }
+
+  tail_ = flushed_ = pos;
+}
+
+Database::Entry *Database::Find(const char *name, uint32_t len) {
+  for (uint32_t i = 0; i < entry_num_; i++) {
+    if (strncmp(entry_[i].name, name, len) == 0 &&
+        entry_[i].name[len] == '\0') {
+      return &entry_[i];
+    }
+  }
+
+  return NULL;
+}
+
+uint32_t Database::Register(const char *name, void *data, uint32_t size) {
+  uint32_t len = strlen(name);
+
+  if (len == 0 || len > DATABASE_NAME_MAX_LEN) {
+    fprintf(stderr, "Database: invalid key name %s.\n", name);
+    exit(-1);
+  }
+
+  pthread_mutex_lock(&mutex_);
+
+  Open();
+
+  Entry *entry = Find(name, len);
+  if (entry == NULL) {
+    if (entry_num_ >= DATABASE_KEY_MAX_NUM) {
+      fprintf(stderr, "Database: too many keys.\n");
+      exit(-1);
+    }
+
+    entry = &entry_[entry_num_++];
+    memcpy(entry->name, name, len + 1);
+    entry->offset = 0;
+  }
+
+  uint32_t index = entry - entry_;
+
+  if (entry->offset != 0 && entry->size == size) {
+    RecordHeader *record =
+        reinterpret_cast<RecordHeader *>(map_ + entry->offset);
+    memcpy(data, record_data(record), size);
+  } else {
+    /* 兼容旧版本每个键一个文件的格式 */
+    FILE *fd = fopen((path_ + name).c_str(), "r");
+    if (fd != NULL) {
+      void *buff = malloc(size);
+      if (fread(buff, size, 1, fd) == 1) {
+        memcpy(data, buff, size);
+      }
+      free(buff);
+      static_cast<void>(fclose(fd));
+    }
+
+    entry->size = size;
+    AppendEntry(index, data);
+  }
+
+  pthread_mutex_unlock(&mutex_);
+
+  return index;
+}
+
+void Database::Write(uint32_t index, const void *data) {
+  pthread_mutex_lock(&mutex_);
+  AppendEntry(index, data);
+  pthread_mutex_unlock(&mutex_);
+}
+
+void Database::Read(uint32_t index, void *data) {
+  pthread_mutex_lock(&mutex_);
+
+  Entry &entry = entry_[index];
+  RecordHeader *record = reinterpret_cast<RecordHeader *>(map_ + entry.offset);
+  memcpy(data, record_data(record), entry.size);
+
+  pthread_mutex_unlock(&mutex_);
+}
+
+void Database::AppendEntry(uint32_t index, const void *data) {
+  Entry &entry = entry_[index];
+  uint32_t size = record_size(strlen(entry.name), entry.size);
+
+  /* 日志写满时在调用者线程中压缩，正常情况下由后台线程提前完成。
+     压缩会替换映射，按照与Flush相同的顺序重新加锁，等待正在进行的刷写 */
+  if (size > DATABASE_FILE_SIZE - tail_) {
+    pthread_mutex_unlock(&mutex_);
+    pthread_mutex_lock(&flush_mutex_);
+    pthread_mutex_lock(&mutex_);
+
+    if (size > DATABASE_FILE_SIZE - tail_) {
+      Compact();
+    }
+
+    pthread_mutex_unlock(&flush_mutex_);
+
+    if (size > DATABASE_FILE_SIZE - tail_) {
+      fprintf(stderr, "Database: no space for %s.\n", entry.name);
+      return;
+    }
+  }
+
+  entry.offset = tail_;
+  tail_ = Append(map_, tail_, entry.name, data, entry.size);
+}
+
+uint32_t Database::Append(uint8_t *map, uint32_t tail, const char *name,
+                          const void *data, uint32_t size) {
+  RecordHeader *record = reinterpret_cast<RecordHeader *>(map + tail);
+  uint32_t name_len = strlen(name);
+  uint32_t total = record_size(name_len, size);
+
+  record->name_len = name_len;
+  record->data_len = size;
+  record->reserved = 0;
+  memcpy(record + 1, name, name_len);
+  memcpy(record_data(record), data, size);
+  memset(record_data(record) + size, 0,
+         total - sizeof(RecordHeader) - name_len - size);
+  record->crc = record_crc(record);
+  record->magic = DATABASE_RECORD_MAGIC;
+
+  tail += total;
+
+  /* 下一条记录的位置保持为空，读取时在这里停止 */
+  if (tail + sizeof(uint32_t) <= DATABASE_FILE_SIZE) {
+    memset(map + tail, 0, sizeof(uint32_t));
+  }
+
+  return tail;
+}
+
+void Database::Compact() {
+  std::string file = path_ + "database.bin";
+  std::string tmp = path_ + "database.tmp";
+
+  int fd = open(tmp.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0) {
+    return;
+  }
+
+  if (ftruncate(fd, DATABASE_FILE_SIZE) != 0) {
+    close(fd);
+    return;
+  }
+
+  void *ptr = mmap(NULL, DATABASE_FILE_SIZE, PROT_READ | PROT_WRITE,
+                   MAP_SHARED, fd, 0);
+  if (ptr == MAP_FAILED) {
+    close(fd);
+    return;
+  }
+
+  uint8_t *map = static_cast<uint8_t *>(ptr);
+
+  FileHeader *header = reinterpret_cast<FileHeader *>(map);
+  header->magic = DATABASE_MAGIC;
+  header->version = DATABASE_VERSION;
+
+  /* 每个键只保留最新的一条记录 */
+  uint32_t tail = sizeof(FileHeader);
+  for (uint32_t i = 0; i < entry_num_; i++) {
+    Entry &entry = entry_[i];
+    if (entry.offset == 0) {
+      continue;
+    }
+
+    RecordHeader *record =
+        reinterpret_cast<RecordHeader *>(map_ + entry.offset);
+    entry.offset = tail;
+    tail = Append(map, tail, entry.name, record_data(record), entry.size);
+  }
+
+  /* 新文件完整落盘后再替换旧文件，失败时继续使用旧文件 */
+  if (msync(map, DATABASE_FILE_SIZE, MS_SYNC) != 0 ||
+      rename(tmp.c_str(), file.c_str()) != 0) {
+    fprintf(stderr, "Database: compact failed.\n");
+    munmap(map, DATABASE_FILE_SIZE);
+    close(fd);
+    return;
+  }
+
+  /* 目录项也需要落盘，否则断电后可能仍然指向旧文件 */
+  int dir = open(path_.c_str(), O_RDONLY | O_DIRECTORY);
+  if (dir >= 0) {
+    fsync(dir);
+    close(dir);
+  }
+
+  munmap(map_, DATABASE_FILE_SIZE);
+  close(fd_);
+
+  map_ = map;
+  fd_ = fd;
+  tail_ = flushed_ = tail;
+}
+
+void Database::Flush() {
+  /* 整个刷写过程持有flush_mutex_，Sync在后台刷写完成后才返回，
+     压缩也不会在msync期间解除映射 */
+  pthread_mutex_lock(&flush_mutex_);
+  pthread_mutex_lock(&mutex_);
+
+  if (tail_ > DATABASE_FILE_SIZE / 2) {
+    uint32_t live = sizeof(FileHeader);
+    for (uint32_t i = 0; i < entry_num_; i++) {
+      if (entry_[i].offset != 0) {
+        live += record_size(strlen(entry_[i].name), entry_[i].size);
+      }
+    }
+
+    if (live < tail_ / 2) {
+      Compact();
+    }
+  }
+
+  uint8_t *map = map_;
+  uint32_t tail = tail_;
+
+  pthread_mutex_unlock(&mutex_);
+
+  /* 已经写入的记录不会再被修改，可以在mutex_外刷写 */
+  if (tail != flushed_) {
+    if (msync(map, tail, MS_SYNC) == 0) {
+      flushed_ = tail;
+    } else {
+      fprintf(stderr, "Database: msync failed.\n");
+    }
+  }
+
+  pthread_mutex_unlock(&flush_mutex_);
 }
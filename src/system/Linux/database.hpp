@@ -1,78 +1,103 @@
 #pragma once
 
-#include <fcntl.h>
+#include <pthread.h>
 #include <sys/stat.h>
 #include <sys/types.h>
-#include <unistd.h>
 
 #include <cstdint>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
 #include <string>
+#include <thread.hpp>
+
+#define DATABASE_FILE_SIZE (256 * 1024) /* 数据库文件大小 */
+#define DATABASE_KEY_MAX_NUM (128)      /* 键数量上限 */
+#define DATABASE_NAME_MAX_LEN (32)      /* 键名最大长度 */
+#define DATABASE_FLUSH_CYCLE (100)      /* 后台刷写周期，单位为毫秒 */
 
 namespace System {
+/* 所有键保存在同一个内存映射文件中。每次写入在日志末尾追加一条带CRC的记录，
+   读取时以最后一条完整记录为准，写入中途断电不会破坏旧值。
+   后台线程负责刷写和压缩日志 */
 class Database {
  public:
+  typedef struct {
+    char name[DATABASE_NAME_MAX_LEN + 1];
+    uint32_t size;
+    uint32_t offset; /* 最新记录在文件中的位置，0表示还没有记录 */
+  } Entry;
+
   Database();
 
   template <typename Data>
   class Key {
    public:
     Key(const char* name) : name_(name) {
-      FILE* fd = NULL;
-      if (!access((path_ + name).c_str(), W_OK)) {
-        fd = fopen((path_ + name).c_str(), "r");
-        static_cast<void>(fread(&this->data_, sizeof(Data), 1, fd));
-        static_cast<void>(fclose(fd));
-      } else {
-        fd = fopen((path_ + name).c_str(), "w+");
-        memset(&this->data_, 0, sizeof(Data));
-        static_cast<void>(fwrite(&this->data_, sizeof(Data), 1, fd));
-        static_cast<void>(fclose(fd));
-      }
+      memset(&this->data_, 0, sizeof(Data));
+      this->index_ = Register(name, &this->data_, sizeof(Data));
     }
 
     Key(const char* name, const Data& init_value) : name_(name) {
-      FILE* fd = NULL;
-      if (!access((path_ + name).c_str(), W_OK)) {
-        fd = fopen((path_ + name).c_str(), "r");
-        static_cast<void>(fread(&this->data_, sizeof(Data), 1, fd));
-        static_cast<void>(fclose(fd));
-      } else {
-        fd = fopen((path_ + name).c_str(), "w+");
-        this->data_ = init_value;
-        static_cast<void>(fwrite(&this->data_, sizeof(Data), 1, fd));
-        static_cast<void>(fclose(fd));
-      }
+      memcpy(&this->data_, &init_value, sizeof(Data));
+      this->index_ = Register(name, &this->data_, sizeof(Data));
     }
 
-    void Set() {
-      FILE* fd = NULL;
-      fd = fopen((path_ + name_).c_str(), "w+");
-      static_cast<void>(fwrite(&this->data_, sizeof(Data), 1, fd));
-      static_cast<void>(fclose(fd));
-    }
+    /* 只有内存拷贝，不会产生系统调用 */
+    void Set() { Write(this->index_, &this->data_); }
 
     void Set(const Data& data) {
-      this->data_ = data;
-      FILE* fd = NULL;
-      fd = fopen((path_ + name_).c_str(), "w+");
-      static_cast<void>(fwrite(&this->data_, sizeof(Data), 1, fd));
-      static_cast<void>(fclose(fd));
+      memcpy(&this->data_, &data, sizeof(Data));
+      Write(this->index_, &this->data_);
     }
 
-    void Get() {
-      FILE* fd = NULL;
-      fd = fopen((path_ + name_).c_str(), "r");
-      static_cast<void>(fread(&this->data_, sizeof(Data), 1, fd));
-      static_cast<void>(fclose(fd));
-    }
+    void Get() { Read(this->index_, &this->data_); }
 
     Data data_;
     const char* name_;
+
+   private:
+    uint32_t index_;
   };
 
+  /* 等待已经写入的记录落盘，后台线程正在刷写时等待其完成 */
+  static void Sync() { Flush(); }
+
   static std::string path_;
+
+ private:
+  /* 文件中已有记录时读出到data，否则写入data作为初始值 */
+  static uint32_t Register(const char* name, void* data, uint32_t size);
+
+  static void Write(uint32_t index, const void* data);
+
+  static void Read(uint32_t index, void* data);
+
+  static void Open();
+
+  static Entry* Find(const char* name, uint32_t len);
+
+  static void AppendEntry(uint32_t index, const void* data);
+
+  static uint32_t Append(uint8_t* map, uint32_t tail, const char* name,
+                         const void* data, uint32_t size);
+
+  static void Load();
+
+  static void Compact();
+
+  static void Flush();
+
+  static pthread_mutex_t mutex_;
+  /* 保护映射的替换和flushed_，与mutex_同时使用时先获取 */
+  static pthread_mutex_t flush_mutex_;
+  static uint8_t* map_;
+  static int fd_;
+  static uint32_t tail_;
+  static uint32_t flushed_;
+  static Entry entry_[DATABASE_KEY_MAX_NUM];
+  static uint32_t entry_num_;
+
+  Thread thread_;
 };
 }  // namespace System
@@ -1,53 +1,181 @@
 #pragma once
 
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
 #include <mutex.hpp>
 
-#include "om.h"
-
 namespace System {
+/* 节点从构造时申请的节点池中分配，Foreach不加锁，删除的节点
+   在之前进入的读者全部退出后（两代宽限期）放回节点池 */
 template <typename Data>
 class List {
  public:
-  typedef struct {
+  typedef struct Node {
     Data data_;
-    om_list_head_t node_;
+    std::atomic<struct Node*> next_;
+    struct Node* retired_next_;
   } Node;
 
-  List() { INIT_LIST_HEAD(&(this->head_)); }
+  List(uint32_t length) : head_(NULL), epoch_(0) {
+    pool_ = static_cast<Node*>(malloc(length * sizeof(Node)));
+    free_ = NULL;
+    readers_[0].store(0, std::memory_order_relaxed);
+    readers_[1].store(0, std::memory_order_relaxed);
+    retired_[0] = NULL;
+    retired_[1] = NULL;
+
+    for (uint32_t i = 0; i < length; i++) {
+      pool_[i].next_.store(free_, std::memory_order_relaxed);
+      free_ = &pool_[i];
+    }
+  }
 
   bool Add(Data data, uint32_t timeout = UINT32_MAX) {
-    mutex_.Lock(timeout);
-    Node* node = static_cast<Node*>(malloc(sizeof(Node)));
+    if (!mutex_.Lock(timeout)) {
+      return false;
+    }
+
+    Node* node = Alloc();
+    if (node == NULL) {
+      mutex_.Unlock();
+      return false;
+    }
+
     memcpy(&(node->data_), &data, sizeof(data));
-    om_list_add(&(node->node_), &(this->head_));
+    node->next_.store(head_.load(std::memory_order_relaxed),
+                      std::memory_order_relaxed);
+    head_.store(node, std::memory_order_release);
     mutex_.Unlock();
 
     return true;
   }
 
   bool AddTail(Data data, uint32_t timeout = UINT32_MAX) {
-    mutex_.Lock(timeout);
-    Node* node = static_cast<Node*>(malloc(sizeof(Node)));
+    if (!mutex_.Lock(timeout)) {
+      return false;
+    }
+
+    Node* node = Alloc();
+    if (node == NULL) {
+      mutex_.Unlock();
+      return false;
+    }
+
     memcpy(&(node->data_), &data, sizeof(data));
-    om_list_add_tail(&(node->node_), (this->head_));
+    node->next_.store(NULL, std::memory_order_relaxed);
+
+    std::atomic<Node*>* tail = &head_;
+    while (tail->load(std::memory_order_relaxed) != NULL) {
+      tail = &(tail->load(std::memory_order_relaxed)->next_);
+    }
+    tail->store(node, std::memory_order_release);
+    mutex_.Unlock();
+
+    return true;
+  }
+
+  /* 删除第一个使fun返回true的节点，可以在Foreach的回调中调用 */
+  bool Remove(bool (*fun)(Data&, void*), void* arg,
+              uint32_t timeout = UINT32_MAX) {
+    if (!mutex_.Lock(timeout)) {
+      return false;
+    }
+
+    std::atomic<Node*>* prev = &head_;
+    Node* node = prev->load(std::memory_order_relaxed);
+
+    while (node != NULL && !fun(node->data_, arg)) {
+      prev = &(node->next_);
+      node = prev->load(std::memory_order_relaxed);
+    }
+
+    if (node == NULL) {
+      mutex_.Unlock();
+      return false;
+    }
+
+    /* 保留node->next_，正在遍历该节点的读者仍能走到链表尾部 */
+    prev->store(node->next_.load(std::memory_order_relaxed),
+                std::memory_order_seq_cst);
+
+    /* 挂到当前代，等这一代之前进入的读者全部退出后回收 */
+    uint32_t epoch = epoch_.load(std::memory_order_relaxed);
+    node->retired_next_ = retired_[epoch & 1];
+    retired_[epoch & 1] = node;
+
+    Reclaim();
+
     mutex_.Unlock();
 
     return true;
   }
 
   void Foreach(bool (*fun)(Data&, void*), void* arg) {
-    mutex_.Lock(UINT32_MAX);
-    om_list_head_t* pos = NULL;
-    om_list_for_each(pos, &(this->head_)) {
-      Node* data = om_list_entry(pos, Node, node_);
-      if (!fun(data->data_, arg)) {
+    /* 登记到当前代，登记期间换代则重新登记 */
+    uint32_t epoch = 0;
+    while (true) {
+      epoch = epoch_.load(std::memory_order_seq_cst);
+      readers_[epoch & 1].fetch_add(1, std::memory_order_seq_cst);
+      if (epoch_.load(std::memory_order_seq_cst) == epoch) {
         break;
       }
+      readers_[epoch & 1].fetch_sub(1, std::memory_order_seq_cst);
     }
-    mutex_.Unlock();
+
+    Node* node = head_.load(std::memory_order_seq_cst);
+    while (node != NULL) {
+      if (!fun(node->data_, arg)) {
+        break;
+      }
+      node = node->next_.load(std::memory_order_acquire);
+    }
+
+    readers_[epoch & 1].fetch_sub(1, std::memory_order_release);
+  }
+
+ private:
+  /* 上一代的读者全部退出后，上一代及更早删除的节点不会再被访问，
+     放回节点池并换代。之后进入的读者都登记在新一代，持续遍历也能回收 */
+  void Reclaim() {
+    if (retired_[0] == NULL && retired_[1] == NULL) {
+      return;
+    }
+
+    uint32_t epoch = epoch_.load(std::memory_order_relaxed);
+    if (readers_[(epoch - 1) & 1].load(std::memory_order_seq_cst) != 0) {
+      return;
+    }
+
+    Node** retired = &retired_[(epoch - 1) & 1];
+    while (*retired != NULL) {
+      Node* node = *retired;
+      *retired = node->retired_next_;
+      node->next_.store(free_, std::memory_order_relaxed);
+      free_ = node;
+    }
+
+    epoch_.store(epoch + 1, std::memory_order_seq_cst);
+  }
+
+  Node* Alloc() {
+    Reclaim();
+
+    Node* node = free_;
+    if (node != NULL) {
+      free_ = node->next_.load(std::memory_order_relaxed);
+    }
+
+    return node;
   }
 
-  om_list_head_t head_;
+  std::atomic<Node*> head_;
+  std::atomic<uint32_t> epoch_;
+  std::atomic<uint32_t> readers_[2];
+  Node* pool_;
+  Node* free_;
+  Node* retired_[2];
   System::Mutex mutex_;
 };
 }  // namespace System
@@ -9,5 +9,7 @@ class Memory {
  public:
   static void* Malloc(size_t size) { return malloc(size); }
   static void Free(void* block) { free(block); }
+  static void BeginInit() {}
+  static void EndInit() {}
 };
 }  // namespace System
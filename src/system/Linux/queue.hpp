@@ -1,10 +1,11 @@
 #pragma once
 
-#include <mutex.hpp>
-#include <semaphore.hpp>
-#include <thread.hpp>
+#include <pthread.h>
+#include <time.h>
+
+#include <cstdint>
+#include <cstdlib>
 
-#include "bsp_time.h"
 #include "om.hpp"
 
 namespace System {
@@ -13,138 +14,128 @@ class Queue {
  public:
   Queue(uint16_t length) {
     om_fifo_create(&fifo_, malloc(length * sizeof(Data)), length, sizeof(Data));
+
+    /* 超时基于单调时钟，不受系统时间调整影响 */
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&not_empty_, &attr);
+    pthread_cond_init(&not_full_, &attr);
+    pthread_condattr_destroy(&attr);
+
+    pthread_mutex_init(&mutex_, NULL);
   }
 
   bool Send(const Data& data, uint32_t timeout) {
-    uint32_t start_time = bsp_time_get_ms();
-    if (!mutex_.Lock(timeout)) {
-      return false;
-    }
+    struct timespec deadline = {};
+    GetDeadline(deadline, timeout);
 
-    if (om_fifo_write(&fifo_, &data) == OM_OK) {
-      mutex_.Unlock();
-      return true;
-    }
+    pthread_mutex_lock(&mutex_);
 
-    bool ans = false;
-    while (bsp_time_get_ms() - start_time < timeout) {
-      ans = om_fifo_write(&fifo_, &data) == OM_OK;
-      if (ans) {
-        break;
-      }
-      mutex_.Unlock();
-      System::Thread::Sleep(1);
-      while (bsp_time_get_ms() - start_time < timeout) {
-        if (mutex_.Lock(1)) {
-          break;
-        }
+    bool timed_out = false;
+
+    while (om_fifo_write(&fifo_, &data) != OM_OK) {
+      if (timed_out) {
+        pthread_mutex_unlock(&mutex_);
+        return false;
       }
+      timed_out = !Wait(not_full_, deadline, timeout);
     }
 
-    mutex_.Unlock();
+    pthread_cond_signal(&not_empty_);
+    pthread_mutex_unlock(&mutex_);
 
-    return ans;
+    return true;
   }
 
   bool Receive(Data& data, uint32_t timeout) {
-    uint32_t start_time = bsp_time_get_ms();
-    if (!mutex_.Lock(timeout)) {
-      return false;
-    }
+    struct timespec deadline = {};
+    GetDeadline(deadline, timeout);
 
-    if (om_fifo_read(&fifo_, &data) == OM_OK) {
-      mutex_.Unlock();
-      return true;
-    }
+    pthread_mutex_lock(&mutex_);
 
-    bool ans = false;
-    while (bsp_time_get_ms() - start_time < timeout) {
-      ans = om_fifo_read(&fifo_, &data) == OM_OK;
-      if (ans) {
-        break;
-      }
-      mutex_.Unlock();
-      System::Thread::Sleep(1);
-      while (1) {
-        if (mutex_.Lock(1)) {
-          break;
-        } else {
-          if (bsp_time_get_ms() - start_time < timeout) {
-            return false;
-          }
-        }
+    bool timed_out = false;
+
+    while (om_fifo_read(&fifo_, &data) != OM_OK) {
+      if (timed_out) {
+        pthread_mutex_unlock(&mutex_);
+        return false;
       }
+      timed_out = !Wait(not_empty_, deadline, timeout);
     }
 
-    mutex_.Unlock();
+    pthread_cond_signal(&not_full_);
+    pthread_mutex_unlock(&mutex_);
 
-    return ans;
+    return true;
   }
 
   bool Overwrite(const Data& data) {
-    if (!mutex_.Lock(0)) {
-      return false;
-    }
+    pthread_mutex_lock(&mutex_);
 
     bool ans = om_fifo_overwrite(&fifo_, &data) == OM_OK;
 
-    mutex_.Unlock();
+    if (ans) {
+      pthread_cond_signal(&not_empty_);
+    }
+
+    pthread_mutex_unlock(&mutex_);
 
     return ans;
   }
 
-  bool SendFromISR(const Data& data) {
-    if (!mutex_.LockFromISR()) {
-      return false;
-    }
-
-    bool ans = om_fifo_write(&fifo_, &data) == OM_OK;
+  bool SendFromISR(const Data& data) { return Send(data, 0); }
 
-    mutex_.UnlockFromISR();
+  bool ReceiveFromISR(Data& data) { return Receive(data, 0); }
 
-    return ans;
-  }
+  bool OverwriteFromISR(const Data& data) { return Overwrite(data); }
 
-  bool ReceiveFromISR(Data& data) {
-    if (!mutex_.LockFromISR()) {
-      return false;
-    }
+  bool Reset() {
+    pthread_mutex_lock(&mutex_);
 
-    bool ans = om_fifo_read(&fifo_, &data) == OM_OK;
+    bool ans = om_fifo_reset(&fifo_) == OM_OK;
 
-    mutex_.UnlockFromISR();
+    pthread_cond_broadcast(&not_full_);
+    pthread_mutex_unlock(&mutex_);
 
     return ans;
   }
 
-  bool OverwriteFromISR(const Data& data) {
-    if (!mutex_.LockFromISR()) {
-      return false;
-    }
-
-    bool ans = om_fifo_overwrite(&fifo_, &data) == OM_OK;
+  uint32_t Size() { return om_fifo_readable_item_count(&fifo_); }
 
-    mutex_.UnlockFromISR();
+ private:
+  static void GetDeadline(struct timespec& deadline, uint32_t timeout) {
+    if (timeout == 0 || timeout == UINT32_MAX) {
+      return;
+    }
 
-    return ans;
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    deadline.tv_sec += timeout / 1000;
+    deadline.tv_nsec += static_cast<long>(timeout % 1000) * 1000000L;
+    if (deadline.tv_nsec >= 1000000000L) {
+      deadline.tv_sec++;
+      deadline.tv_nsec -= 1000000000L;
+    }
   }
 
-  bool Reset() {
-    if (!mutex_.Lock(0)) {
+  /* 等待条件变量，返回false表示已经超时 */
+  bool Wait(pthread_cond_t& cond, const struct timespec& deadline,
+            uint32_t timeout) {
+    if (timeout == 0) {
       return false;
     }
 
-    bool ans = om_fifo_reset(&fifo_) == OM_OK;
-
-    mutex_.Unlock();
+    if (timeout == UINT32_MAX) {
+      pthread_cond_wait(&cond, &mutex_);
+      return true;
+    }
 
-    return ans;
+    return pthread_cond_timedwait(&cond, &mutex_, &deadline) == 0;
   }
 
-  uint32_t Size() { return om_fifo_readable_item_count(&fifo_); }
-
- private:
   om_fifo_t fifo_;
-  System::Mutex mutex_;
+  pthread_mutex_t mutex_;
+  pthread_cond_t not_empty_;
+  pthread_cond_t not_full_;
 };
 }  // namespace System
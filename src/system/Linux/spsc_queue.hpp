@@ -0,0 +1,85 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace System {
+/* 单生产者单消费者无锁队列，容量在编译期确定，不加锁也不申请堆内存 */
+template <typename Data, uint32_t Length>
+class SpscQueue {
+  static_assert(Length > 0 && (Length & (Length - 1)) == 0,
+                "SpscQueue length must be a power of two");
+
+ public:
+  SpscQueue() : head_(0), tail_(0) {}
+
+  bool Send(const Data& data) {
+    uint32_t head = head_.load(std::memory_order_relaxed);
+
+    if (head - tail_.load(std::memory_order_acquire) >= Length) {
+      return false;
+    }
+
+    buff_[head & (Length - 1)] = data;
+    head_.store(head + 1, std::memory_order_release);
+
+    return true;
+  }
+
+  bool Receive(Data& data) {
+    uint32_t tail = tail_.load(std::memory_order_acquire);
+
+    while (tail != head_.load(std::memory_order_acquire)) {
+      data = buff_[tail & (Length - 1)];
+      /* 失败说明生产者覆写了这个位置，重新读取最旧的数据 */
+      if (tail_.compare_exchange_weak(tail, tail + 1,
+                                      std::memory_order_acq_rel,
+                                      std::memory_order_acquire)) {
+        return true;
+      }
+    }
+
+    return false;
+  }
+
+  /* 队列已满时丢弃最旧的数据 */
+  bool Overwrite(const Data& data) {
+    uint32_t head = head_.load(std::memory_order_relaxed);
+    uint32_t tail = tail_.load(std::memory_order_acquire);
+
+    if (head - tail >= Length) {
+      /* 失败说明消费者刚好取走了一个数据，同样腾出了位置 */
+      tail_.compare_exchange_strong(tail, tail + 1, std::memory_order_acq_rel,
+                                    std::memory_order_acquire);
+    }
+
+    buff_[head & (Length - 1)] = data;
+    head_.store(head + 1, std::memory_order_release);
+
+    return true;
+  }
+
+  bool SendFromISR(const Data& data) { return Send(data); }
+
+  bool ReceiveFromISR(Data& data) { return Receive(data); }
+
+  bool OverwriteFromISR(const Data& data) { return Overwrite(data); }
+
+  /* 只能由消费者调用 */
+  bool Reset() {
+    tail_.store(head_.load(std::memory_order_acquire),
+                std::memory_order_release);
+    return true;
+  }
+
+  uint32_t Size() {
+    return head_.load(std::memory_order_acquire) -
+           tail_.load(std::memory_order_acquire);
+  }
+
+ private:
+  std::atomic<uint32_t> head_;
+  std::atomic<uint32_t> tail_;
+  Data buff_[Length];
+};
+}  // namespace System
@@ -9,6 +9,7 @@
 #include <timer.hpp>
 
 #include "om.hpp"
+#include "system_log.hpp"
 
 namespace System {
 template <typename RobotType, typename... RobotParam>
@@ -18,6 +19,7 @@ void Start(RobotParam... param) {
     new Term();
     new Database();
     new Timer();
+    Log::Start();
 
     RobotType robot(param...);
 
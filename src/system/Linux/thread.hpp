@@ -1,55 +1,162 @@
 #pragma once
 
+#include <errno.h>
 #include <poll.h>
 #include <pthread.h>
+#include <sched.h>
 #include <stdint.h>
+#include <time.h>
 
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <string>
 
 #include "bsp_time.h"
 #include "system_ext.hpp"
 
+#define LINUX_THREAD_STACK_SIZE_MIN (64 * 1024) /* 线程栈最小值 */
+
 namespace System {
 class Thread {
  public:
   typedef enum { IDLE, LOW, MEDIUM, HIGH, REALTIME } Priority;
 
+  Thread() { clock_gettime(CLOCK_MONOTONIC, &this->last_weakup_time_); }
+
   template <typename FunType, typename ArgType>
   void Create(FunType fun, ArgType arg, const char* name, uint32_t stack_depth,
-              Priority priority) {
-    (void)name;
-    (void)stack_depth;
-    (void)priority;
-
+              Priority priority, uint32_t cpu_mask = 0) {
     (void)static_cast<void (*)(ArgType)>(fun);
-    TypeErasure<void, ArgType>* type = static_cast<TypeErasure<void, ArgType>*>(
-        malloc(sizeof(TypeErasure<void, ArgType>)));
 
-    *type = TypeErasure<void, ArgType>(fun, arg);
+    typedef struct {
+      TypeErasure<void, ArgType> type;
+      char name[16]; /* Linux线程名最长15个字符 */
+    } ThreadInfo;
+
+    ThreadInfo* info = static_cast<ThreadInfo*>(malloc(sizeof(ThreadInfo)));
+
+    info->type = TypeErasure<void, ArgType>(fun, arg);
+    strncpy(info->name, name, sizeof(info->name) - 1);
+    info->name[sizeof(info->name) - 1] = '\0';
 
     auto port = [](void* arg) {
-      TypeErasure<void, ArgType>* type =
-          static_cast<TypeErasure<void, ArgType>*>(arg);
-      type->fun_(type->arg_);
+      ThreadInfo* info = static_cast<ThreadInfo*>(arg);
+      pthread_setname_np(pthread_self(), info->name);
+      info->type.fun_(info->type.arg_);
       return static_cast<void*>(NULL);
     };
 
-    pthread_create(&this->handle_, NULL, port, type);
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+
+    /* stack_depth与FreeRTOS一样以字为单位，为0时使用系统默认大小 */
+    if (stack_depth > 0) {
+      size_t stack_size = stack_depth * sizeof(void*) * 8;
+      if (stack_size < LINUX_THREAD_STACK_SIZE_MIN) {
+        stack_size = LINUX_THREAD_STACK_SIZE_MIN;
+      }
+      pthread_attr_setstacksize(&attr, stack_size);
+    }
+
+#ifdef LINUX_THREAD_SCHED_FIFO
+    const int SCHED_PRIORITY[] = {0, 10, 20, 40, 80};
+
+    if (priority != IDLE) {
+      struct sched_param param;
+      param.sched_priority = SCHED_PRIORITY[priority];
+      pthread_attr_setinheritsched(&attr, PTHREAD_EXPLICIT_SCHED);
+      pthread_attr_setschedpolicy(&attr, SCHED_FIFO);
+      pthread_attr_setschedparam(&attr, &param);
+    }
+#endif
+
+    if (cpu_mask == 0) {
+      cpu_mask = priority >= HIGH ? LINUX_THREAD_REALTIME_CPU_MASK
+                                  : LINUX_THREAD_NORMAL_CPU_MASK;
+    }
+
+    if (cpu_mask != 0) {
+      cpu_set_t cpu_set;
+      GetCpuSet(cpu_mask, cpu_set);
+      pthread_attr_setaffinity_np(&attr, sizeof(cpu_set), &cpu_set);
+    }
+
+    int ans = pthread_create(&this->handle_, &attr, port, info);
+    if (ans != 0) {
+      /* 没有实时调度权限时退回普通调度 */
+      pthread_attr_setinheritsched(&attr, PTHREAD_INHERIT_SCHED);
+      ans = pthread_create(&this->handle_, &attr, port, info);
+    }
+
+    pthread_attr_destroy(&attr);
+
+    if (ans != 0) {
+      fprintf(stderr, "Thread: can not create %s: %s.\n", info->name,
+              strerror(ans));
+      exit(-1);
+    }
+  }
+
+  /* 将线程绑定到cpu_mask中的核心，为0时不限制 */
+  bool SetAffinity(uint32_t cpu_mask) {
+    if (cpu_mask == 0) {
+      return true;
+    }
+
+    cpu_set_t cpu_set;
+    GetCpuSet(cpu_mask, cpu_set);
+
+    return pthread_setaffinity_np(this->handle_, sizeof(cpu_set), &cpu_set) ==
+           0;
   }
 
   static void Sleep(uint32_t microseconds) { poll(NULL, 0, microseconds); }
 
   void SleepUntil(uint32_t microseconds) {
-    last_weakup_tick_ += microseconds;
-    while (bsp_time_get_ms() < last_weakup_tick_) {
-      poll(NULL, 0, 1);
+    SleepUntilUs(static_cast<uint64_t>(microseconds) * 1000);
+  }
+
+  /* 基于单调时钟的绝对时间唤醒，周期不会累积误差 */
+  void SleepUntilUs(uint64_t period) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    last_weakup_time_.tv_sec += static_cast<time_t>(period / 1000000);
+    last_weakup_time_.tv_nsec += static_cast<long>(period % 1000000) * 1000;
+    if (last_weakup_time_.tv_nsec >= 1000000000L) {
+      last_weakup_time_.tv_sec++;
+      last_weakup_time_.tv_nsec -= 1000000000L;
+    }
+
+    /* 落后超过一个周期时重新对齐，避免连续补跑 */
+    int64_t late = (static_cast<int64_t>(now.tv_sec) -
+                    static_cast<int64_t>(last_weakup_time_.tv_sec)) *
+                       1000000000LL +
+                   (now.tv_nsec - last_weakup_time_.tv_nsec);
+    if (late > static_cast<int64_t>(period) * 1000) {
+      last_weakup_time_ = now;
+      return;
+    }
+
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &last_weakup_time_,
+                           NULL) == EINTR) {
     }
   }
 
   void Stop() { pthread_cancel(this->handle_); }
 
  private:
+  static void GetCpuSet(uint32_t cpu_mask, cpu_set_t& cpu_set) {
+    CPU_ZERO(&cpu_set);
+    for (uint32_t i = 0; i < 32; i++) {
+      if (cpu_mask & (1U << i)) {
+        CPU_SET(i, &cpu_set);
+      }
+    }
+  }
+
   pthread_t handle_;
-  uint32_t last_weakup_tick_ = bsp_time_get_ms();
+  struct timespec last_weakup_time_;
 };
 }  // namespace System
@@ -1,32 +1,252 @@
+#include <time.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <term.hpp>
 #include <timer.hpp>
 
+#include "ms.h"
+
 using namespace System;
 
 Timer* Timer::self_ = NULL;
 
+static ms_item_t timer_info;
+
 Timer::Timer() {
   self_ = this;
 
+  memset(this->block_, 0, sizeof(this->block_));
+
+  /* 超时基于单调时钟，不受系统时间调整影响 */
+  pthread_condattr_t attr;
+  pthread_condattr_init(&attr);
+  pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+  pthread_cond_init(&wakeup_, &attr);
+  pthread_condattr_destroy(&attr);
+
+  pthread_mutex_init(&mutex_, NULL);
+
   auto thread_fn = [](void* arg) {
     (void)arg;
-    while (1) {
-      Timer::self_->list_.Foreach(Timer::Refresh, NULL);
-      Timer::self_->thread_.SleepUntil(1);
-    }
+    Timer::self_->Run();
   };
 
   this->thread_.Create(thread_fn, static_cast<void*>(NULL), "timer_task", 256,
                        Thread::MEDIUM);
+
+  auto timer_cmd_fn = [](ms_item_t* item, int argc, char** argv) {
+    MS_UNUSED(item);
+    (void)argc;
+    (void)argv;
+
+    printf("id\tcycle(us)\toverrun\r\n");
+
+    pthread_mutex_lock(&self_->mutex_);
+    for (uint32_t i = 0; i < SYSTEM_TIMER_MAX_NUM; i++) {
+      ControlBlock* block = &self_->block_[i];
+      if (block->fun != NULL) {
+        printf("%u\t%llu\t\t%u\r\n", i,
+               static_cast<unsigned long long>(block->cycle), block->overrun);
+      }
+    }
+    pthread_mutex_unlock(&self_->mutex_);
+
+    return 0;
+  };
+
+  ms_file_init(&timer_info, "timer_info", timer_cmd_fn, NULL, NULL);
+  ms_cmd_add(&timer_info);
 }
 
-bool Timer::Refresh(ControlBlock& block, void* arg) {
-  (void)arg;
+uint64_t Timer::GetTimeUs() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return static_cast<uint64_t>(ts.tv_sec) * 1000000 + ts.tv_nsec / 1000;
+}
+
+Timer::ControlBlock* Timer::Add(void (*fun)(void*), void* type,
+                                uint64_t cycle) {
+  pthread_mutex_lock(&mutex_);
+
+  ControlBlock* block = NULL;
+  for (uint32_t i = 0; i < SYSTEM_TIMER_MAX_NUM; i++) {
+    if (this->block_[i].fun == NULL) {
+      block = &this->block_[i];
+      break;
+    }
+  }
+
+  /* 超过数量上限时调用者拿不到定时器，直接退出 */
+  if (block == NULL) {
+    pthread_mutex_unlock(&mutex_);
+    fprintf(stderr, "Timer: more than %d timers.\n", SYSTEM_TIMER_MAX_NUM);
+    exit(-1);
+  }
+
+  /* 周期为0时与原来一样每1ms运行一次 */
+  block->cycle = cycle > 0 ? cycle : 1000;
+  block->deadline = GetTimeUs() + block->cycle;
+  block->overrun = 0;
+  block->cancel = false;
+  block->fun = fun;
+  block->type = type;
+  Push(block);
+
+  pthread_cond_signal(&wakeup_);
+  pthread_mutex_unlock(&mutex_);
+
+  return block;
+}
+
+bool Timer::Cancel(ControlBlock* block) {
+  pthread_mutex_lock(&self_->mutex_);
+
+  if (block->fun == NULL || block->cancel) {
+    pthread_mutex_unlock(&self_->mutex_);
+    return false;
+  }
+
+  /* 正在运行的定时器由定时器线程在回调返回后释放 */
+  if (block == self_->running_) {
+    block->cancel = true;
+  } else {
+    self_->RemoveAt(block->index);
+    free(block->type);
+    block->fun = NULL;
+  }
+
+  pthread_mutex_unlock(&self_->mutex_);
+
+  return true;
+}
+
+bool Timer::ChangePeriodUs(ControlBlock* block, uint64_t cycle) {
+  pthread_mutex_lock(&self_->mutex_);
+
+  if (block->fun == NULL || block->cancel) {
+    pthread_mutex_unlock(&self_->mutex_);
+    return false;
+  }
+
+  block->cycle = cycle > 0 ? cycle : 1000;
 
-  block.count++;
-  if (block.cycle <= block.count) {
-    block.count = 0;
-    block.fun(block.type);
+  /* 正在运行的定时器在回调返回后加上新的周期 */
+  if (block == self_->running_) {
+    block->deadline = GetTimeUs();
+  } else {
+    block->deadline = GetTimeUs() + block->cycle;
+    self_->SiftUp(block->index);
+    self_->SiftDown(block->index);
   }
 
+  pthread_cond_signal(&self_->wakeup_);
+  pthread_mutex_unlock(&self_->mutex_);
+
   return true;
 }
+
+void Timer::Run() {
+  pthread_mutex_lock(&mutex_);
+
+  while (1) {
+    uint64_t now = GetTimeUs();
+
+    if (heap_size_ == 0) {
+      pthread_cond_wait(&wakeup_, &mutex_);
+      continue;
+    }
+
+    if (now < heap_[0]->deadline) {
+      /* 阻塞到最近的截止时间，新建或修改定时器时会被提前唤醒 */
+      struct timespec ts;
+      ts.tv_sec = static_cast<time_t>(heap_[0]->deadline / 1000000);
+      ts.tv_nsec = static_cast<long>(heap_[0]->deadline % 1000000) * 1000;
+      pthread_cond_timedwait(&wakeup_, &mutex_, &ts);
+      continue;
+    }
+
+    ControlBlock* block = heap_[0];
+    RemoveAt(0);
+    running_ = block;
+
+    pthread_mutex_unlock(&mutex_);
+
+    block->fun(block->type);
+
+    pthread_mutex_lock(&mutex_);
+
+    running_ = NULL;
+
+    if (block->cancel) {
+      free(block->type);
+      block->fun = NULL;
+    } else {
+      now = GetTimeUs();
+      block->deadline += block->cycle;
+      if (block->deadline <= now) {
+        uint64_t miss = (now - block->deadline) / block->cycle + 1;
+        block->overrun += static_cast<uint32_t>(miss);
+        block->deadline += miss * block->cycle;
+      }
+      Push(block);
+    }
+  }
+}
+
+void Timer::Push(ControlBlock* block) {
+  block->index = heap_size_;
+  heap_[heap_size_++] = block;
+  SiftUp(block->index);
+}
+
+void Timer::RemoveAt(uint32_t index) {
+  heap_size_--;
+  if (index == heap_size_) {
+    return;
+  }
+
+  Swap(index, heap_size_);
+  SiftUp(index);
+  SiftDown(index);
+}
+
+void Timer::SiftUp(uint32_t index) {
+  while (index > 0) {
+    uint32_t parent = (index - 1) / 2;
+    if (heap_[index]->deadline >= heap_[parent]->deadline) {
+      break;
+    }
+    Swap(index, parent);
+    index = parent;
+  }
+}
+
+void Timer::SiftDown(uint32_t index) {
+  while (1) {
+    uint32_t min = index;
+    uint32_t left = 2 * index + 1, right = 2 * index + 2;
+
+    if (left < heap_size_ && heap_[left]->deadline < heap_[min]->deadline) {
+      min = left;
+    }
+    if (right < heap_size_ && heap_[right]->deadline < heap_[min]->deadline) {
+      min = right;
+    }
+    if (min == index) {
+      break;
+    }
+
+    Swap(index, min);
+    index = min;
+  }
+}
+
+void Timer::Swap(uint32_t a, uint32_t b) {
+  ControlBlock* tmp = heap_[a];
+  heap_[a] = heap_[b];
+  heap_[b] = tmp;
+  heap_[a]->index = a;
+  heap_[b]->index = b;
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdlib>
+#include <scheduler.hpp>
+
+#include "om.hpp"
+
+namespace System {
+template <typename Data>
+class Queue {
+ public:
+  Queue(uint16_t length) {
+    om_fifo_create(&fifo_, malloc(length * sizeof(Data)), length, sizeof(Data));
+  }
+
+  bool Send(const Data& data, uint32_t timeout) {
+    uint64_t wakeup = GetWakeup(timeout);
+
+    while (om_fifo_write(&fifo_, &data) != OM_OK) {
+      if (timeout == 0 || !Scheduler::Wait(&not_full_, wakeup)) {
+        return false;
+      }
+    }
+
+    Scheduler::Notify(&not_empty_);
+
+    return true;
+  }
+
+  bool Receive(Data& data, uint32_t timeout) {
+    uint64_t wakeup = GetWakeup(timeout);
+
+    while (om_fifo_read(&fifo_, &data) != OM_OK) {
+      if (timeout == 0 || !Scheduler::Wait(&not_empty_, wakeup)) {
+        return false;
+      }
+    }
+
+    Scheduler::Notify(&not_full_);
+
+    return true;
+  }
+
+  bool Overwrite(const Data& data) {
+    bool ans = om_fifo_overwrite(&fifo_, &data) == OM_OK;
+
+    if (ans) {
+      Scheduler::Notify(&not_empty_);
+    }
+
+    return ans;
+  }
+
+  bool SendFromISR(const Data& data) { return Send(data, 0); }
+
+  bool ReceiveFromISR(Data& data) { return Receive(data, 0); }
+
+  bool OverwriteFromISR(const Data& data) { return Overwrite(data); }
+
+  bool Reset() {
+    bool ans = om_fifo_reset(&fifo_) == OM_OK;
+
+    Scheduler::NotifyAll(&not_full_);
+
+    return ans;
+  }
+
+  uint32_t Size() { return om_fifo_readable_item_count(&fifo_); }
+
+ private:
+  static uint64_t GetWakeup(uint32_t timeout) {
+    if (timeout == UINT32_MAX) {
+      return UINT64_MAX;
+    }
+
+    return Scheduler::GetTimeUs() + static_cast<uint64_t>(timeout) * 1000;
+  }
+
+  om_fifo_t fifo_;
+
+  /* 只用作等待对象的地址 */
+  uint8_t not_empty_;
+  uint8_t not_full_;
+};
+}  // namespace System
@@ -0,0 +1,216 @@
+#include <scheduler.hpp>
+
+#include <cstdio>
+#include <cstdlib>
+
+#include "bsp_time.h"
+
+using namespace System;
+
+pthread_mutex_t Scheduler::mutex_ = PTHREAD_MUTEX_INITIALIZER;
+
+Scheduler::Task* Scheduler::list_ = NULL;
+
+Scheduler::Task* Scheduler::current_ = NULL;
+
+uint64_t Scheduler::seq_ = 0;
+
+thread_local Scheduler::Task* Scheduler::self_ = NULL;
+
+Scheduler::Task* Scheduler::Alloc(uint8_t priority) {
+  Task* task = static_cast<Task*>(malloc(sizeof(Task)));
+
+  pthread_cond_init(&task->cond, NULL);
+  task->wait = NULL;
+  task->wakeup = UINT64_MAX;
+  task->seq = ++seq_;
+  task->priority = priority;
+  task->ready = true;
+  task->notified = false;
+  task->next = NULL;
+
+  /* 按创建顺序排列，同时唤醒的线程按这个顺序就绪 */
+  Task** pos = &list_;
+  while (*pos != NULL) {
+    pos = &(*pos)->next;
+  }
+  *pos = task;
+
+  return task;
+}
+
+Scheduler::Task* Scheduler::Self() {
+  if (self_ != NULL) {
+    return self_;
+  }
+
+  /* 第一个调用调度器的线程(main)直接成为运行中的线程 */
+  if (current_ != NULL) {
+    fprintf(stderr, "Scheduler: thread not created by System::Thread.\n");
+    abort();
+  }
+
+  pthread_mutex_lock(&mutex_);
+  self_ = Alloc(0);
+  current_ = self_;
+
+  return self_;
+}
+
+Scheduler::Task* Scheduler::Create(uint8_t priority) {
+  Self();
+  return Alloc(priority);
+}
+
+void Scheduler::Start(Task* task) {
+  pthread_mutex_lock(&mutex_);
+
+  self_ = task;
+
+  while (current_ != task) {
+    pthread_cond_wait(&task->cond, &mutex_);
+  }
+}
+
+void Scheduler::Exit() {
+  Task* self = Self();
+
+  Task** pos = &list_;
+  while (*pos != self) {
+    pos = &(*pos)->next;
+  }
+  *pos = self->next;
+
+  HandOver(NULL);
+
+  self_ = NULL;
+  pthread_mutex_unlock(&mutex_);
+
+  pthread_cond_destroy(&self->cond);
+  free(self);
+}
+
+bool Scheduler::Wait(const void* obj, uint64_t wakeup) {
+  Task* self = Self();
+
+  self->wait = obj;
+  self->wakeup = wakeup;
+  self->ready = false;
+  self->notified = false;
+  self->seq = ++seq_;
+
+  HandOver(self);
+
+  self->wait = NULL;
+
+  return self->notified;
+}
+
+void Scheduler::Notify(const void* obj) {
+  Self();
+
+  Task* best = NULL;
+
+  for (Task* task = list_; task != NULL; task = task->next) {
+    if (task->ready || task->wait != obj || obj == NULL) {
+      continue;
+    }
+    if (best == NULL || task->priority > best->priority ||
+        (task->priority == best->priority && task->seq < best->seq)) {
+      best = task;
+    }
+  }
+
+  if (best != NULL) {
+    best->wakeup = UINT64_MAX;
+    best->ready = true;
+    best->notified = true;
+    best->seq = ++seq_;
+  }
+}
+
+void Scheduler::NotifyAll(const void* obj) {
+  Self();
+
+  for (Task* task = list_; task != NULL; task = task->next) {
+    if (!task->ready && task->wait == obj && obj != NULL) {
+      task->wakeup = UINT64_MAX;
+      task->ready = true;
+      task->notified = true;
+      task->seq = ++seq_;
+    }
+  }
+}
+
+void Scheduler::Yield() {
+  Task* self = Self();
+
+  self->seq = ++seq_;
+
+  HandOver(self);
+}
+
+uint64_t Scheduler::GetTimeUs() { return bsp_time_get_ns() / 1000; }
+
+Scheduler::Task* Scheduler::Pick() {
+  Task* best = NULL;
+
+  for (Task* task = list_; task != NULL; task = task->next) {
+    if (!task->ready) {
+      continue;
+    }
+    if (best == NULL || task->priority > best->priority ||
+        (task->priority == best->priority && task->seq < best->seq)) {
+      best = task;
+    }
+  }
+
+  return best;
+}
+
+void Scheduler::HandOver(Task* self) {
+  Task* next = Pick();
+
+  /* 没有可运行的线程时推进虚拟时钟 */
+  while (next == NULL) {
+    uint64_t wakeup = UINT64_MAX;
+    for (Task* task = list_; task != NULL; task = task->next) {
+      if (task->wakeup < wakeup) {
+        wakeup = task->wakeup;
+      }
+    }
+
+    if (wakeup == UINT64_MAX) {
+      fprintf(stderr, "Scheduler: all threads blocked forever.\n");
+      exit(1);
+    }
+
+    bsp_time_advance_to(wakeup);
+
+    for (Task* task = list_; task != NULL; task = task->next) {
+      if (task->wakeup <= wakeup) {
+        task->wakeup = UINT64_MAX;
+        task->ready = true;
+        task->seq = ++seq_;
+      }
+    }
+
+    next = Pick();
+  }
+
+  current_ = next;
+
+  if (next == self) {
+    return;
+  }
+
+  pthread_cond_signal(&next->cond);
+
+  if (self == NULL) {
+    return;
+  }
+
+  while (current_ != self) {
+    pthread_cond_wait(&self->cond, &mutex_);
+  }
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <pthread.h>
+
+#include <cstdint>
+
+namespace System {
+/* 虚拟时间调度器。所有线程共用一把锁，同一时刻只有一个线程运行，
+   只在阻塞时切换；所有线程都阻塞时把虚拟时钟推进到最近的唤醒时间 */
+class Scheduler {
+ public:
+  typedef struct Task {
+    pthread_cond_t cond;
+    const void* wait; /* 等待的对象，NULL表示只等待超时 */
+    uint64_t wakeup;  /* 唤醒时间，UINT64_MAX表示不会超时 */
+    uint64_t seq;     /* 进入就绪或等待状态的顺序 */
+    uint8_t priority;
+    bool ready;
+    bool notified;
+    struct Task* next;
+  } Task;
+
+  /* 在创建者中登记新线程，新线程处于就绪状态 */
+  static Task* Create(uint8_t priority);
+
+  /* 在新线程中调用，等到第一次被调度后返回 */
+  static void Start(Task* task);
+
+  /* 线程函数返回时调用 */
+  static void Exit();
+
+  /* 阻塞直到被Notify或到达wakeup，返回是否被Notify */
+  static bool Wait(const void* obj, uint64_t wakeup);
+
+  /* 唤醒等待obj的优先级最高的线程 */
+  static void Notify(const void* obj);
+
+  static void NotifyAll(const void* obj);
+
+  static void Yield();
+
+  static uint64_t GetTimeUs();
+
+ private:
+  static Task* Alloc(uint8_t priority);
+
+  static Task* Self();
+
+  static Task* Pick();
+
+  static void HandOver(Task* self);
+
+  static pthread_mutex_t mutex_;
+  static Task* list_;
+  static Task* current_;
+  static uint64_t seq_;
+  static thread_local Task* self_;
+};
+}  // namespace System
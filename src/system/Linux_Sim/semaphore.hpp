@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+#include <scheduler.hpp>
+#include <thread.hpp>
+
+namespace System {
+/* 所有线程由调度器串行运行，计数不需要额外加锁 */
+class Semaphore {
+ public:
+  Semaphore(bool init_count) : count_(init_count), max_count_(1) {}
+
+  Semaphore(uint16_t max_count, uint16_t init_count)
+      : count_(init_count), max_count_(max_count) {}
+
+  void Give() {
+    if (this->count_ < this->max_count_) {
+      this->count_++;
+      Scheduler::Notify(this);
+    }
+  }
+
+  bool Take(uint32_t timeout) {
+    uint64_t wakeup = timeout == UINT32_MAX
+                          ? UINT64_MAX
+                          : Scheduler::GetTimeUs() +
+                                static_cast<uint64_t>(timeout) * 1000;
+
+    while (this->count_ == 0) {
+      if (timeout == 0 || !Scheduler::Wait(this, wakeup)) {
+        break;
+      }
+    }
+
+    if (this->count_ == 0) {
+      return false;
+    }
+
+    this->count_--;
+
+    return true;
+  }
+
+  uint32_t GetCount() { return this->count_; }
+
+  void GiveFromISR() { Give(); }
+  bool TakeFromISR() { return Take(0); }
+
+ private:
+  uint32_t count_;
+  uint32_t max_count_;
+};
+}  // namespace System
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <pthread.h>
+
+#include <cstdint>
+#include <scheduler.hpp>
+#include <string>
+
+#include "system_ext.hpp"
+
+namespace System {
+class Thread {
+ public:
+  typedef enum { IDLE, LOW, MEDIUM, HIGH, REALTIME } Priority;
+
+  Thread() : last_wakeup_time_(Scheduler::GetTimeUs()) {}
+
+  template <typename FunType, typename ArgType>
+  void Create(FunType fun, ArgType arg, const char* name, uint32_t stack_depth,
+              Priority priority, uint32_t cpu_mask = 0) {
+    (void)cpu_mask;
+    (void)name;
+    (void)stack_depth;
+
+    (void)static_cast<void (*)(ArgType)>(fun);
+
+    typedef struct {
+      TypeErasure<void, ArgType> type;
+      Scheduler::Task* task;
+    } ThreadInfo;
+
+    ThreadInfo* info = static_cast<ThreadInfo*>(malloc(sizeof(ThreadInfo)));
+
+    info->type = TypeErasure<void, ArgType>(fun, arg);
+
+    /* 在创建者中登记，保证线程的就绪顺序只取决于创建顺序 */
+    info->task = Scheduler::Create(priority);
+
+    auto port = [](void* arg) {
+      ThreadInfo* info = static_cast<ThreadInfo*>(arg);
+      Scheduler::Start(info->task);
+      info->type.fun_(info->type.arg_);
+      Scheduler::Exit();
+      free(info);
+      return static_cast<void*>(NULL);
+    };
+
+    pthread_create(&this->handle_, NULL, port, info);
+  }
+
+  static void Sleep(uint32_t microseconds) {
+    Scheduler::Wait(NULL, Scheduler::GetTimeUs() +
+                              static_cast<uint64_t>(microseconds) * 1000);
+  }
+
+  void SleepUntil(uint32_t microseconds) {
+    uint64_t period = static_cast<uint64_t>(microseconds) * 1000;
+    uint64_t now = Scheduler::GetTimeUs();
+
+    last_wakeup_time_ += period;
+
+    /* 落后超过一个周期时重新对齐，避免连续补跑 */
+    if (now > last_wakeup_time_ + period) {
+      last_wakeup_time_ = now;
+      return;
+    }
+
+    Scheduler::Wait(NULL, last_wakeup_time_);
+  }
+
+  void Stop() { pthread_cancel(this->handle_); }
+
+ private:
+  pthread_t handle_;
+  uint64_t last_wakeup_time_; /* 虚拟时间，单位为微秒 */
+};
+}  // namespace System
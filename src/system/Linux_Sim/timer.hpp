@@ -0,0 +1,71 @@
+#pragma once
+
+#include <scheduler.hpp>
+#include <thread.hpp>
+
+#include "system_ext.hpp"
+
+#define SYSTEM_TIMER_MAX_NUM (32) /* 定时器数量上限 */
+
+namespace System {
+class Timer {
+ public:
+  typedef struct {
+    void* type;
+    void (*fun)(void*);
+    uint64_t cycle; /* 单位为微秒 */
+    uint64_t deadline;
+    uint32_t overrun; /* 因回调超时而跳过的周期数 */
+    uint32_t index;   /* 在堆中的位置 */
+    bool cancel;
+  } ControlBlock;
+
+  Timer();
+
+  template <typename FunType, typename ArgType>
+  static ControlBlock* Create(FunType fun, ArgType arg, uint32_t cycle) {
+    return CreateUs(fun, arg, static_cast<uint64_t>(cycle) * 1000);
+  }
+
+  /* 周期可以小于1ms */
+  template <typename FunType, typename ArgType>
+  static ControlBlock* CreateUs(FunType fun, ArgType arg, uint64_t cycle) {
+    (void)static_cast<void (*)(ArgType)>(fun);
+    TypeErasure<void, ArgType>* type = static_cast<TypeErasure<void, ArgType>*>(
+        malloc(sizeof(TypeErasure<void, ArgType>)));
+    *type = TypeErasure<void, ArgType>(fun, arg);
+    return self_->Add(type->Port, type, cycle);
+  }
+
+  /* 取消后block不能再使用 */
+  static bool Cancel(ControlBlock* block);
+
+  static bool ChangePeriod(ControlBlock* block, uint32_t cycle) {
+    return ChangePeriodUs(block, static_cast<uint64_t>(cycle) * 1000);
+  }
+
+  static bool ChangePeriodUs(ControlBlock* block, uint64_t cycle);
+
+  static Timer* self_;
+
+ private:
+  ControlBlock* Add(void (*fun)(void*), void* type, uint64_t cycle);
+
+  static uint64_t GetTimeUs();
+
+  void Push(ControlBlock* block);
+  void RemoveAt(uint32_t index);
+  void SiftUp(uint32_t index);
+  void SiftDown(uint32_t index);
+  void Swap(uint32_t a, uint32_t b);
+
+  void Run();
+
+  ControlBlock block_[SYSTEM_TIMER_MAX_NUM];
+  ControlBlock* heap_[SYSTEM_TIMER_MAX_NUM];
+  uint32_t heap_size_ = 0;
+  ControlBlock* running_ = NULL;
+
+  Thread thread_;
+};
+}  // namespace System
@@ -73,6 +73,9 @@ class Database {
     const char* name_;
   };
 
+  /* 写入是同步完成的 */
+  static void Sync() {}
+
   static std::string path_;
 };
 }  // namespace System
@@ -1,134 +1,137 @@
 #pragma once
 
-#include <mutex.hpp>
-#include <semaphore.hpp>
-#include <thread.hpp>
+#include <pthread.h>
+#include <time.h>
+
+#include <cstdint>
+#include <cstdlib>
 
 #include "bsp_time.h"
 #include "om.hpp"
 
+/* 仿真时间只在wb_robot_step时推进，超时检查以该周期重新判断 */
+#define QUEUE_SIM_TIME_POLL_NS (1000000L)
+
 namespace System {
 template <typename Data>
 class Queue {
  public:
   Queue(uint16_t length) {
     om_fifo_create(&fifo_, malloc(length * sizeof(Data)), length, sizeof(Data));
+
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&not_empty_, &attr);
+    pthread_cond_init(&not_full_, &attr);
+    pthread_condattr_destroy(&attr);
+
+    pthread_mutex_init(&mutex_, NULL);
   }
 
   bool Send(const Data& data, uint32_t timeout) {
     uint32_t start_time = bsp_time_get_ms();
-    if (!mutex_.Lock(timeout)) {
-      return false;
-    }
 
-    if (om_fifo_write(&fifo_, &data) == OM_OK) {
-      mutex_.Unlock();
-      return true;
-    }
+    pthread_mutex_lock(&mutex_);
+
+    bool timed_out = false;
 
-    bool ans = false;
-    while (bsp_time_get_ms() - start_time < timeout) {
-      ans = om_fifo_write(&fifo_, &data) == OM_OK;
-      if (ans) {
-        break;
+    while (om_fifo_write(&fifo_, &data) != OM_OK) {
+      if (timed_out) {
+        pthread_mutex_unlock(&mutex_);
+        return false;
       }
-      System::Thread::Sleep(1);
+      timed_out = !Wait(not_full_, start_time, timeout);
     }
 
-    mutex_.Unlock();
+    pthread_cond_signal(&not_empty_);
+    pthread_mutex_unlock(&mutex_);
 
-    return ans;
+    return true;
   }
 
   bool Receive(Data& data, uint32_t timeout) {
     uint32_t start_time = bsp_time_get_ms();
-    if (!mutex_.Lock(timeout)) {
-      return false;
-    }
 
-    if (om_fifo_read(&fifo_, &data) == OM_OK) {
-      mutex_.Unlock();
-      return true;
-    }
+    pthread_mutex_lock(&mutex_);
+
+    bool timed_out = false;
 
-    bool ans = false;
-    while (bsp_time_get_ms() - start_time < timeout) {
-      ans = om_fifo_read(&fifo_, &data) == OM_OK;
-      if (ans) {
-        break;
+    while (om_fifo_read(&fifo_, &data) != OM_OK) {
+      if (timed_out) {
+        pthread_mutex_unlock(&mutex_);
+        return false;
       }
-      System::Thread::Sleep(1);
+      timed_out = !Wait(not_empty_, start_time, timeout);
     }
 
-    mutex_.Unlock();
+    pthread_cond_signal(&not_full_);
+    pthread_mutex_unlock(&mutex_);
 
-    return ans;
+    return true;
   }
 
   bool Overwrite(const Data& data) {
-    if (!mutex_.Lock(0)) {
-      return false;
-    }
+    pthread_mutex_lock(&mutex_);
 
     bool ans = om_fifo_overwrite(&fifo_, &data) == OM_OK;
 
-    mutex_.Unlock();
-
-    return ans;
-  }
-
-  bool SendFromISR(const Data& data) {
-    if (!mutex_.LockFromISR()) {
-      return false;
+    if (ans) {
+      pthread_cond_signal(&not_empty_);
     }
 
-    bool ans = om_fifo_write(&fifo_, &data) == OM_OK;
-
-    mutex_.UnlockFromISR();
+    pthread_mutex_unlock(&mutex_);
 
     return ans;
   }
 
-  bool ReceiveFromISR(Data& data) {
-    if (!mutex_.LockFromISR()) {
-      return false;
-    }
-
-    bool ans = om_fifo_read(&fifo_, &data) == OM_OK;
+  bool SendFromISR(const Data& data) { return Send(data, 0); }
 
-    mutex_.UnlockFromISR();
+  bool ReceiveFromISR(Data& data) { return Receive(data, 0); }
 
-    return ans;
-  }
+  bool OverwriteFromISR(const Data& data) { return Overwrite(data); }
 
-  bool OverwriteFromISR(const Data& data) {
-    if (!mutex_.LockFromISR()) {
-      return false;
-    }
+  bool Reset() {
+    pthread_mutex_lock(&mutex_);
 
-    bool ans = om_fifo_overwrite(&fifo_, &data) == OM_OK;
+    bool ans = om_fifo_reset(&fifo_) == OM_OK;
 
-    mutex_.UnlockFromISR();
+    pthread_cond_broadcast(&not_full_);
+    pthread_mutex_unlock(&mutex_);
 
     return ans;
   }
 
-  bool Reset() {
-    if (!mutex_.Lock(0)) {
+  uint32_t Size() { return om_fifo_readable_item_count(&fifo_); }
+
+ private:
+  /* 等待条件变量，返回false表示仿真时间已经超时 */
+  bool Wait(pthread_cond_t& cond, uint32_t start_time, uint32_t timeout) {
+    if (timeout == UINT32_MAX) {
+      pthread_cond_wait(&cond, &mutex_);
+      return true;
+    }
+
+    if (bsp_time_get_ms() - start_time >= timeout) {
       return false;
     }
 
-    bool ans = om_fifo_reset(&fifo_) == OM_OK;
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    ts.tv_nsec += QUEUE_SIM_TIME_POLL_NS;
+    if (ts.tv_nsec >= 1000000000L) {
+      ts.tv_sec++;
+      ts.tv_nsec -= 1000000000L;
+    }
 
-    mutex_.Unlock();
+    pthread_cond_timedwait(&cond, &mutex_, &ts);
 
-    return ans;
+    return true;
   }
 
-  uint32_t Size() { return om_fifo_readable_item_count(&fifo_); }
-
- private:
   om_fifo_t fifo_;
-  System::Mutex mutex_;
+  pthread_mutex_t mutex_;
+  pthread_cond_t not_empty_;
+  pthread_cond_t not_full_;
 };
 }  // namespace System
@@ -15,7 +15,8 @@ class Thread {
 
   template <typename FunType, typename ArgType>
   void Create(FunType fun, ArgType arg, const char* name, uint32_t stack_depth,
-              Priority priority) {
+              Priority priority, uint32_t cpu_mask = 0) {
+    (void)cpu_mask;
     (void)name;
     (void)stack_depth;
     (void)priority;
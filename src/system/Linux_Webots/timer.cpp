@@ -1,32 +1,233 @@
+#include <poll.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <term.hpp>
 #include <timer.hpp>
 
+#include "ms.h"
+
 using namespace System;
 
 Timer* Timer::self_ = NULL;
 
+static ms_item_t timer_info;
+
 Timer::Timer() {
   self_ = this;
 
+  memset(this->block_, 0, sizeof(this->block_));
+
   auto thread_fn = [](void* arg) {
     (void)arg;
-    while (1) {
-      Timer::self_->list_.Foreach(Timer::Refresh, NULL);
-      Timer::self_->thread_.SleepUntil(1);
-    }
+    Timer::self_->Run();
   };
 
   this->thread_.Create(thread_fn, static_cast<void*>(NULL), "timer_task", 256,
                        Thread::MEDIUM);
+
+  auto timer_cmd_fn = [](ms_item_t* item, int argc, char** argv) {
+    MS_UNUSED(item);
+    (void)argc;
+    (void)argv;
+
+    printf("id\tcycle\toverrun\r\n");
+
+    self_->mutex_.Lock(UINT32_MAX);
+    for (uint32_t i = 0; i < SYSTEM_TIMER_MAX_NUM; i++) {
+      ControlBlock* block = &self_->block_[i];
+      if (block->fun != NULL) {
+        printf("%u\t%u\t%u\r\n", static_cast<unsigned int>(i),
+               static_cast<unsigned int>(block->cycle),
+               static_cast<unsigned int>(block->overrun));
+      }
+    }
+    self_->mutex_.Unlock();
+
+    return 0;
+  };
+
+  ms_file_init(&timer_info, "timer_info", timer_cmd_fn, NULL, NULL);
+  ms_cmd_add(&timer_info);
 }
 
-bool Timer::Refresh(ControlBlock& block, void* arg) {
-  (void)arg;
+Timer::ControlBlock* Timer::Add(void (*fun)(void*), void* type,
+                                uint32_t cycle) {
+  mutex_.Lock(UINT32_MAX);
 
-  block.count++;
-  if (block.cycle <= block.count) {
-    block.count = 0;
-    block.fun(block.type);
+  ControlBlock* block = NULL;
+  for (uint32_t i = 0; i < SYSTEM_TIMER_MAX_NUM; i++) {
+    if (this->block_[i].fun == NULL) {
+      block = &this->block_[i];
+      break;
+    }
   }
 
+  /* 超过数量上限时调用者拿不到定时器，直接退出 */
+  if (block == NULL) {
+    mutex_.Unlock();
+    fprintf(stderr, "Timer: more than %d timers.\n", SYSTEM_TIMER_MAX_NUM);
+    exit(-1);
+  }
+
+  /* 周期为0时与原来一样每个tick运行一次 */
+  block->cycle = cycle > 0 ? cycle : 1;
+  block->deadline = bsp_time_get_ms() + block->cycle;
+  block->overrun = 0;
+  block->cancel = false;
+  block->fun = fun;
+  block->type = type;
+  Push(block);
+
+  mutex_.Unlock();
+
+  return block;
+}
+
+bool Timer::Cancel(ControlBlock* block) {
+  self_->mutex_.Lock(UINT32_MAX);
+
+  if (block->fun == NULL || block->cancel) {
+    self_->mutex_.Unlock();
+    return false;
+  }
+
+  /* 正在运行的定时器由定时器线程在回调返回后释放 */
+  if (block == self_->running_) {
+    block->cancel = true;
+  } else {
+    self_->RemoveAt(block->index);
+    free(block->type);
+    block->fun = NULL;
+  }
+
+  self_->mutex_.Unlock();
+
+  return true;
+}
+
+bool Timer::ChangePeriod(ControlBlock* block, uint32_t cycle) {
+  self_->mutex_.Lock(UINT32_MAX);
+
+  if (block->fun == NULL || block->cancel) {
+    self_->mutex_.Unlock();
+    return false;
+  }
+
+  block->cycle = cycle > 0 ? cycle : 1;
+
+  /* 正在运行的定时器在回调返回后加上新的周期 */
+  if (block == self_->running_) {
+    block->deadline = bsp_time_get_ms();
+  } else {
+    block->deadline = bsp_time_get_ms() + block->cycle;
+    self_->SiftUp(block->index);
+    self_->SiftDown(block->index);
+  }
+
+  self_->mutex_.Unlock();
+
   return true;
 }
+
+void Timer::Run() {
+  while (1) {
+    mutex_.Lock(UINT32_MAX);
+
+    uint32_t now = bsp_time_get_ms();
+
+    if (heap_size_ == 0 || Before(now, heap_[0]->deadline)) {
+      mutex_.Unlock();
+      /* 仿真时间只在wb_robot_step时推进，每次只检查堆顶 */
+      poll(NULL, 0, 1);
+      continue;
+    }
+
+    ControlBlock* block = heap_[0];
+    RemoveAt(0);
+    running_ = block;
+
+    mutex_.Unlock();
+
+    block->fun(block->type);
+
+    mutex_.Lock(UINT32_MAX);
+
+    running_ = NULL;
+
+    if (block->cancel) {
+      free(block->type);
+      block->fun = NULL;
+    } else {
+      now = bsp_time_get_ms();
+      block->deadline += block->cycle;
+      if (!Before(now, block->deadline)) {
+        uint32_t miss = (now - block->deadline) / block->cycle + 1;
+        block->overrun += miss;
+        block->deadline += miss * block->cycle;
+      }
+      Push(block);
+    }
+
+    mutex_.Unlock();
+  }
+}
+
+void Timer::Push(ControlBlock* block) {
+  block->index = heap_size_;
+  heap_[heap_size_++] = block;
+  SiftUp(block->index);
+}
+
+void Timer::RemoveAt(uint32_t index) {
+  heap_size_--;
+  if (index == heap_size_) {
+    return;
+  }
+
+  Swap(index, heap_size_);
+  SiftUp(index);
+  SiftDown(index);
+}
+
+void Timer::SiftUp(uint32_t index) {
+  while (index > 0) {
+    uint32_t parent = (index - 1) / 2;
+    if (!Before(heap_[index]->deadline, heap_[parent]->deadline)) {
+      break;
+    }
+    Swap(index, parent);
+    index = parent;
+  }
+}
+
+void Timer::SiftDown(uint32_t index) {
+  while (1) {
+    uint32_t min = index;
+    uint32_t left = 2 * index + 1, right = 2 * index + 2;
+
+    if (left < heap_size_ &&
+        Before(heap_[left]->deadline, heap_[min]->deadline)) {
+      min = left;
+    }
+    if (right < heap_size_ &&
+        Before(heap_[right]->deadline, heap_[min]->deadline)) {
+      min = right;
+    }
+    if (min == index) {
+      break;
+    }
+
+    Swap(index, min);
+    index = min;
+  }
+}
+
+void Timer::Swap(uint32_t a, uint32_t b) {
+  ControlBlock* tmp = heap_[a];
+  heap_[a] = heap_[b];
+  heap_[b] = tmp;
+  heap_[a]->index = a;
+  heap_[b]->index = b;
+}
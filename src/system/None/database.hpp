@@ -52,5 +52,8 @@ class Database {
     Data data_;
     const char* name_;
   };
+
+  /* 写入是同步完成的 */
+  static void Sync() {}
 };
 }  // namespace System
@@ -14,8 +14,8 @@ class Thread {
 
   template <typename FunType, typename ArgType>
   void Create(FunType fun, ArgType arg, const char* name, uint32_t stack_depth,
-              Priority priority) {
-    (void)(fun, arg, name, stack_depth, priority);
+              Priority priority, uint32_t cpu_mask = 0) {
+    (void)(fun, arg, name, stack_depth, priority, cpu_mask);
   }
 
   static void Sleep(uint32_t microseconds) { bsp_delay(microseconds); }
@@ -1,26 +1,198 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <term.hpp>
 #include <timer.hpp>
 
+#include "ms.h"
+
 using namespace System;
 
 Timer* Timer::self_ = NULL;
 
-Timer::Timer() { self_ = this; }
+static ms_item_t timer_info;
+
+Timer::Timer() {
+  self_ = this;
+
+  memset(this->block_, 0, sizeof(this->block_));
+}
+
+Timer::ControlBlock* Timer::Add(void (*fun)(void*), void* type,
+                                uint32_t cycle) {
+  ControlBlock* block = NULL;
+  for (uint32_t i = 0; i < SYSTEM_TIMER_MAX_NUM; i++) {
+    if (this->block_[i].fun == NULL) {
+      block = &this->block_[i];
+      break;
+    }
+  }
+
+  /* 超过数量上限时调用者拿不到定时器，直接退出 */
+  if (block == NULL) {
+    fprintf(stderr, "Timer: more than %d timers.\n", SYSTEM_TIMER_MAX_NUM);
+    exit(-1);
+  }
+
+  /* 周期为0时与原来一样每个tick运行一次 */
+  block->cycle = cycle > 0 ? cycle : 1;
+  block->deadline = bsp_time_get_ms() + block->cycle;
+  block->overrun = 0;
+  block->cancel = false;
+  block->fun = fun;
+  block->type = type;
+  Push(block);
+
+  return block;
+}
+
+bool Timer::Cancel(ControlBlock* block) {
+  if (block->fun == NULL || block->cancel) {
+    return false;
+  }
+
+  /* 正在运行的定时器在回调返回后释放 */
+  if (block == self_->running_) {
+    block->cancel = true;
+  } else {
+    self_->RemoveAt(block->index);
+    free(block->type);
+    block->fun = NULL;
+  }
+
+  return true;
+}
+
+bool Timer::ChangePeriod(ControlBlock* block, uint32_t cycle) {
+  if (block->fun == NULL || block->cancel) {
+    return false;
+  }
+
+  block->cycle = cycle > 0 ? cycle : 1;
+
+  /* 正在运行的定时器在回调返回后加上新的周期 */
+  if (block == self_->running_) {
+    block->deadline = bsp_time_get_ms();
+  } else {
+    block->deadline = bsp_time_get_ms() + block->cycle;
+    self_->SiftUp(block->index);
+    self_->SiftDown(block->index);
+  }
+
+  return true;
+}
 
 void Timer::Start() {
+  /* 定时器先于终端创建，在这里注册命令 */
+  auto timer_cmd_fn = [](ms_item_t* item, int argc, char** argv) {
+    MS_UNUSED(item);
+    (void)argc;
+    (void)argv;
+
+    printf("id\tcycle\toverrun\r\n");
+
+    for (uint32_t i = 0; i < SYSTEM_TIMER_MAX_NUM; i++) {
+      ControlBlock* block = &self_->block_[i];
+      if (block->fun != NULL) {
+        printf("%u\t%u\t%u\r\n", static_cast<unsigned int>(i),
+               static_cast<unsigned int>(block->cycle),
+               static_cast<unsigned int>(block->overrun));
+      }
+    }
+
+    return 0;
+  };
+
+  ms_file_init(&timer_info, "timer_info", timer_cmd_fn, NULL, NULL);
+  ms_cmd_add(&timer_info);
+
+  self_->Run();
+}
+
+void Timer::Run() {
   while (1) {
-    Timer::self_->list_.Foreach(Timer::Refresh, NULL);
-    Timer::self_->thread_.SleepUntil(1);
+    uint32_t now = bsp_time_get_ms();
+
+    if (heap_size_ == 0 || Before(now, heap_[0]->deadline)) {
+      continue;
+    }
+
+    ControlBlock* block = heap_[0];
+    RemoveAt(0);
+    running_ = block;
+    block->fun(block->type);
+    running_ = NULL;
+
+    if (block->cancel) {
+      free(block->type);
+      block->fun = NULL;
+    } else {
+      now = bsp_time_get_ms();
+      block->deadline += block->cycle;
+      if (!Before(now, block->deadline)) {
+        uint32_t miss = (now - block->deadline) / block->cycle + 1;
+        block->overrun += miss;
+        block->deadline += miss * block->cycle;
+      }
+      Push(block);
+    }
+  }
+}
+
+void Timer::Push(ControlBlock* block) {
+  block->index = heap_size_;
+  heap_[heap_size_++] = block;
+  SiftUp(block->index);
+}
+
+void Timer::RemoveAt(uint32_t index) {
+  heap_size_--;
+  if (index == heap_size_) {
+    return;
+  }
+
+  Swap(index, heap_size_);
+  SiftUp(index);
+  SiftDown(index);
+}
+
+void Timer::SiftUp(uint32_t index) {
+  while (index > 0) {
+    uint32_t parent = (index - 1) / 2;
+    if (!Before(heap_[index]->deadline, heap_[parent]->deadline)) {
+      break;
+    }
+    Swap(index, parent);
+    index = parent;
   }
 }
 
-bool Timer::Refresh(ControlBlock& block, void* arg) {
-  (void)arg;
+void Timer::SiftDown(uint32_t index) {
+  while (1) {
+    uint32_t min = index;
+    uint32_t left = 2 * index + 1, right = 2 * index + 2;
+
+    if (left < heap_size_ &&
+        Before(heap_[left]->deadline, heap_[min]->deadline)) {
+      min = left;
+    }
+    if (right < heap_size_ &&
+        Before(heap_[right]->deadline, heap_[min]->deadline)) {
+      min = right;
+    }
+    if (min == index) {
+      break;
+    }
 
-  block.count++;
-  if (block.cycle <= block.count) {
-    block.count = 0;
-    block.fun(block.type);
+    Swap(index, min);
+    index = min;
   }
+}
 
-  return true;
+void Timer::Swap(uint32_t a, uint32_t b) {
+  ControlBlock* tmp = heap_[a];
+  heap_[a] = heap_[b];
+  heap_[b] = tmp;
+  heap_[a]->index = a;
+  heap_[b]->index = b;
 }
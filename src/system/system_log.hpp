@@ -0,0 +1,287 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <thread.hpp>
+#include <type_traits>
+
+#include "bsp_time.h"
+#include "om.hpp"
+
+#define LOG_RING_LEN (64)     /* 日志缓冲区长度，必须为2的幂 */
+#define LOG_ARG_MAX_NUM (4)   /* 单条日志的参数数量上限 */
+#define LOG_DRAIN_CYCLE (10)  /* 后台格式化周期，单位为毫秒 */
+#define LOG_STACK_DEPTH (512) /* 后台线程堆栈大小 */
+
+#define DLOG_DEFAULT(...) System::Log::Write(System::Log::DEFAULT, __VA_ARGS__)
+#define DLOG_NOTICE(...) System::Log::Write(System::Log::NOTICE, __VA_ARGS__)
+#define DLOG_PASS(...) System::Log::Write(System::Log::PASS, __VA_ARGS__)
+#define DLOG_WARNING(...) System::Log::Write(System::Log::WARNING, __VA_ARGS__)
+#define DLOG_ERROR(...) System::Log::Write(System::Log::ERROR, __VA_ARGS__)
+
+namespace System {
+/* 延迟格式化的日志。调用者只写入格式字符串指针、时间戳和原始参数，
+   不加锁也不格式化；后台线程取出后格式化，再通过om_log输出。
+   字符串参数只保存指针，格式化之前必须保持有效。
+   None系统没有线程，不会输出 */
+class Log {
+ public:
+  typedef enum { DEFAULT, NOTICE, PASS, WARNING, ERROR } Level;
+
+  typedef enum : uint8_t { ARG_INT, ARG_UINT, ARG_DOUBLE, ARG_PTR } ArgType;
+
+  typedef union {
+    int64_t i;
+    uint64_t u;
+    double f;
+    const void* p;
+  } Arg;
+
+  typedef struct {
+    /* 减去所在位置后的序号，全为0时表示空缓冲区 */
+    std::atomic<uint32_t> seq;
+    uint8_t level;
+    uint8_t arg_num;
+    ArgType arg_type[LOG_ARG_MAX_NUM];
+    uint32_t time;
+    const char* fmt; /* 同一固件中地址不变，可以作为格式ID */
+    Arg arg[LOG_ARG_MAX_NUM];
+  } Record;
+
+  template <typename... Args>
+  static void Write(Level level, const char* fmt, Args... args) {
+    static_assert(sizeof...(Args) <= LOG_ARG_MAX_NUM, "too many log args");
+
+    uint32_t pos = head_.load(std::memory_order_relaxed);
+    Record* record = NULL;
+
+    /* 多个生产者通过CAS占用位置，缓冲区满时丢弃 */
+    while (1) {
+      record = &ring_[pos & (LOG_RING_LEN - 1)];
+      int32_t diff = static_cast<int32_t>(
+          record->seq.load(std::memory_order_acquire) +
+          (pos & (LOG_RING_LEN - 1)) - pos);
+
+      if (diff == 0) {
+        if (head_.compare_exchange_weak(pos, pos + 1,
+                                        std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (diff < 0) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return;
+      } else {
+        pos = head_.load(std::memory_order_relaxed);
+      }
+    }
+
+    record->level = level;
+    record->fmt = fmt;
+    record->time = bsp_time_get_ms();
+    record->arg_num = sizeof...(Args);
+
+    uint8_t index = 0;
+    (Encode(*record, index++, args), ...);
+    (void)index;
+
+    record->seq.store(pos + 1 - (pos & (LOG_RING_LEN - 1)),
+                      std::memory_order_release);
+  }
+
+  /* 在后台线程中格式化并输出所有已经写入的日志 */
+  static void Drain() {
+    static char buff[OM_LOG_MAX_LEN];
+
+    while (1) {
+      Record& record = ring_[tail_ & (LOG_RING_LEN - 1)];
+      if (record.seq.load(std::memory_order_acquire) +
+              (tail_ & (LOG_RING_LEN - 1)) !=
+          tail_ + 1) {
+        break;
+      }
+
+      int len = snprintf(buff, sizeof(buff), "[%.3f] ",
+                         static_cast<double>(record.time) / 1000.0);
+      Format(record, buff + len, sizeof(buff) - len);
+
+      Output(static_cast<Level>(record.level), buff);
+
+      record.seq.store(tail_ + LOG_RING_LEN - (tail_ & (LOG_RING_LEN - 1)),
+                       std::memory_order_release);
+      tail_++;
+    }
+
+    uint32_t dropped = dropped_.exchange(0, std::memory_order_relaxed);
+    if (dropped > 0) {
+      OMLOG_WARNING("log buffer full, %d logs dropped.",
+                    static_cast<int>(dropped));
+    }
+  }
+
+  static void Start() {
+    auto drain_thread = [](void* arg) {
+      (void)arg;
+
+      while (1) {
+        Drain();
+        System::Thread::Sleep(LOG_DRAIN_CYCLE);
+      }
+    };
+
+    Thread* thread = new Thread;
+    thread->Create(drain_thread, static_cast<void*>(NULL), "log_drain",
+                   LOG_STACK_DEPTH, System::Thread::LOW);
+  }
+
+ private:
+  template <typename Type>
+  static void Encode(Record& record, uint8_t index, Type value) {
+    Arg& arg = record.arg[index];
+
+    if constexpr (std::is_floating_point<Type>::value) {
+      arg.f = static_cast<double>(value);
+      record.arg_type[index] = ARG_DOUBLE;
+    } else if constexpr (std::is_pointer<Type>::value) {
+      arg.p = reinterpret_cast<const void*>(value);
+      record.arg_type[index] = ARG_PTR;
+    } else if constexpr (std::is_signed<Type>::value) {
+      arg.i = static_cast<int64_t>(value);
+      record.arg_type[index] = ARG_INT;
+    } else {
+      arg.u = static_cast<uint64_t>(value);
+      record.arg_type[index] = ARG_UINT;
+    }
+  }
+
+  static int64_t GetInt(const Record& record, uint8_t index) {
+    const Arg& arg = record.arg[index];
+    switch (record.arg_type[index]) {
+      case ARG_INT:
+        return arg.i;
+      case ARG_UINT:
+        return static_cast<int64_t>(arg.u);
+      case ARG_DOUBLE:
+        return static_cast<int64_t>(arg.f);
+      default:
+        return static_cast<int64_t>(reinterpret_cast<uintptr_t>(arg.p));
+    }
+  }
+
+  static double GetDouble(const Record& record, uint8_t index) {
+    const Arg& arg = record.arg[index];
+    switch (record.arg_type[index]) {
+      case ARG_DOUBLE:
+        return arg.f;
+      case ARG_UINT:
+        return static_cast<double>(arg.u);
+      default:
+        return static_cast<double>(GetInt(record, index));
+    }
+  }
+
+  /* 按转换说明逐段格式化，不支持*宽度 */
+  static void Format(const Record& record, char* buff, size_t size) {
+    const char* fmt = record.fmt;
+    size_t len = 0;
+    uint8_t index = 0;
+
+    while (*fmt != '\0' && len + 1 < size) {
+      if (fmt[0] != '%' || fmt[1] == '%') {
+        buff[len++] = *fmt;
+        fmt += fmt[0] == '%' ? 2 : 1;
+        continue;
+      }
+
+      const char* end = fmt + 1;
+      while (*end != '\0' && strchr("diouxXcsfFeEgGaAp", *end) == NULL) {
+        end++;
+      }
+
+      char spec[16];
+      size_t spec_len = end - fmt + 1;
+      if (*end == '\0' || spec_len >= sizeof(spec) ||
+          index >= record.arg_num) {
+        break;
+      }
+
+      memcpy(spec, fmt, spec_len);
+      spec[spec_len] = '\0';
+
+      char* out = buff + len;
+      size_t remain = size - len;
+      int ans = 0;
+
+      switch (*end) {
+        case 's':
+          ans = snprintf(
+              out, remain, spec,
+              record.arg_type[index] == ARG_PTR && record.arg[index].p != NULL
+                  ? static_cast<const char*>(record.arg[index].p)
+                  : "(null)");
+          break;
+        case 'p':
+          ans = snprintf(out, remain, spec, record.arg[index].p);
+          break;
+        case 'f':
+        case 'F':
+        case 'e':
+        case 'E':
+        case 'g':
+        case 'G':
+        case 'a':
+        case 'A':
+          ans = snprintf(out, remain, spec, GetDouble(record, index));
+          break;
+        default:
+          if (strstr(spec, "ll") != NULL) {
+            ans = snprintf(out, remain, spec,
+                           static_cast<long long>(GetInt(record, index)));
+          } else if (strpbrk(spec, "lzjt") != NULL) {
+            ans = snprintf(out, remain, spec,
+                           static_cast<long>(GetInt(record, index)));
+          } else {
+            ans = snprintf(out, remain, spec,
+                           static_cast<int>(GetInt(record, index)));
+          }
+          break;
+      }
+
+      if (ans > 0) {
+        len += static_cast<size_t>(ans) < remain ? ans : remain - 1;
+      }
+
+      fmt = end + 1;
+      index++;
+    }
+
+    buff[len] = '\0';
+  }
+
+  static void Output(Level level, const char* str) {
+    switch (level) {
+      case NOTICE:
+        OMLOG_NOTICE("%s", str);
+        break;
+      case PASS:
+        OMLOG_PASS("%s", str);
+        break;
+      case WARNING:
+        OMLOG_WARNING("%s", str);
+        break;
+      case ERROR:
+        OMLOG_ERROR("%s", str);
+        break;
+      default:
+        OMLOG_DEFAULT("%s", str);
+        break;
+    }
+  }
+
+  inline static Record ring_[LOG_RING_LEN];
+  inline static std::atomic<uint32_t> head_;
+  inline static std::atomic<uint32_t> dropped_;
+  inline static uint32_t tail_; /* 只在后台线程中使用 */
+};
+}  // namespace System
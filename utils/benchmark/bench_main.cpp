@@ -0,0 +1,1005 @@
+/*
+  组件库基准测试。
+  每个测试先估算迭代次数，使单次运行约为设定时间，
+  重复多次后取中位数，结果以文本或JSON输出。
+*/
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <list.hpp>
+#include <thread>
+#include <vector>
+
+#include "bsp_time.h"
+#include "comp_actuator.hpp"
+#include "comp_ahrs.hpp"
+#include "comp_crc16.hpp"
+#include "comp_crc8.hpp"
+#include "comp_fast_math.hpp"
+#include "comp_filter.hpp"
+#include "comp_fixed.hpp"
+#include "comp_mixer.hpp"
+#include "comp_pid.hpp"
+#include "comp_trans.hpp"
+#include "comp_triangle.hpp"
+#include "comp_type.hpp"
+#include "comp_utils.hpp"
+
+#define BENCHMARK_REPEAT (5)        /* 每个测试的重复次数 */
+#define BENCHMARK_TIME_DEFAULT (50) /* 单次运行的默认时间(ms) */
+#define BENCHMARK_INPUT_NUM (256)   /* 输入样本数，必须为2的幂 */
+#define BENCHMARK_CRC_LEN (64)      /* CRC测试的数据长度 */
+
+using namespace Component;
+
+typedef struct {
+  const char* name;
+  uint32_t bytes; /* 每次操作处理的字节数，0表示不统计吞吐量 */
+  std::function<void(uint64_t)> run; /* 运行指定次数 */
+} Kernel;
+
+typedef struct {
+  const char* name;
+  uint64_t iterations;
+  double ns_per_op;
+  double ops_per_sec;
+  double bytes_per_sec;
+} Result;
+
+/* 防止结果被编译器优化掉 */
+static volatile float sink_f;
+static volatile uint32_t sink_u;
+
+static std::array<float, BENCHMARK_INPUT_NUM> input;
+static std::array<Q31, BENCHMARK_INPUT_NUM> input_q31;
+static std::array<Q15, BENCHMARK_INPUT_NUM> input_q15;
+static std::array<uint8_t, BENCHMARK_CRC_LEN + 2> crc_buff;
+
+static void init_input() {
+  uint32_t seed = 0x12345678;
+  for (auto& value : input) {
+    seed = seed * 1664525u + 1013904223u;
+    value = static_cast<float>(seed >> 8) / static_cast<float>(1 << 24) * 2.0f -
+            1.0f;
+  }
+
+  for (size_t i = 0; i < BENCHMARK_INPUT_NUM; i++) {
+    input_q31[i] = Q31::FromFloat(input[i]);
+    input_q15[i] = Q15::FromFloat(input[i]);
+  }
+
+  for (auto& byte : crc_buff) {
+    seed = seed * 1664525u + 1013904223u;
+    byte = static_cast<uint8_t>(seed >> 24);
+  }
+}
+
+static float in(uint64_t i) { return input[i & (BENCHMARK_INPUT_NUM - 1)]; }
+
+static Q31 in_q31(uint64_t i) {
+  return input_q31[i & (BENCHMARK_INPUT_NUM - 1)];
+}
+
+static Q15 in_q15(uint64_t i) {
+  return input_q15[i & (BENCHMARK_INPUT_NUM - 1)];
+}
+
+static std::vector<Kernel> create_kernels() {
+  std::vector<Kernel> kernels;
+
+  kernels.push_back({"pid_calculate", 0, [](uint64_t n) {
+                       PID::Param param = {1.0f, 2.0f, 0.5f, 0.01f,
+                                           1.0f, 10.0f, 0.0f, false};
+                       PID pid(param, 1000.0f);
+                       float out = 0.0f;
+                       for (uint64_t i = 0; i < n; i++) {
+                         out += pid.Calculate(in(i), in(i + 1), 0.001f);
+                       }
+                       sink_f = out;
+                     }});
+
+  kernels.push_back({"pid_calculate_dfilter", 0, [](uint64_t n) {
+                       PID::Param param = {1.0f, 2.0f, 0.5f, 0.01f,
+                                           1.0f, 10.0f, 100.0f, false};
+                       PID pid(param, 1000.0f);
+                       float out = 0.0f;
+                       for (uint64_t i = 0; i < n; i++) {
+                         out += pid.Calculate(in(i), in(i + 1), 0.001f);
+                       }
+                       sink_f = out;
+                     }});
+
+  kernels.push_back({"pid_calculate_cycle", 0, [](uint64_t n) {
+                       PID::Param param = {1.0f, 2.0f, 0.5f, 0.01f,
+                                           1.0f, 10.0f, 0.0f, true};
+                       PID pid(param, 1000.0f);
+                       float out = 0.0f;
+                       for (uint64_t i = 0; i < n; i++) {
+                         out += pid.Calculate(in(i) * 3.0f, in(i + 1) * 3.0f,
+                                              0.001f);
+                       }
+                       sink_f = out;
+                     }});
+
+  kernels.push_back({"pid_calculate_fb_dot", 0, [](uint64_t n) {
+                       PID::Param param = {1.0f, 2.0f, 0.5f, 0.01f,
+                                           1.0f, 10.0f, 0.0f, false};
+                       PID pid(param, 1000.0f);
+                       float out = 0.0f;
+                       for (uint64_t i = 0; i < n; i++) {
+                         out += pid.Calculate(in(i), in(i + 1), in(i + 2),
+                                              0.001f);
+                       }
+                       sink_f = out;
+                     }});
+
+  /* 定点版本，与pid_calculate_dfilter参数相同 */
+  kernels.push_back({"pid_calculate_q31", 0, [](uint64_t n) {
+                       PID::Param param = {1.0f, 2.0f, 0.5f, 0.01f,
+                                           1.0f, 10.0f, 100.0f, false};
+                       PIDFixed<Q31> pid(param, 1000.0f);
+                       int32_t out = 0;
+                       for (uint64_t i = 0; i < n; i++) {
+                         out += pid.Calculate(in_q31(i), in_q31(i + 1)).raw_;
+                       }
+                       sink_u = static_cast<uint32_t>(out);
+                     }});
+
+  kernels.push_back({"pid_calculate_q15", 0, [](uint64_t n) {
+                       PID::Param param = {1.0f, 2.0f, 0.5f, 0.01f,
+                                           1.0f, 10.0f, 100.0f, false};
+                       PIDFixed<Q15> pid(param, 1000.0f);
+                       int32_t out = 0;
+                       for (uint64_t i = 0; i < n; i++) {
+                         out += pid.Calculate(in_q15(i), in_q15(i + 1)).raw_;
+                       }
+                       sink_u = static_cast<uint32_t>(out);
+                     }});
+
+  kernels.push_back({"low_pass_filter", 0, [](uint64_t n) {
+                       LowPassFilter filter(30.0f);
+                       float out = 0.0f;
+                       for (uint64_t i = 0; i < n; i++) {
+                         out += filter.Apply(in(i), 0.001f);
+                       }
+                       sink_f = out;
+                     }});
+
+  kernels.push_back({"low_pass_filter_2p", 0, [](uint64_t n) {
+                       LowPassFilter2p filter(1000.0f, 30.0f);
+                       float out = 0.0f;
+                       for (uint64_t i = 0; i < n; i++) {
+                         out += filter.Apply(in(i));
+                       }
+                       sink_f = out;
+                     }});
+
+  kernels.push_back({"low_pass_filter_2p_q31", 0, [](uint64_t n) {
+                       LowPassFilter2pFixed<Q31> filter(1000.0f, 30.0f);
+                       int32_t out = 0;
+                       for (uint64_t i = 0; i < n; i++) {
+                         out += filter.Apply(in_q31(i)).raw_;
+                       }
+                       sink_u = static_cast<uint32_t>(out);
+                     }});
+
+  kernels.push_back({"low_pass_filter_2p_q15", 0, [](uint64_t n) {
+                       LowPassFilter2pFixed<Q15> filter(1000.0f, 30.0f);
+                       int32_t out = 0;
+                       for (uint64_t i = 0; i < n; i++) {
+                         out += filter.Apply(in_q15(i)).raw_;
+                       }
+                       sink_u = static_cast<uint32_t>(out);
+                     }});
+
+  /* 四路同时计算，分别使用四个独立对象和批量对象，对比批量计算的加速比 */
+  kernels.push_back({"low_pass_filter_2p_x4", 0, [](uint64_t n) {
+                       std::array<LowPassFilter2p, 4> filter = {
+                           LowPassFilter2p(1000.0f, 30.0f),
+                           LowPassFilter2p(1000.0f, 40.0f),
+                           LowPassFilter2p(1000.0f, 50.0f),
+                           LowPassFilter2p(1000.0f, 60.0f)};
+                       float out = 0.0f;
+                       for (uint64_t i = 0; i < n; i++) {
+                         for (size_t j = 0; j < 4; j++) {
+                           out += filter[j].Apply(in(i + j));
+                         }
+                       }
+                       sink_f = out;
+                     }});
+
+  kernels.push_back({"low_pass_filter_2p_bank4", 0, [](uint64_t n) {
+                       LowPassFilter2pBank<4> filter(
+                           1000.0f, {30.0f, 40.0f, 50.0f, 60.0f});
+                       std::array<float, 4> sample, res;
+                       float out = 0.0f;
+                       for (uint64_t i = 0; i < n; i++) {
+                         for (size_t j = 0; j < 4; j++) {
+                           sample[j] = in(i + j);
+                         }
+                         filter.Apply(sample, res);
+                         out += res[0] + res[1] + res[2] + res[3];
+                       }
+                       sink_f = out;
+                     }});
+
+  kernels.push_back({"pid_calculate_x4", 0, [](uint64_t n) {
+                       PID::Param param = {1.0f, 2.0f, 0.5f, 0.01f,
+                                           1.0f, 10.0f, 100.0f, false};
+                       std::array<PID, 4> pid = {
+                           PID(param, 1000.0f), PID(param, 1000.0f),
+                           PID(param, 1000.0f), PID(param, 1000.0f)};
+                       float out = 0.0f;
+                       for (uint64_t i = 0; i < n; i++) {
+                         for (size_t j = 0; j < 4; j++) {
+                           out += pid[j].Calculate(in(i + j), in(i + j + 4),
+                                                   0.001f);
+                         }
+                       }
+                       sink_f = out;
+                     }});
+
+  kernels.push_back({"pid_bank4", 0, [](uint64_t n) {
+                       PID::Param param = {1.0f, 2.0f, 0.5f, 0.01f,
+                                           1.0f, 10.0f, 100.0f, false};
+                       PIDBank<4> pid({param, param, param, param}, 1000.0f);
+                       std::array<float, 4> sp, fb, res;
+                       float out = 0.0f;
+                       for (uint64_t i = 0; i < n; i++) {
+                         for (size_t j = 0; j < 4; j++) {
+                           sp[j] = in(i + j);
+                           fb[j] = in(i + j + 4);
+                         }
+                         pid.Calculate(sp, fb, 0.001f, res);
+                         out += res[0] + res[1] + res[2] + res[3];
+                       }
+                       sink_f = out;
+                     }});
+
+  kernels.push_back({"speed_actuator_x4", 0, [](uint64_t n) {
+                       SpeedActuator::Param param = {
+                           {1.0f, 2.0f, 0.5f, 0.01f, 1.0f, 10.0f, 100.0f,
+                            false},
+                           200.0f,
+                           200.0f};
+                       std::array<SpeedActuator, 4> actr = {
+                           SpeedActuator(param, 1000.0f),
+                           SpeedActuator(param, 1000.0f),
+                           SpeedActuator(param, 1000.0f),
+                           SpeedActuator(param, 1000.0f)};
+                       float out = 0.0f;
+                       for (uint64_t i = 0; i < n; i++) {
+                         for (size_t j = 0; j < 4; j++) {
+                           out += actr[j].Calculate(in(i + j), in(i + j + 4),
+                                                    0.001f);
+                         }
+                       }
+                       sink_f = out;
+                     }});
+
+  kernels.push_back({"speed_actuator_bank4", 0, [](uint64_t n) {
+                       SpeedActuator::Param param = {
+                           {1.0f, 2.0f, 0.5f, 0.01f, 1.0f, 10.0f, 100.0f,
+                            false},
+                           200.0f,
+                           200.0f};
+                       std::array<SpeedActuator::Param, 4> params = {
+                           param, param, param, param};
+                       SpeedActuatorBank<4> actr(params, 1000.0f);
+                       std::array<float, 4> sp, fb, res;
+                       float out = 0.0f;
+                       for (uint64_t i = 0; i < n; i++) {
+                         for (size_t j = 0; j < 4; j++) {
+                           sp[j] = in(i + j);
+                           fb[j] = in(i + j + 4);
+                         }
+                         actr.Calculate(sp, fb, 0.001f, res);
+                         out += res[0] + res[1] + res[2] + res[3];
+                       }
+                       sink_f = out;
+                     }});
+
+  kernels.push_back({"mixer_mecanum", 0, [](uint64_t n) {
+                       Mixer mixer(Mixer::MECANUM);
+                       std::array<float, 4> out = {};
+                       float sum = 0.0f;
+                       for (uint64_t i = 0; i < n; i++) {
+                         Type::MoveVector move = {in(i), in(i + 1), in(i + 2)};
+                         mixer.Apply(move, out.data());
+                         sum += out[0];
+                       }
+                       sink_f = sum;
+                     }});
+
+  kernels.push_back({"mixer_omnicross", 0, [](uint64_t n) {
+                       Mixer mixer(Mixer::OMNICROSS);
+                       std::array<float, 4> out = {};
+                       float sum = 0.0f;
+                       for (uint64_t i = 0; i < n; i++) {
+                         Type::MoveVector move = {in(i), in(i + 1), in(i + 2)};
+                         mixer.Apply(move, out.data());
+                         sum += out[0];
+                       }
+                       sink_f = sum;
+                     }});
+
+  kernels.push_back({"cycle_value_add", 0, [](uint64_t n) {
+                       float sum = 0.0f;
+                       for (uint64_t i = 0; i < n; i++) {
+                         Type::CycleValue value(in(i) * 10.0f);
+                         value += in(i + 1) * 10.0f;
+                         sum += static_cast<float>(value);
+                       }
+                       sink_f = sum;
+                     }});
+
+  kernels.push_back({"cycle_value_sub", 0, [](uint64_t n) {
+                       float sum = 0.0f;
+                       for (uint64_t i = 0; i < n; i++) {
+                         Type::CycleValue value(in(i) * 10.0f);
+                         sum += value - in(i + 1) * 10.0f;
+                       }
+                       sink_f = sum;
+                     }});
+
+  /* 电机编码器解码、反装取反和相邻两次的角度差 */
+  kernels.push_back({"encoder_cycle_value", 0, [](uint64_t n) {
+                       float last = 0.0f, sum = 0.0f;
+                       for (uint64_t i = 0; i < n; i++) {
+                         uint16_t raw = static_cast<uint16_t>(i * 37 & 8191);
+                         Type::CycleValue angle(static_cast<float>(raw) /
+                                                8192 * M_2PI);
+                         Type::CycleValue now = -angle;
+                         sum += now - last;
+                         last = now;
+                       }
+                       sink_f = sum;
+                     }});
+
+  kernels.push_back({"encoder_binary_angle", 0, [](uint64_t n) {
+                       Type::BinaryAngle last;
+                       float sum = 0.0f;
+                       for (uint64_t i = 0; i < n; i++) {
+                         uint16_t raw = static_cast<uint16_t>(i * 37 & 8191);
+                         Type::BinaryAngle now =
+                             -Type::BinaryAngle::FromFraction(raw, 8192);
+                         sum += (now - last).SignedRadian();
+                         last = now;
+                       }
+                       sink_f = sum;
+                     }});
+
+  kernels.push_back({"triangle_solve", 0, [](uint64_t n) {
+                       Triangle triangle;
+                       float sum = 0.0f;
+                       for (uint64_t i = 0; i < n; i++) {
+                         triangle.Reset();
+                         triangle.data_.side[0] = 3.0f + in(i);
+                         triangle.data_.side[1] = 4.0f + in(i + 1);
+                         triangle.data_.side[2] = 5.0f + in(i + 2);
+                         triangle.Slove();
+                         sum += triangle.data_.angle[0];
+                       }
+                       sink_f = sum;
+                     }});
+
+  kernels.push_back({"trans_eulr_pos", 0, [](uint64_t n) {
+                       float sum = 0.0f;
+                       for (uint64_t i = 0; i < n; i++) {
+                         Trans::Angle eulr = {in(i), in(i + 1), in(i + 2)};
+                         Type::Vector3 pos = {1.0f, in(i + 3), 0.5f};
+                         Trans::EulrPosTrans(eulr, pos);
+                         sum += pos.x;
+                       }
+                       sink_f = sum;
+                     }});
+
+  kernels.push_back({"madgwick_update", 0, [](uint64_t n) {
+                       Type::Quaternion quat = {1.0f, 0.0f, 0.0f, 0.0f};
+                       for (uint64_t i = 0; i < n; i++) {
+                         Type::Vector3 accl = {in(i) * 0.1f, in(i + 1) * 0.1f,
+                                               9.8f};
+                         Type::Vector3 gyro = {in(i + 2), in(i + 3),
+                                               in(i + 4)};
+                         Madgwick::Update(quat, accl, gyro, 0.001f);
+                       }
+                       sink_f = quat.q0;
+                     }});
+
+  kernels.push_back({"inv_sqrtf", 0, [](uint64_t n) {
+                       float sum = 0.0f;
+                       for (uint64_t i = 0; i < n; i++) {
+                         sum += inv_sqrtf(in(i) + 2.0f);
+                       }
+                       sink_f = sum;
+                     }});
+
+  /* libm与FastMath::Approx对比 */
+  kernels.push_back({"libm_sincos", 0, [](uint64_t n) {
+                       float sum = 0.0f;
+                       for (uint64_t i = 0; i < n; i++) {
+                         float x = in(i) * 8.0f;
+                         sum += sinf(x) + cosf(x);
+                       }
+                       sink_f = sum;
+                     }});
+
+  kernels.push_back({"fast_sincos", 0, [](uint64_t n) {
+                       float sum = 0.0f;
+                       for (uint64_t i = 0; i < n; i++) {
+                         float s = 0.0f, c = 0.0f;
+                         FastMath::Approx::SinCos(in(i) * 8.0f, &s, &c);
+                         sum += s + c;
+                       }
+                       sink_f = sum;
+                     }});
+
+  kernels.push_back({"libm_atan2", 0, [](uint64_t n) {
+                       float sum = 0.0f;
+                       for (uint64_t i = 0; i < n; i++) {
+                         sum += atan2f(in(i), in(i + 1));
+                       }
+                       sink_f = sum;
+                     }});
+
+  kernels.push_back({"fast_atan2", 0, [](uint64_t n) {
+                       float sum = 0.0f;
+                       for (uint64_t i = 0; i < n; i++) {
+                         sum += FastMath::Approx::Atan2(in(i), in(i + 1));
+                       }
+                       sink_f = sum;
+                     }});
+
+  kernels.push_back({"libm_asin", 0, [](uint64_t n) {
+                       float sum = 0.0f;
+                       for (uint64_t i = 0; i < n; i++) {
+                         sum += asinf(in(i));
+                       }
+                       sink_f = sum;
+                     }});
+
+  kernels.push_back({"fast_asin", 0, [](uint64_t n) {
+                       float sum = 0.0f;
+                       for (uint64_t i = 0; i < n; i++) {
+                         sum += FastMath::Approx::Asin(in(i));
+                       }
+                       sink_f = sum;
+                     }});
+
+  kernels.push_back({"libm_sqrt", 0, [](uint64_t n) {
+                       float sum = 0.0f;
+                       for (uint64_t i = 0; i < n; i++) {
+                         sum += sqrtf(in(i) + 2.0f);
+                       }
+                       sink_f = sum;
+                     }});
+
+  kernels.push_back({"fast_sqrt", 0, [](uint64_t n) {
+                       float sum = 0.0f;
+                       for (uint64_t i = 0; i < n; i++) {
+                         sum += FastMath::Approx::Sqrt(in(i) + 2.0f);
+                       }
+                       sink_f = sum;
+                     }});
+
+  kernels.push_back({"fast_inv_sqrt", 0, [](uint64_t n) {
+                       float sum = 0.0f;
+                       for (uint64_t i = 0; i < n; i++) {
+                         sum += FastMath::Approx::InvSqrt(in(i) + 2.0f);
+                       }
+                       sink_f = sum;
+                     }});
+
+  kernels.push_back({"crc8_calculate", BENCHMARK_CRC_LEN, [](uint64_t n) {
+                       uint32_t sum = 0;
+                       for (uint64_t i = 0; i < n; i++) {
+                         sum += CRC8::Calculate(crc_buff.data(),
+                                                BENCHMARK_CRC_LEN,
+                                                static_cast<uint8_t>(i));
+                       }
+                       sink_u = sum;
+                     }});
+
+  kernels.push_back({"crc16_calculate", BENCHMARK_CRC_LEN, [](uint64_t n) {
+                       uint32_t sum = 0;
+                       for (uint64_t i = 0; i < n; i++) {
+                         sum += CRC16::Calculate(crc_buff.data(),
+                                                 BENCHMARK_CRC_LEN,
+                                                 static_cast<uint16_t>(i));
+                       }
+                       sink_u = sum;
+                     }});
+
+  return kernels;
+}
+
+static double run_once(const Kernel& kernel, uint64_t n) {
+  uint64_t start = bsp_time_get_ns();
+  kernel.run(n);
+  return static_cast<double>(bsp_time_get_ns() - start);
+}
+
+static Result measure(const Kernel& kernel, uint32_t time_ms) {
+  const double TARGET = static_cast<double>(time_ms) * 1e6;
+
+  /* 迭代次数翻倍，直到运行时间足够估算速度 */
+  uint64_t n = 16;
+  double elapsed = run_once(kernel, n);
+  while (elapsed < TARGET / 10.0 && n < (1ULL << 40)) {
+    n *= 2;
+    elapsed = run_once(kernel, n);
+  }
+
+  n = std::max<uint64_t>(
+      1, static_cast<uint64_t>(static_cast<double>(n) * TARGET / elapsed));
+
+  std::array<double, BENCHMARK_REPEAT> samples;
+  for (auto& sample : samples) {
+    sample = run_once(kernel, n) / static_cast<double>(n);
+  }
+  std::sort(samples.begin(), samples.end());
+
+  Result result;
+  result.name = kernel.name;
+  result.iterations = n;
+  result.ns_per_op = samples[BENCHMARK_REPEAT / 2];
+  result.ops_per_sec = 1e9 / result.ns_per_op;
+  result.bytes_per_sec = result.ops_per_sec * kernel.bytes;
+
+  return result;
+}
+
+static void print_text(const std::vector<Result>& results) {
+  printf("%-24s%12s%16s%12s\n", "kernel", "ns/op", "op/s", "MB/s");
+  for (const auto& result : results) {
+    printf("%-24s%12.2f%16.0f", result.name, result.ns_per_op,
+           result.ops_per_sec);
+    if (result.bytes_per_sec > 0.0) {
+      printf("%12.2f", result.bytes_per_sec / 1e6);
+    }
+    printf("\n");
+  }
+}
+
+static void print_json(const std::vector<Result>& results, uint32_t time_ms) {
+  printf("{\n");
+  printf("  \"compiler\": \"%s\",\n", __VERSION__);
+  printf("  \"time_ms\": %u,\n", time_ms);
+  printf("  \"repeat\": %d,\n", BENCHMARK_REPEAT);
+  printf("  \"results\": [\n");
+  for (size_t i = 0; i < results.size(); i++) {
+    const Result& result = results[i];
+    printf(
+        "    {\"name\": \"%s\", \"iterations\": %llu, \"ns_per_op\": %.3f, "
+        "\"ops_per_sec\": %.1f, \"bytes_per_sec\": %.1f}%s\n",
+        result.name, static_cast<unsigned long long>(result.iterations),
+        result.ns_per_op, result.ops_per_sec, result.bytes_per_sec,
+        i + 1 < results.size() ? "," : "");
+  }
+  printf("  ]\n");
+  printf("}\n");
+}
+
+/* 在定义域上扫描FastMath::Approx，与双精度libm比较，输出最大误差 */
+static void print_accuracy() {
+  const int NUM = 2000000;
+  double err = 0.0, libm_err = 0.0;
+
+  printf("%-12s %-24s %14s %14s\n", "function", "domain", "fast", "libm");
+
+  for (int i = 0; i <= NUM; i++) {
+    float x = static_cast<float>(-1e4 + 2e4 * i / NUM);
+    double ref_s = sin(static_cast<double>(x));
+    double ref_c = cos(static_cast<double>(x));
+    float s = 0.0f, c = 0.0f;
+    FastMath::Approx::SinCos(x, &s, &c);
+    err = std::max(err, std::max(fabs(s - ref_s), fabs(c - ref_c)));
+    libm_err = std::max(libm_err, std::max(fabs(sinf(x) - ref_s),
+                                           fabs(cosf(x) - ref_c)));
+  }
+  printf("%-12s %-24s %14.3e %14.3e\n", "sincos", "|x|<=1e4, abs", err,
+         libm_err);
+
+  err = libm_err = 0.0;
+  for (int i = 0; i <= NUM; i++) {
+    double angle = -M_PI + 2.0 * M_PI * i / NUM;
+    float r = static_cast<float>(0.01 + 100.0 * (i % 1000) / 1000.0);
+    float y = static_cast<float>(r * sin(angle));
+    float x = static_cast<float>(r * cos(angle));
+    double ref = atan2(static_cast<double>(y), static_cast<double>(x));
+    err = std::max(err, fabs(FastMath::Approx::Atan2(y, x) - ref));
+    libm_err = std::max(libm_err, fabs(atan2f(y, x) - ref));
+  }
+  printf("%-12s %-24s %14.3e %14.3e\n", "atan2", "all quadrants, abs", err,
+         libm_err);
+
+  err = libm_err = 0.0;
+  for (int i = 0; i <= NUM; i++) {
+    float x = static_cast<float>(-1.0 + 2.0 * i / NUM);
+    double ref = asin(static_cast<double>(x));
+    err = std::max(err, fabs(FastMath::Approx::Asin(x) - ref));
+    libm_err = std::max(libm_err, fabs(asinf(x) - ref));
+  }
+  printf("%-12s %-24s %14.3e %14.3e\n", "asin", "[-1, 1], abs", err,
+         libm_err);
+
+  double inv_err = 0.0;
+  err = libm_err = 0.0;
+  for (int i = 0; i <= NUM; i++) {
+    float x = static_cast<float>(pow(10.0, -6.0 + 12.0 * i / NUM));
+    double ref = sqrt(static_cast<double>(x));
+    err = std::max(err, fabs(FastMath::Approx::Sqrt(x) - ref) / ref);
+    inv_err = std::max(inv_err,
+                       fabs(FastMath::Approx::InvSqrt(x) * ref - 1.0));
+    libm_err = std::max(libm_err, fabs(sqrtf(x) - ref) / ref);
+  }
+  printf("%-12s %-24s %14.3e %14.3e\n", "sqrt", "[1e-6, 1e6], rel", err,
+         libm_err);
+  printf("%-12s %-24s %14.3e %14s\n", "inv_sqrt", "[1e-6, 1e6], rel",
+         inv_err, "-");
+}
+
+/* 定点组件的一致性检查，与float版本逐步比较最大误差 */
+typedef struct {
+  double err;
+  double tol;
+} Conformance;
+
+static int report(const char* name, const char* format, Conformance c) {
+  const bool PASS = c.err <= c.tol;
+  printf("%-24s %-6s %14.3e %14.3e %s\n", name, format, c.err, c.tol,
+         PASS ? "PASS" : "FAIL");
+  return PASS ? 0 : 1;
+}
+
+/* 定点的输出饱和在[-1, 1)，float版本的参考值同样截断 */
+static double clip(double x) { return std::min(std::max(x, -1.0), 1.0); }
+
+/* 阶跃保持一段时间的随机信号，幅值为scale */
+static float step_signal(uint64_t i, float scale) {
+  return in(i / 97 * 7) * scale;
+}
+
+template <typename T>
+static Conformance conformance_filter(float cutoff, double tol) {
+  LowPassFilter2p ref(1000.0f, cutoff);
+  LowPassFilter2pFixed<T> filter(1000.0f, cutoff);
+  double err = 0.0;
+
+  for (uint64_t i = 0; i < 20000; i++) {
+    const float X = T::FromFloat(step_signal(i, 0.9f)).ToFloat();
+    const double OUT = filter.Apply(T::FromFloat(X)).ToFloat();
+    err = std::max(err, fabs(OUT - clip(ref.Apply(X))));
+  }
+
+  const double OUT = filter.Reset(T::FromFloat(0.5f)).ToFloat();
+  err = std::max(err, fabs(OUT - clip(ref.Reset(0.5f))));
+
+  return {err, tol};
+}
+
+/* 循环角度的PID输入为弧度，定点以pi为单位，k相应缩小pi倍 */
+template <typename T>
+static Conformance conformance_pid(PID::Param param, double tol) {
+  const float FREQ = 1000.0f;
+  const float SCALE = param.cycle ? static_cast<float>(M_PI) : 1.0f;
+
+  PIDFixed<T> pid(param, FREQ);
+  param.k /= SCALE;
+  PID ref(param, FREQ);
+  double err = 0.0;
+
+  for (uint64_t i = 0; i < 20000; i++) {
+    const float SP = step_signal(i, 0.8f);
+    const float FB =
+        0.6f * sinf(static_cast<float>(i) * 0.005f) + in(i) * 0.01f;
+    const T SP_Q = T::FromFloat(SP), FB_Q = T::FromFloat(FB);
+
+    const double OUT = pid.Calculate(SP_Q, FB_Q).ToFloat();
+    const double REF = ref.Calculate(SP_Q.ToFloat() * SCALE,
+                                     FB_Q.ToFloat() * SCALE, 1.0f / FREQ);
+    err = std::max(err, fabs(OUT - clip(REF)));
+  }
+
+  return {err, tol};
+}
+
+template <typename T>
+static Conformance conformance_cycle(double tol) {
+  double err = 0.0;
+
+  for (uint64_t i = 0; i < 20000; i++) {
+    const float A = in(i) * 20.0f, B = in(i + 1) * 20.0f;
+    const auto A_Q = CycleValueFixed<T>::FromFloat(A);
+    const auto B_Q = CycleValueFixed<T>::FromFloat(B);
+
+    /* 相减得到[-pi, pi) */
+    Type::CycleValue a(A);
+    const double DIFF = (A_Q - B_Q).ToFloat() * M_PI;
+    err = std::max(err, fabs(DIFF - (a - B)));
+
+    /* 加上以pi为单位的角度，比较时消除0和2pi的差别 */
+    const float D = in(i + 2) * 0.5f;
+    Type::CycleValue sum = a + D * static_cast<float>(M_PI);
+    const float OUT = (A_Q + T::FromFloat(D)).ToFloat();
+    const float WRAP = Type::CycleValue(OUT) - sum.Value();
+    err = std::max(err, fabs(static_cast<double>(WRAP)));
+  }
+
+  return {err, tol};
+}
+
+/* BinaryAngle与CycleValue的换算和相减 */
+static Conformance conformance_binary_angle(double tol) {
+  double err = 0.0;
+
+  for (uint64_t i = 0; i < 20000; i++) {
+    const float A = in(i) * 20.0f, B = in(i + 1) * 20.0f;
+    const auto A_B = Type::BinaryAngle::FromRadian(A);
+    const auto B_B = Type::BinaryAngle::FromRadian(B);
+
+    Type::CycleValue a(A);
+    float wrap = Type::CycleValue(A_B) - a;
+    err = std::max(err, fabs(static_cast<double>(wrap)));
+
+    const double DIFF = (A_B - B_B).SignedRadian();
+    err = std::max(err, fabs(DIFF - (a - B)));
+
+    const uint16_t RAW = static_cast<uint16_t>(i & 8191);
+    Type::CycleValue enc(static_cast<float>(RAW) / 8192 * M_2PI);
+    wrap = Type::CycleValue(Type::BinaryAngle::FromFraction(RAW, 8192)) - enc;
+    err = std::max(err, fabs(static_cast<double>(wrap)));
+  }
+
+  return {err, tol};
+}
+
+template <typename T>
+static Conformance conformance_mixer(Mixer::Mode mode, double tol) {
+  Mixer mixer(mode);
+  double err = 0.0;
+
+  for (uint64_t i = 0; i < 20000; i++) {
+    const T VX = T::FromFloat(in(i)), VY = T::FromFloat(in(i + 1));
+    const T WZ = T::FromFloat(in(i + 2));
+    Type::MoveVector move_vec = {VX.ToFloat(), VY.ToFloat(), WZ.ToFloat()};
+
+    float ref[4] = {};
+    T out[4];
+    mixer.Apply(move_vec, ref);
+    mixer.Apply(VX, VY, WZ, out);
+
+    for (size_t j = 0; j < mixer.len_; j++) {
+      err = std::max(err, fabs(out[j].ToFloat() - clip(ref[j])));
+    }
+  }
+
+  return {err, tol};
+}
+
+/* 读者持续遍历时增删节点，节点池必须持续回收，
+   读者也不能看到被重新分配的节点。误差为失败次数 */
+typedef struct {
+  uint32_t key;
+  uint32_t check[7];
+} ListItem;
+
+/* 两个读者交替进入，后一个进入后前一个才退出，任意时刻都有读者在遍历 */
+typedef struct {
+  bool entered;
+  std::atomic<uint32_t>* turn;
+  std::atomic<uint32_t>* torn;
+  const std::atomic<bool>* running;
+} ListReader;
+
+static bool list_check(ListItem& item, void* arg) {
+  ListReader* reader = static_cast<ListReader*>(arg);
+
+  for (uint32_t check : item.check) {
+    if (check != ~item.key) {
+      reader->torn->fetch_add(1);
+    }
+  }
+
+  if (!reader->entered) {
+    reader->entered = true;
+    const uint32_t TURN = reader->turn->fetch_add(1) + 1;
+    while (reader->turn->load() == TURN && reader->running->load()) {
+      std::this_thread::yield();
+    }
+  }
+
+  return true;
+}
+
+static bool list_match(ListItem& item, void* arg) {
+  return item.key == *static_cast<uint32_t*>(arg);
+}
+
+static Conformance conformance_list(double tol) {
+  const uint32_t POOL = 8, LIVE = 4, ROUND = 20000;
+  const auto STALL = std::chrono::seconds(1);
+
+  System::List<ListItem> list(POOL);
+  std::atomic<bool> running(true);
+  std::atomic<uint32_t> turn(0), torn(0);
+  uint32_t fail = 0;
+
+  for (uint32_t i = 0; i < LIVE; i++) {
+    ListItem item;
+    item.key = i;
+    std::fill(std::begin(item.check), std::end(item.check), ~i);
+    list.Add(item);
+  }
+
+  std::vector<std::thread> readers;
+  for (uint32_t i = 0; i < 2; i++) {
+    readers.emplace_back([&, i]() {
+      ListReader reader = {false, &turn, &torn, &running};
+      while (running.load()) {
+        if (turn.load() % 2 != i) {
+          std::this_thread::yield();
+          continue;
+        }
+        reader.entered = false;
+        list.Foreach(list_check, &reader);
+      }
+    });
+  }
+
+  for (uint32_t i = LIVE; i < ROUND && fail == 0; i++) {
+    ListItem item;
+    item.key = i;
+    std::fill(std::begin(item.check), std::end(item.check), ~i);
+
+    /* 节点池暂时耗尽时等待读者换代，超时说明节点无法回收 */
+    const auto START = std::chrono::steady_clock::now();
+    while (!list.Add(item)) {
+      if (std::chrono::steady_clock::now() - START > STALL) {
+        fail++;
+        break;
+      }
+      std::this_thread::yield();
+    }
+
+    uint32_t key = i - LIVE;
+    if (!list.Remove(list_match, &key)) {
+      fail++;
+    }
+  }
+
+  running.store(false);
+  for (auto& reader : readers) {
+    reader.join();
+  }
+
+  return {static_cast<double>(fail + torn.load()), tol};
+}
+
+static int run_conformance() {
+  int fail = 0;
+
+  printf("%-24s %-6s %14s %14s\n", "component", "format", "max_err",
+         "tolerance");
+
+  const float CUTOFF[] = {0.0f, 5.0f, 30.0f, 200.0f};
+  const char* CUTOFF_NAME[] = {"lpf2p_bypass", "lpf2p_5hz", "lpf2p_30hz",
+                               "lpf2p_200hz"};
+  /* 两者的系数都只有24位有效数字，截止频率越低极点越敏感，误差越大 */
+  const double CUTOFF_TOL[] = {1e-6, 2e-4, 1e-5, 1e-5};
+  for (size_t i = 0; i < 4; i++) {
+    fail += report(CUTOFF_NAME[i], "q31",
+                   conformance_filter<Q31>(CUTOFF[i], CUTOFF_TOL[i]));
+    fail += report(CUTOFF_NAME[i], "q15",
+                   conformance_filter<Q15>(CUTOFF[i], CUTOFF_TOL[i] + 2e-4));
+  }
+
+  /* k, p, i, d, i_limit, out_limit, d_cutoff_freq, cycle */
+  const PID::Param PARAM[] = {
+      {1.0f, 0.8f, 2.0f, 0.002f, 0.3f, 1.0f, 50.0f, false},
+      {0.5f, 3.0f, 10.0f, 0.0f, 0.05f, 0.4f, 0.0f, false},
+      {2.0f, 1.0f, 0.0f, 0.001f, 0.0f, 0.0f, 100.0f, false},
+      {1.0f, 0.8f, 2.0f, 0.002f, 0.3f, 1.0f, 50.0f, true},
+  };
+  const char* PARAM_NAME[] = {"pid", "pid_limit", "pid_pd_saturate",
+                              "pid_cycle"};
+  for (size_t i = 0; i < 4; i++) {
+    fail += report(PARAM_NAME[i], "q31",
+                   conformance_pid<Q31>(PARAM[i], 1e-4));
+    fail += report(PARAM_NAME[i], "q15",
+                   conformance_pid<Q15>(PARAM[i], 2e-3));
+  }
+
+  fail += report("cycle_value", "q31", conformance_cycle<Q31>(1e-5));
+  fail += report("cycle_value", "q15", conformance_cycle<Q15>(2e-4));
+
+  fail += report("binary_angle", "u32", conformance_binary_angle(5e-6));
+
+  const Mixer::Mode MODE[] = {Mixer::MECANUM, Mixer::PARLFIX4,
+                              Mixer::PARLFIX2, Mixer::SINGLE};
+  const char* MODE_NAME[] = {"mixer_mecanum", "mixer_parlfix4",
+                             "mixer_parlfix2", "mixer_single"};
+  for (size_t i = 0; i < 4; i++) {
+    fail += report(MODE_NAME[i], "q31", conformance_mixer<Q31>(MODE[i], 1e-6));
+    fail += report(MODE_NAME[i], "q15", conformance_mixer<Q15>(MODE[i], 1e-4));
+  }
+
+  fail += report("list_remove_iterate", "-", conformance_list(0.0));
+
+  return fail;
+}
+
+static void usage(const char* name) {
+  printf(
+      "Usage: %s [--json] [--filter name] [--time ms] [--list] "
+      "[--accuracy] [--conformance]\n",
+      name);
+}
+
+int main(int argc, char** argv) {
+  bool json = false, list = false, accuracy = false, conformance = false;
+  const char* filter = NULL;
+  uint32_t time_ms = BENCHMARK_TIME_DEFAULT;
+
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--json") == 0) {
+      json = true;
+    } else if (strcmp(argv[i], "--list") == 0) {
+      list = true;
+    } else if (strcmp(argv[i], "--accuracy") == 0) {
+      accuracy = true;
+    } else if (strcmp(argv[i], "--conformance") == 0) {
+      conformance = true;
+    } else if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+      filter = argv[++i];
+    } else if (strcmp(argv[i], "--time") == 0 && i + 1 < argc) {
+      time_ms = static_cast<uint32_t>(std::max(1, atoi(argv[++i])));
+    } else {
+      usage(argv[0]);
+      return 1;
+    }
+  }
+
+  bsp_time_init();
+  init_input();
+
+  std::vector<Kernel> kernels = create_kernels();
+
+  if (accuracy) {
+    print_accuracy();
+    return 0;
+  }
+
+  if (conformance) {
+    return run_conformance() == 0 ? 0 : 1;
+  }
+
+  if (list) {
+    for (const auto& kernel : kernels) {
+      printf("%s\n", kernel.name);
+    }
+    return 0;
+  }
+
+  std::vector<Result> results;
+  for (const auto& kernel : kernels) {
+    if (filter != NULL && strstr(kernel.name, filter) == NULL) {
+      continue;
+    }
+    results.push_back(measure(kernel, time_ms));
+  }
+
+  if (json) {
+    print_json(results, time_ms);
+  } else {
+    print_text(results);
+  }
+
+  return 0;
+}
@@ -0,0 +1,25 @@
+#include "bsp_time.h"
+
+#include <time.h>
+
+/* 基准测试使用的桩BSP，时间基于单调时钟 */
+static struct timespec start_time;
+
+void bsp_time_init() { clock_gettime(CLOCK_MONOTONIC, &start_time); }
+
+uint64_t bsp_time_get_ns() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)(ts.tv_sec - start_time.tv_sec) * 1000000000ULL +
+         (uint64_t)ts.tv_nsec - (uint64_t)start_time.tv_nsec;
+}
+
+uint32_t bsp_time_get_ms() { return (uint32_t)(bsp_time_get_ns() / 1000000); }
+
+uint32_t bsp_time_get_us() { return (uint32_t)(bsp_time_get_ns() / 1000); }
+
+float bsp_time_get() { return (float)((double)bsp_time_get_ns() / 1e9); }
+
+uint32_t bsp_time_get_cycle() { return (uint32_t)bsp_time_get_ns(); }
+
+uint32_t bsp_time_get_cycle_freq() { return 1000000000; }